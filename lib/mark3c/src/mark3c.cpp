@@ -23,6 +23,10 @@ See license.txt for more information
 
 using namespace Mark3;
 
+// The opaque object-blobs in mark3c.h are sized from fake_types.h, which must
+// track the layout of the kernel objects they hold.
+static_assert(sizeof(Timer) == TIMER_SIZE, "Fake_Timer doesn't match the layout of Timer");
+
 //---------------------------------------------------------------------------
 // Kernel Memory managment APIs
 //---------------------------------------------------------------------------
@@ -320,13 +324,13 @@ Thread_t Scheduler_GetCurrentThread(void)
 
 void Thread_Init(Thread_t        handle,
                  K_WORD*         pwStack_,
-                 uint16_t        u16StackSize_,
+                 K_ADDR          uStackSize_,
                  PORT_PRIO_TYPE  uXPriority_,
                  ThreadEntryFunc pfEntryPoint_,
                  void*           pvArg_)
 {
     auto* pclThread = new ((void*)handle) Thread();
-    pclThread->Init(pwStack_, u16StackSize_, uXPriority_, pfEntryPoint_, pvArg_);
+    pclThread->Init(pwStack_, uStackSize_, uXPriority_, pfEntryPoint_, pvArg_);
 }
 
 //---------------------------------------------------------------------------
@@ -440,7 +444,7 @@ uint8_t Thread_GetID(Thread_t handle)
     return pclThread->GetID();
 }
 //---------------------------------------------------------------------------
-uint16_t Thread_GetStackSlack(Thread_t handle)
+K_ADDR Thread_GetStackSlack(Thread_t handle)
 {
     auto* pclThread = static_cast<Thread*>(handle);
     return pclThread->GetStackSlack();
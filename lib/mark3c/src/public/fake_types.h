@@ -61,7 +61,12 @@ typedef struct {
     uint8_t             m_u8Flags;
     void*               m_pfCallback;
     uint32_t            m_u32Interval;
+#if KERNEL_TIMER_WHEEL
+    uint32_t            m_u32Expiry;
+    uint8_t             m_u8Slot;
+#else
     uint32_t            m_u32TimeLeft;
+#endif // #if KERNEL_TIMER_WHEEL
     void*               m_pclOwner;
     void*               m_pvData;
 } Fake_Timer;
@@ -81,7 +86,7 @@ typedef struct {
 #if KERNEL_NAMED_THREADS
     const char* m_szName;
 #endif // #if KERNEL_NAMED_THREADS
-    uint16_t m_u16StackSize;
+    K_ADDR   m_uStackSize;
     void*    m_pclCurrent;
     void*    m_pclOwner;
     void*    m_pfEntryPoint;
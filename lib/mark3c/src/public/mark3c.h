@@ -387,6 +387,8 @@ uint32_t Kernel_GetTicks(void);
 // Scheduler APIs
 /**
  * @brief Scheduler_Enable
+ * Disabling the scheduler has no effect if it's already disabled; enabling it
+ * re-enables it however many times it was disabled.
  * @sa void Scheduler::SetScheduler(bool bEnable_)
  * @param bEnable_ true to enable, false to disable the scheduler
  */
@@ -409,11 +411,11 @@ typedef void (*thread_entry_func_t)(void* pvArg_);
 // Thread APIs
 /**
  * @brief Thread_Init
- * @sa void Thread::Init(K_WORD *pwStack_, uint16_t u16StackSize_, PORT_PRIO_TYPE uXPriority_, ThreadEntry_t
+ * @sa void Thread::Init(K_WORD *pwStack_, K_ADDR uStackSize_, PORT_PRIO_TYPE uXPriority_, ThreadEntry_t
  * pfEntryPoint_, void *pvArg_)
  * @param handle        Handle of the thread to initialize
  * @param pwStack_      Pointer to the stack to use for the thread
- * @param u16StackSize_  Size of the stack (in bytes)
+ * @param uStackSize_   Size of the stack (in bytes)
  * @param uXPriority_   Priority of the thread (0 = idle, 7 = max)
  * @param pfEntryPoint_ This is the function that gets called when the
  *                      thread is started
@@ -422,7 +424,7 @@ typedef void (*thread_entry_func_t)(void* pvArg_);
  */
 void Thread_Init(Thread_t            handle,
                  K_WORD*             pwStack_,
-                 uint16_t            u16StackSize_,
+                 K_ADDR              uStackSize_,
                  PORT_PRIO_TYPE      uXPriority_,
                  thread_entry_func_t pfEntryPoint_,
                  void*               pvArg_);
@@ -556,11 +558,11 @@ uint8_t Thread_GetID(Thread_t handle);
 #if KERNEL_STACK_CHECK
 /**
  * @brief Thread_GetStackSlack
- * @sa uint16_t Thread::GetStackSlack()
+ * @sa K_ADDR Thread::GetStackSlack()
  * @param handle Handle of the thread
  * @return Return the amount of unused stack on the given thread
  */
-uint16_t Thread_GetStackSlack(Thread_t handle);
+K_ADDR Thread_GetStackSlack(Thread_t handle);
 #endif // #if KERNEL_STACK_CHECK
 
 /**
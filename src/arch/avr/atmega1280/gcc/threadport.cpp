@@ -56,11 +56,11 @@ void ThreadPort::InitStack(Thread* pclThread_)
     // Start by finding the bottom of the stack
     pu8Stack = (uint8_t*)pclThread_->m_pwStackTop;
 
-#if KERNEL_STACK_CHECK
+#if KERNEL_STACK_PAINT
     // clear the stack, and initialize it to a known-default value (easier
     // to debug when things go sour with stack corruption or overflow)
-    for (i = 0; i < pclThread_->m_u16StackSize; i++) { pclThread_->m_pwStack[i] = 0xFF; }
-#endif // #if KERNEL_STACK_CHECK
+    for (i = 0; i < pclThread_->m_uStackSize; i++) { pclThread_->m_pwStack[i] = 0xFF; }
+#endif // #if KERNEL_STACK_PAINT
 
     // Our context starts with the entry function
     PORT_PUSH_TO_STACK(pu8Stack, (uint8_t)(u16Addr & 0x00FF));
@@ -16,6 +16,11 @@ See license.txt for more information
     @file   kerneltimer.cpp
 
     @brief  Kernel Timer Implementation for ATMega1284p
+
+    When KERNEL_HIRES_TIMERS is enabled, Timer1's output compare B channel is
+    used for high-resolution timers.  OCR1B can only match within the current
+    tick period, so a compare due in a later tick is programmed from the tick
+    interrupt for that tick.
 */
 
 #include "mark3.h"
@@ -27,6 +32,9 @@ See license.txt for more information
 #define TCCR1B_INIT ((1 << WGM12) | (1 << CS12))
 #define TIMER_IMSK (1 << OCIE1A)
 #define TIMER_IFR (1 << OCF1A)
+#define TIMER_CMP_IMSK (1 << OCIE1B)
+#define TIMER_CMP_IFR (1 << OCF1B)
+#define TIMER_TICK_COUNT ((PORT_SYSTEM_FREQ / 1000) / 64) //!< Timer1 compare value for one tick
 
 namespace
 {
@@ -36,7 +44,49 @@ using namespace Mark3;
 Thread    s_clTimerThread;
 K_WORD    s_clTimerThreadStack[PORT_KERNEL_TIMERS_THREAD_STACK];
 Semaphore s_clTimerSemaphore;
+
+#if KERNEL_HIRES_TIMERS
+uint64_t s_u64Compare; //!< Kernel clock value the compare is set for
+bool     s_bCompare;   //!< Whether a compare is set
+
+//---------------------------------------------------------------------------
+// Program OCR1B for the compare, if it falls within the current tick period;
+// otherwise it's left for the tick interrupt.  Returns false if the compare
+// is already due.
+bool KernelTimer_ArmCompare()
+{
+    TIMSK1 &= ~TIMER_CMP_IMSK;
+
+    auto u64Now = Kernel::GetClock();
+    if (s_u64Compare <= u64Now) {
+        return false;
+    }
+
+    // A pending tick interrupt means the period has already ended
+    auto u32Offset = KernelTimer::GetTickOffset();
+    if (u32Offset >= PORT_TIMER_FREQ) {
+        return true;
+    }
+    auto u64Match = (s_u64Compare - u64Now) + u32Offset;
+    if (u64Match > PORT_TIMER_FREQ) {
+        return true;
+    }
+
+    // Round up to the next count, so the compare never fires early.  Writing
+    // a 1 to the flag clears any stale match.
+    OCR1B  = static_cast<uint16_t>((u64Match + 63) / 64);
+    TIFR1  = TIMER_CMP_IFR;
+    TIMSK1 |= TIMER_CMP_IMSK;
+
+    // The count may have passed the match while it was being programmed
+    if ((Kernel::GetClock() >= s_u64Compare) && (0 == (TIFR1 & TIMER_CMP_IFR))) {
+        TIMSK1 &= ~TIMER_CMP_IMSK;
+        return false;
+    }
+    return true;
 }
+#endif // #if KERNEL_HIRES_TIMERS
+} // anonymous namespace
 
 namespace Mark3
 {
@@ -76,7 +126,7 @@ void KernelTimer::Config(void)
 void KernelTimer::Start(void)
 {
     TCCR1B = ((1 << WGM12) | (1 << CS11) | (1 << CS10));
-    OCR1A  = ((PORT_SYSTEM_FREQ / 1000) / 64);
+    OCR1A  = TIMER_TICK_COUNT;
     TCNT1  = 0;
     TIFR1 &= ~TIMER_IFR;
     TIMSK1 |= TIMER_IMSK;
@@ -91,6 +141,46 @@ void KernelTimer::Stop(void)
     TCNT1 = 0;
     OCR1A = 0;
 }
+
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::GetCycleCount(void)
+{
+    // Use the kernel clock, which extends Timer1 with the tick count.
+    return static_cast<uint32_t>(Kernel::GetClock());
+}
+
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::GetTickOffset(void)
+{
+    // Timer1 counts up to OCR1A once per tick, at PORT_SYSTEM_FREQ / 64.  A
+    // compare match whose interrupt hasn't been serviced yet has already
+    // started the next tick.  The count never exceeds OCR1A, which fits in a
+    // byte, so only TCNT1L is read: a full 16-bit read goes through the TEMP
+    // register shared with interrupts, and would need them masked.
+    static_assert(TIMER_TICK_COUNT < 256, "Timer1 tick count must fit in TCNT1L");
+    auto u32Offset = static_cast<uint32_t>(TCNT1L) * 64;
+    if (0 != (TIFR1 & TIMER_IFR)) {
+        u32Offset = PORT_TIMER_FREQ + (static_cast<uint32_t>(TCNT1L) * 64);
+    }
+    return u32Offset;
+}
+
+#if KERNEL_HIRES_TIMERS
+//---------------------------------------------------------------------------
+bool KernelTimer::SetCompare(uint64_t u64Clock_)
+{
+    s_u64Compare = u64Clock_;
+    s_bCompare   = KernelTimer_ArmCompare();
+    return s_bCompare;
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer::ClearCompare(void)
+{
+    s_bCompare = false;
+    TIMSK1 &= ~TIMER_CMP_IMSK;
+}
+#endif // #if KERNEL_HIRES_TIMERS
 } // namespace Mark3
 
 //---------------------------------------------------------------------------
@@ -102,6 +192,34 @@ void KernelTimer::Stop(void)
 using namespace Mark3;
 ISR(TIMER1_COMPA_vect)
 {
+#if KERNEL_TRACE
+    KernelTrace::IsrEnter(uTraceVectorTick);
+#endif // #if KERNEL_TRACE
     Kernel::Tick();
     s_clTimerSemaphore.Post();
+#if KERNEL_HIRES_TIMERS
+    // Program a compare due in the new tick period
+    if (s_bCompare && !KernelTimer_ArmCompare()) {
+        s_bCompare = false;
+        HiResTimer::Process();
+    }
+#endif // #if KERNEL_HIRES_TIMERS
+#if KERNEL_TRACE
+    KernelTrace::IsrExit(uTraceVectorTick);
+#endif // #if KERNEL_TRACE
+}
+
+#if KERNEL_HIRES_TIMERS
+//---------------------------------------------------------------------------
+/**
+ *   @brief ISR(TIMER1_COMPB_vect)
+ *   High-resolution timer compare ISR - expire the timers that are due
+ */
+//---------------------------------------------------------------------------
+ISR(TIMER1_COMPB_vect)
+{
+    TIMSK1 &= ~TIMER_CMP_IMSK;
+    s_bCompare = false;
+    HiResTimer::Process();
 }
+#endif // #if KERNEL_HIRES_TIMERS
@@ -80,7 +80,7 @@ ASM("in    r0, 0x3B"); \
 ASM("push r0"); \
 ASM("lds r26, g_pclCurrent"); \
 ASM("lds r27, g_pclCurrent + 1"); \
-ASM("adiw r26, 4"); \
+ASM("adiw r26, " KERNEL_STRINGIFY(PORT_THREAD_STACK_TOP_OFFSET)); \
 ASM("in    r0, 0x3D"); \
 ASM("st    x+, r0"); \
 ASM("in    r0, 0x3E"); \
@@ -91,7 +91,7 @@ ASM("st    x+, r0");
 #define Thread_RestoreContext() \
 ASM("lds r26, g_pclCurrent"); \
 ASM("lds r27, g_pclCurrent + 1");\
-ASM("adiw r26, 4"); \
+ASM("adiw r26, " KERNEL_STRINGIFY(PORT_THREAD_STACK_TOP_OFFSET)); \
 ASM("ld     r28, x+"); \
 ASM("out 0x3D, r28"); \
 ASM("ld     r29, x+"); \
@@ -105,6 +105,13 @@ See license.txt for more information
 */
 #define PORT_TIMER_COUNT_TYPE uint16_t //!< Timer counter type
 
+/**
+    Timer1's output compare B channel provides the compare interrupt for
+    high-resolution timers (see hirestimer.h), with the resolution of the
+    Timer1 prescaler (64 CPU cycles).
+*/
+#define PORT_SUPPORTS_HIRES_TIMER (1)
+
 /**
     Minimum number of timer ticks for any delay or sleep, required to ensure that a timer cannot
     be initialized to a negative value.
@@ -122,6 +129,13 @@ See license.txt for more information
 */
 #define PORT_STACK_GROWS_DOWN (1)
 
+/**
+    Offset (in bytes) of the stack-top pointer within the Thread object, used by the
+    context-switch code.  This is the size of the linked-list node the Thread inherits
+    (two pointers), and is checked against the Thread layout at compile time.
+*/
+#define PORT_THREAD_STACK_TOP_OFFSET (4)
+
 /**
     Set this to 1 if the target CPU/toolchain supports an optimized Count-leading-zeros instruction,
     or count-leading-zeros intrinsic.  If such functionality is not available, a general-purpose
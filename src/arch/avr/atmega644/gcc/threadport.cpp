@@ -56,7 +56,7 @@ void ThreadPort::InitStack(Thread* pclThread_)
 
     // clear the stack, and initialize it to a known-default value (easier
     // to debug when things go sour with stack corruption or overflow)
-    for (i = 0; i < pclThread_->m_u16StackSize; i++) { pclThread_->m_pwStack[i] = 0xFF; }
+    for (i = 0; i < pclThread_->m_uStackSize; i++) { pclThread_->m_pwStack[i] = 0xFF; }
 
     // Our context starts with the entry function
     PORT_PUSH_TO_STACK(pu8Stack, (uint8_t)(u16Addr & 0x00FF));
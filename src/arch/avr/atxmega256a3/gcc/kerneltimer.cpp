@@ -96,6 +96,29 @@ void KernelTimer::Stop(void)
     TCC1.CTRLA = 0;           // Clock source disable.
 }
 
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::GetCycleCount(void)
+{
+    // Use the kernel clock, which extends TCC1 with the tick count.
+    return static_cast<uint32_t>(Kernel::GetClock());
+}
+
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::GetTickOffset(void)
+{
+    // TCC1 counts up to PER once per tick, at PORT_SYSTEM_FREQ / 64.  An
+    // overflow whose interrupt hasn't been serviced yet has already started
+    // the next tick.  The 16-bit count is read through the timer's TEMP
+    // register, which an interrupt could otherwise overwrite mid-read.
+    const auto cs = CriticalGuard{};
+
+    auto u32Offset = static_cast<uint32_t>(TCC1.CNT) * 64;
+    if (0 != (TCC1.INTFLAGS & 0x01)) {
+        u32Offset = PORT_TIMER_FREQ + (static_cast<uint32_t>(TCC1.CNT) * 64);
+    }
+    return u32Offset;
+}
+
 //---------------------------------------------------------------------------
 /**
  *   @brief ISR(TIMER1_COMPA_vect)
@@ -106,6 +129,12 @@ void KernelTimer::Stop(void)
 using namespace Mark3;
 ISR(TIMER1_COMPA_vect)
 {
+#if KERNEL_TRACE
+    KernelTrace::IsrEnter(uTraceVectorTick);
+#endif // #if KERNEL_TRACE
     Kernel::Tick();
     s_clTimerSemaphore.Post();
+#if KERNEL_TRACE
+    KernelTrace::IsrExit(uTraceVectorTick);
+#endif // #if KERNEL_TRACE
 }
@@ -109,7 +109,7 @@ void SVC_Handler(void)
     ASM(
         // Get the pointer to the first thread's stack
         " mov r3, %[CURRENT_THREAD]\n "
-        " add r3, #8 \n "
+        " add r3, #" KERNEL_STRINGIFY(PORT_THREAD_STACK_TOP_OFFSET) " \n "
         " ldr r2, [r3] \n "
         // Stack pointer is in r2, start loading registers from the "manually-stacked" set
         // Start with r11-r8, since these can't be accessed directly.
@@ -215,7 +215,7 @@ void PendSV_Handler(void)
         " ldr r1, CURR_ \n"
         " ldr r1, [r1] \n "
         " mov r3, r1 \n "
-        " add r3, #8 \n "
+        " add r3, #" KERNEL_STRINGIFY(PORT_THREAD_STACK_TOP_OFFSET) " \n "
 
         //  Grab the psp and adjust it by 32 based on the extra registers we're going
         // to be manually stacking.
@@ -244,7 +244,7 @@ void PendSV_Handler(void)
         " cpsie i \n "
 
         // Get the pointer to the next thread's stack
-        " add r0, #8 \n "
+        " add r0, #" KERNEL_STRINGIFY(PORT_THREAD_STACK_TOP_OFFSET) " \n "
         " ldr r2, [r0] \n "
 
         // Stack pointer is in r2, start loading registers from the "manually-stacked" set
@@ -327,7 +327,7 @@ void ThreadPort::InitStack(Thread* pclThread_)
     uint32_t* pu32Stack;
     uint32_t* pu32Temp;
     uint32_t  u32Addr;
-    uint16_t  i;
+    K_ADDR    i;
 
     // Get the entrypoint for the thread
     u32Addr = (uint32_t)(pclThread_->m_pfEntryPoint);
@@ -335,11 +335,11 @@ void ThreadPort::InitStack(Thread* pclThread_)
     // Get the top-of-stack pointer for the thread
     pu32Stack = (uint32_t*)pclThread_->m_pwStackTop;
 
-#if KERNEL_STACK_CHECK
+#if KERNEL_STACK_PAINT
     // Initialize the stack to all FF's to aid in stack depth checking
     pu32Temp = (uint32_t*)pclThread_->m_pwStack;
-    for (i = 0; i < pclThread_->m_u16StackSize / sizeof(uint32_t); i++) { pu32Temp[i] = 0xFFFFFFFF; }
-#endif // #if KERNEL_STACK_CHECK
+    for (i = 0; i < pclThread_->m_uStackSize / sizeof(uint32_t); i++) { pu32Temp[i] = 0xFFFFFFFF; }
+#endif // #if KERNEL_STACK_PAINT
 
     PORT_PUSH_TO_STACK(pu32Stack, 0); // We need one word of padding, apparently...
 
@@ -123,6 +123,13 @@ See license.txt for more information
 */
 #define PORT_STACK_GROWS_DOWN (1)
 
+/**
+    Offset (in bytes) of the stack-top pointer within the Thread object, used by the
+    context-switch code.  This is the size of the linked-list node the Thread inherits
+    (two pointers), and is checked against the Thread layout at compile time.
+*/
+#define PORT_THREAD_STACK_TOP_OFFSET (8)
+
 /**
     Set this to 1 if the target CPU/toolchain supports an optimized Count-leading-zeros instruction,
     or count-leading-zeros intrinsic.  If such functionality is not available, a general-purpose
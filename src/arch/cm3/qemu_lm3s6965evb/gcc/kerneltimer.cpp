@@ -25,7 +25,9 @@ See license.txt for more information
 #include "kernel.h"
 #include "ksemaphore.h"
 #include "thread.h"
+#include "kerneltrace.h"
 #include "quantum.h"
+#include "criticalguard.h"
 
 using namespace Mark3;
 namespace
@@ -46,8 +48,14 @@ void SysTick_Handler(void)
         return;
     }
 
+#if KERNEL_TRACE
+    KernelTrace::IsrEnter(uTraceVectorTick);
+#endif // #if KERNEL_TRACE
     Kernel::Tick();
     s_clTimerSemaphore.Post();
+#if KERNEL_TRACE
+    KernelTrace::IsrExit(uTraceVectorTick);
+#endif // #if KERNEL_TRACE
 
     // Clear the systick interrupt pending bit.
     SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
@@ -104,5 +112,25 @@ void KernelTimer::Stop(void)
 {
     SysTick->CTRL = ~SysTick_CTRL_ENABLE_Msk;
 }
+
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::GetCycleCount(void)
+{
+    // QEMU does not model the DWT cycle counter - use the kernel clock, which extends
+    // SysTick with the tick count.
+    return static_cast<uint32_t>(Kernel::GetClock());
+}
+
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::GetTickOffset(void)
+{
+    // SysTick counts down to zero once per tick.  A reload whose interrupt
+    // hasn't been serviced yet has already started the next tick.
+    auto u32Offset = PORT_TIMER_FREQ - 1 - SysTick->VAL;
+    if (0 != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)) {
+        u32Offset = (2 * PORT_TIMER_FREQ) - 1 - SysTick->VAL;
+    }
+    return u32Offset;
+}
 //---------------------------------------------------------------------------
 } // namespace Mark3
@@ -26,6 +26,8 @@ See license.txt for more information
 
 #include "ksemaphore.h"
 #include "thread.h"
+#include "kerneltrace.h"
+#include "criticalguard.h"
 
 using namespace Mark3;
 namespace
@@ -35,7 +37,15 @@ namespace
 Thread    s_clTimerThread;
 K_WORD    s_clTimerThreadStack[PORT_KERNEL_TIMERS_THREAD_STACK];
 Semaphore s_clTimerSemaphore;
+#if KERNEL_TICKLESS
+uint32_t s_u32PendingTicks; //!< Ticks elapsed since the timer thread last ran
+uint32_t s_u32Suppressed;   //!< Length of the one-shot programmed by Suppress(), in ticks
+#endif // #if KERNEL_TICKLESS
 
+//---------------------------------------------------------------------------
+// Debug Exception and Monitor Control register, which gates the DWT unit
+#define M3_DEMCR (*reinterpret_cast<volatile uint32_t*>(0xE000EDFCUL))
+#define M3_DEMCR_TRCENA (1UL << 24)
 } // anonymous namespace
 
 //---------------------------------------------------------------------------
@@ -45,8 +55,17 @@ void SysTick_Handler(void)
     if (!Kernel::IsStarted()) {
         return;
     }
+#if KERNEL_TRACE
+    KernelTrace::IsrEnter(uTraceVectorTick);
+#endif // #if KERNEL_TRACE
     Kernel::Tick();
+#if KERNEL_TICKLESS
+    s_u32PendingTicks++;
+#endif // #if KERNEL_TICKLESS
     s_clTimerSemaphore.Post();
+#if KERNEL_TRACE
+    KernelTrace::IsrExit(uTraceVectorTick);
+#endif // #if KERNEL_TRACE
 
     // Clear the systick interrupt pending bit.
     SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
@@ -64,7 +83,17 @@ static void KernelTimer_Task(void* unused)
 #if KERNEL_ROUND_ROBIN
         Quantum::SetInTimer();
 #endif // #if KERNEL_ROUND_ROBIN
+#if KERNEL_TICKLESS
+        auto u32Ticks = uint32_t {};
+        {
+            const auto cs     = CriticalGuard {};
+            u32Ticks          = s_u32PendingTicks;
+            s_u32PendingTicks = 0;
+        }
+        TimerScheduler::Process(u32Ticks);
+#else
         TimerScheduler::Process();
+#endif // #if KERNEL_TICKLESS
 #if KERNEL_ROUND_ROBIN
         Quantum::ClearInTimer();
 #endif // #if KERNEL_ROUND_ROBIN
@@ -74,6 +103,11 @@ static void KernelTimer_Task(void* unused)
 //---------------------------------------------------------------------------
 void KernelTimer::Config(void)
 {
+    // Free-running DWT cycle counter, used for profiling
+    M3_DEMCR |= M3_DEMCR_TRCENA;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
     s_clTimerSemaphore.Init(0, 1);
     s_clTimerThread.Init(s_clTimerThreadStack,
                          sizeof(s_clTimerThreadStack) / sizeof(K_WORD),
@@ -101,5 +135,89 @@ void KernelTimer::Stop(void)
     SysTick->CTRL = ~SysTick_CTRL_ENABLE_Msk;
 }
 
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::GetCycleCount(void)
+{
+    return DWT->CYCCNT;
+}
+
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::GetTickOffset(void)
+{
+    // SysTick counts down to zero once per tick.  A reload whose interrupt
+    // hasn't been serviced yet has already started the next tick.
+    auto u32Offset = PORT_TIMER_FREQ - 1 - SysTick->VAL;
+    if (0 != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)) {
+        u32Offset = (2 * PORT_TIMER_FREQ) - 1 - SysTick->VAL;
+    }
+    return u32Offset;
+}
+
+#if KERNEL_TICKLESS
+//---------------------------------------------------------------------------
+void KernelTimer::Suppress(uint32_t u32Ticks_)
+{
+    // Run on from the next boundary of the periodic tick, which is VAL cycles
+    // away.  Reading CTRL clears COUNTFLAG.
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    auto u32Cycles = SysTick->VAL + ((u32Ticks_ - 1) * PORT_TIMER_FREQ);
+
+    SysTick->LOAD = u32Cycles - 1;
+    SysTick->VAL  = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    s_u32Suppressed = u32Ticks_;
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer::Wait(void)
+{
+    // An interrupt masked by PRIMASK still wakes the core from WFI; it's
+    // taken once the caller's critical section ends.
+    ASM(" dsb \n"
+        " wfi \n"
+        " isb \n");
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer::Resume(void)
+{
+    auto u32Ctrl  = SysTick->CTRL;
+    SysTick->CTRL = u32Ctrl & ~SysTick_CTRL_ENABLE_Msk;
+    auto u32Val   = SysTick->VAL;
+
+    // If the one-shot expired, its pending interrupt accounts for the final
+    // tick, and the counter has since reloaded.  Otherwise, the one-shot was
+    // still VAL cycles away - count the boundaries passed.
+    auto u32Left    = uint32_t { 1 };
+    auto u32ToFirst = uint32_t { PORT_TIMER_FREQ };
+    if (0 != (u32Ctrl & SysTick_CTRL_COUNTFLAG_Msk)) {
+        auto u32Over = SysTick->LOAD - u32Val;
+        if (u32Over < PORT_TIMER_FREQ) {
+            u32ToFirst = PORT_TIMER_FREQ - u32Over;
+        }
+    } else if (0 != u32Val) {
+        u32Left    = (u32Val + PORT_TIMER_FREQ - 1) / PORT_TIMER_FREQ;
+        u32ToFirst = u32Val - ((u32Left - 1) * PORT_TIMER_FREQ);
+    } else {
+        u32Left = 0;
+    }
+
+    // Restart the periodic tick, due at the next boundary.  The counter
+    // loads the first (partial) period when enabled, and the full period
+    // from then on.
+    SysTick->LOAD = u32ToFirst - 1;
+    SysTick->VAL  = 0;
+    SysTick->CTRL = u32Ctrl | SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = PORT_TIMER_FREQ - 1;
+
+    auto u32Elapsed = s_u32Suppressed - u32Left;
+    if (0 != u32Elapsed) {
+        Kernel::Tick(u32Elapsed);
+        s_u32PendingTicks += u32Elapsed;
+        s_clTimerSemaphore.Post();
+    }
+}
+#endif // #if KERNEL_TICKLESS
+
 //---------------------------------------------------------------------------
 } // namespace Mark3
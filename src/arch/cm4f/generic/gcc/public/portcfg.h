@@ -42,6 +42,23 @@ See license.txt for more information
 
 #define KERNEL_STACK_GUARD_DEFAULT (32) // words
 
+/**
+    The MPU can guard the limit of the running thread's stack when
+    KERNEL_STACK_GUARD is set to KERNEL_STACK_GUARD_MPU, in which case the
+    MPU region below is reserved for the kernel.  The device must have an
+    MPU (__MPU_PRESENT), and thread stacks must be at least 64 bytes.
+*/
+#define PORT_SUPPORTS_STACK_GUARD_MPU (1)
+#define PORT_STACK_GUARD_MPU_REGION (7)
+
+/**
+    The SysTick timer can be reprogrammed as a one-shot to suppress the kernel
+    tick while idle when KERNEL_TICKLESS is enabled.  Its 24-bit counter limits
+    a single idle period to PORT_TICKLESS_MAX_TICKS ticks.
+*/
+#define PORT_SUPPORTS_TICKLESS (1)
+#define PORT_TICKLESS_MAX_TICKS ((uint32_t)(0x00FFFFFF / PORT_TIMER_FREQ))
+
 /**
     Set the number of priorities supported by the coroutine scheduler.  The
     number of coroutine priorities is limited by the memory of the host CPU.
@@ -116,6 +133,13 @@ See license.txt for more information
 */
 #define PORT_STACK_GROWS_DOWN (1)
 
+/**
+    Offset (in bytes) of the stack-top pointer within the Thread object, used by the
+    context-switch code.  This is the size of the linked-list node the Thread inherits
+    (two pointers), and is checked against the Thread layout at compile time.
+*/
+#define PORT_THREAD_STACK_TOP_OFFSET (8)
+
 /**
     Set this to 1 if the target CPU/toolchain supports an optimized Count-leading-zeros instruction,
     or count-leading-zeros intrinsic.  If such functionality is not available, a general-purpose
@@ -98,7 +98,7 @@ void SVC_Handler(void)
     ASM(
         // Get the pointer to the first thread's stack
         " mov r3, %[CURRENT_THREAD]\n "
-        " add r3, #8 \n "
+        " add r3, #" KERNEL_STRINGIFY(PORT_THREAD_STACK_TOP_OFFSET) " \n "
         " ldr r2, [r3] \n "
         // Stack pointer is in r2, start loading registers from the "manually-stacked" set
         " ldmia r2!, {r4-r11, r14} \n "
@@ -155,7 +155,7 @@ void PendSV_Handler(void)
         " ldr r1, CURR_ \n"
         " ldr r1, [r1] \n "
         " mov r3, r1 \n "
-        " add r3, #8 \n "
+        " add r3, #" KERNEL_STRINGIFY(PORT_THREAD_STACK_TOP_OFFSET) " \n "
 
         " mrs r2, psp \n "
 
@@ -181,7 +181,7 @@ void PendSV_Handler(void)
         " cpsie i \n "
 
         // Get the pointer to the next thread's stack
-        " add r0, #8 \n "
+        " add r0, #" KERNEL_STRINGIFY(PORT_THREAD_STACK_TOP_OFFSET) " \n "
         " ldr r2, [r0] \n "
 
         // Stack pointer is in r2, start loading registers from the "manually-stacked" set
@@ -259,7 +259,7 @@ void ThreadPort::InitStack(Thread* pclThread_)
     uint32_t* pu32Stack;
     uint32_t* pu32Temp;
     uint32_t  u32Addr;
-    uint16_t  i;
+    K_ADDR    i;
 
     // Get the entrypoint for the thread
     u32Addr = (uint32_t)(pclThread_->m_pfEntryPoint);
@@ -267,11 +267,11 @@ void ThreadPort::InitStack(Thread* pclThread_)
     // Get the top-of-stack pointer for the thread
     pu32Stack = (uint32_t*)pclThread_->m_pwStackTop;
 
-#if KERNEL_STACK_CHECK
+#if KERNEL_STACK_PAINT
     // Initialize the stack to all FF's to aid in stack depth checking
     pu32Temp = (uint32_t*)pclThread_->m_pwStack;
-    for (i = 0; i < pclThread_->m_u16StackSize / sizeof(uint32_t); i++) { pu32Temp[i] = 0xFFFFFFFF; }
-#endif // #if KERNEL_STACK_CHECK
+    for (i = 0; i < pclThread_->m_uStackSize / sizeof(uint32_t); i++) { pu32Temp[i] = 0xFFFFFFFF; }
+#endif // #if KERNEL_STACK_PAINT
 
     PORT_PUSH_TO_STACK(pu32Stack, 0); // We need one word of padding, apparently...
 
@@ -300,6 +300,30 @@ void ThreadPort::InitStack(Thread* pclThread_)
     pclThread_->m_pwStackTop = pu32Stack;
 }
 
+//---------------------------------------------------------------------------
+#if KERNEL_STACK_CHECK && (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_MPU)
+#if (__MPU_PRESENT != 1)
+#error "KERNEL_STACK_GUARD_MPU requires a device with an MPU"
+#endif
+void ThreadPort::SetStackGuard(Thread* pclThread_)
+{
+    // Place a 32-byte no-access region at the first 32-byte boundary at or
+    // above the stack's limit, so any write past the end of the stack faults
+    auto uBase = (reinterpret_cast<uintptr_t>(pclThread_->m_pwStack) + 31u) & ~uintptr_t { 31u };
+
+    MPU->RNR  = PORT_STACK_GUARD_MPU_REGION;
+    MPU->RBAR = static_cast<uint32_t>(uBase);
+    MPU->RASR = MPU_RASR_XN_Msk | (4u << MPU_RASR_SIZE_Pos) | MPU_RASR_ENABLE_Msk;
+
+    if (0 == (MPU->CTRL & MPU_CTRL_ENABLE_Msk)) {
+        // Default memory map for everything else, with memory faults enabled
+        SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk;
+        MPU->CTRL = MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk;
+    }
+    ASM(" dsb \n isb \n");
+}
+#endif // #if KERNEL_STACK_CHECK && (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_MPU)
+
 //---------------------------------------------------------------------------
 void Thread_Switch(void)
 {
@@ -320,6 +344,9 @@ void ThreadPort::StartThreads()
     Scheduler::Schedule();      // run the scheduler - determine the first thread to run
 
     Thread_Switch(); // Set the next scheduled thread to the current thread
+#if KERNEL_STACK_CHECK && (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_MPU)
+    SetStackGuard(g_pclCurrent);
+#endif // #if KERNEL_STACK_CHECK && (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_MPU)
 
     KernelTimer::Start(); // enable the kernel timer
     KernelSWI::Start();   // enable the task switch SWI
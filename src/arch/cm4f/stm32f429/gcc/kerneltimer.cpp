@@ -24,6 +24,7 @@ See license.txt for more information
 #include "kernel.h"
 #include "ksemaphore.h"
 #include "thread.h"
+#include "kerneltrace.h"
 #include "quantum.h"
 
 #include "stm32f4xx.h"
@@ -54,8 +55,14 @@ void SysTick_Handler(void)
         return;
     }
 
+#if KERNEL_TRACE
+    KernelTrace::IsrEnter(uTraceVectorTick);
+#endif // #if KERNEL_TRACE
     Kernel::Tick();
     s_clTimerSemaphore.Post();
+#if KERNEL_TRACE
+    KernelTrace::IsrExit(uTraceVectorTick);
+#endif // #if KERNEL_TRACE
 
     // Clear the systick interrupt pending bit.
     SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
@@ -83,6 +90,11 @@ static void KernelTimer_Task(void* unused)
 //---------------------------------------------------------------------------
 void KernelTimer::Config(void)
 {
+    // Free-running DWT cycle counter, used for profiling
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
     s_clTimerSemaphore.Init(0, 1);
     s_clTimerThread.Init(s_clTimerThreadStack,
                          sizeof(s_clTimerThreadStack) / sizeof(K_WORD),
@@ -112,5 +124,23 @@ void KernelTimer::Stop(void)
     SysTick->CTRL = ~SysTick_CTRL_ENABLE_Msk;
 }
 
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::GetCycleCount(void)
+{
+    return DWT->CYCCNT;
+}
+
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::GetTickOffset(void)
+{
+    // SysTick counts down to zero once per tick.  A reload whose interrupt
+    // hasn't been serviced yet has already started the next tick.
+    auto u32Offset = PORT_TIMER_FREQ - 1 - SysTick->VAL;
+    if (0 != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)) {
+        u32Offset = (2 * PORT_TIMER_FREQ) - 1 - SysTick->VAL;
+    }
+    return u32Offset;
+}
+
 //---------------------------------------------------------------------------
 } // namespace Mark3
@@ -15,27 +15,79 @@ See license.txt for more information
 
     @file   kernelswi.cpp
 
-    @brief  Kernel Software interrupt implementation for ATMega328p
+    @brief  Kernel Software interrupt implementation for the x86-64 Linux host
 
+    There is no software interrupt on the host - instead, a pending switch
+    flag is set, which is serviced as soon as the kernel's signals become
+    unmasked again (i.e. on exit from the outermost critical section, or on
+    exit from a kernel-aware signal handler).
+
+    When KERNEL_SMP is enabled, SIGUSR1 is used as the inter-processor
+    interrupt: its handler just reschedules the core that received it.
 */
 
 #include "kerneltypes.h"
 #include "kernelswi.h"
+#include "threadport.h"
+#include "thread.h"
 
 namespace Mark3
 {
+#if KERNEL_SMP
+namespace
+{
+    //---------------------------------------------------------------------------
+    void KernelSWI_IpiHandler(int /*iSignal_*/)
+    {
+        ThreadPort_IsrEnter();
+        Thread::Yield();
+        ThreadPort_IsrExit();
+    }
+} // anonymous namespace
+#endif // #if KERNEL_SMP
+
 //---------------------------------------------------------------------------
 void KernelSWI::Config(void)
 {
+    // The set of signals treated as kernel-aware interrupts; masked whenever
+    // the kernel enters a critical section.
+    sigemptyset(&g_stIrqMask);
+    sigaddset(&g_stIrqMask, SIGALRM);
+#if KERNEL_HIRES_TIMERS
+    sigaddset(&g_stIrqMask, SIGRTMIN);
+#endif // #if KERNEL_HIRES_TIMERS
+#if KERNEL_SMP
+    sigaddset(&g_stIrqMask, SIGUSR1);
+
+    auto stAction       = (struct sigaction) {};
+    stAction.sa_handler = KernelSWI_IpiHandler;
+    stAction.sa_flags   = SA_RESTART;
+    stAction.sa_mask    = g_stIrqMask;
+    sigaction(SIGUSR1, &stAction, nullptr);
+
+    for (auto& bPending : g_abSwitchPending) {
+        bPending = false;
+    }
+#else
+    g_bSwitchPending = false;
+#endif // #if KERNEL_SMP
 }
 
 //---------------------------------------------------------------------------
 void KernelSWI::Start(void)
 {
+    // Nothing to do...
 }
 
 //---------------------------------------------------------------------------
 void KernelSWI::Trigger(void)
 {
+    g_bSwitchPending = true;
+
+    // If "interrupts" aren't disabled, the switch is taken immediately.
+    if (!g_kwCriticalCount && !g_bInIsr) {
+        PORT_CS_ENTER();
+        PORT_CS_EXIT();
+    }
 }
 } // namespace Mark3
@@ -15,26 +15,416 @@ See license.txt for more information
 
     @file   kerneltimer.cpp
 
-    @brief  Kernel Timer Implementation for ATMega328p
+    @brief  Kernel Timer Implementation for the x86-64 Linux host
+
+    The kernel tick is generated by a 1kHz SIGALRM from a POSIX timer, which
+    acts as the host's equivalent of a SysTick interrupt.  The timer signals
+    the host thread that started the kernel specifically, so that each kernel
+    instance receives its own tick when KERNEL_MULTI_INSTANCE is enabled.
+
+    When PORT_HOST_VIRTUAL_TIME is set, the same periodic signal drives a
+    virtual clock instead.  Whenever it finds the idle thread running, the
+    handler advances the kernel clock directly to the next timer expiry, and
+    re-arms the signal early to skip the next idle period too.  Otherwise,
+    a tick is only counted if no thread has blocked since the last one, i.e.
+    the running threads are busy-waiting or CPU-bound.
+
+    When KERNEL_TICKLESS is set, the interval timer is instead reprogrammed as
+    a one-shot while the idle thread sleeps (see tickless.h).
+
+    When KERNEL_HIRES_TIMERS is set, a second POSIX timer, signalling SIGRTMIN,
+    acts as the compare channel for high-resolution timers (see hirestimer.h).
+    Compare values on the kernel clock are converted to absolute host times
+    relative to the current clock reading.  A real-time signal is used as
+    Linux delivers pending standard signals first: the kernel clock stands
+    still while a tick is pending, so a compare taken ahead of the tick would
+    just be re-armed, over and over.
 */
 
-#include "mark3.h"
+#include "kerneltypes.h"
+#include "kerneltimer.h"
+#include "threadport.h"
+#include "kernel.h"
+#include "ksemaphore.h"
+#include "thread.h"
+#include "kerneltrace.h"
+#include "quantum.h"
+#include "timerscheduler.h"
+#include "criticalguard.h"
+#include "hirestimer.h"
+
+#include <time.h>
+#include <unistd.h>
+
+// Older glibc versions don't expose the SIGEV_THREAD_ID target by name
+#if !defined(sigev_notify_thread_id)
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+using namespace Mark3;
+namespace
+{
+//---------------------------------------------------------------------------
+// Static objects implementing the timer thread and its synchronization objects
+KERNEL_INSTANCE_STATE Thread    s_clTimerThread;
+KERNEL_INSTANCE_STATE K_WORD    s_clTimerThreadStack[PORT_KERNEL_TIMERS_THREAD_STACK / sizeof(K_WORD)];
+KERNEL_INSTANCE_STATE Semaphore s_clTimerSemaphore;
+#if PORT_HOST_VIRTUAL_TIME || KERNEL_TICKLESS
+KERNEL_INSTANCE_STATE uint32_t s_u32PendingTicks; //!< Ticks elapsed since the timer thread last ran
+#endif // #if PORT_HOST_VIRTUAL_TIME || KERNEL_TICKLESS
+KERNEL_INSTANCE_STATE timer_t s_stTimer; //!< POSIX timer generating the tick signal
+#if !PORT_HOST_VIRTUAL_TIME
+KERNEL_INSTANCE_STATE long long s_llTickNs; //!< Host time of the last tick counted, in ns
+
+constexpr auto llTickNs = static_cast<long long>(PORT_HOST_TICK_PERIOD_US) * 1000;
+#else
+KERNEL_INSTANCE_STATE bool s_bSkipping; //!< Tick is re-armed early, to skip more idle time
+
+// Delay to the next tick after skipping idle time, in us.  If the idle thread
+// is still running by then, the clock is skipped again, so a mostly-idle
+// workload runs at close to the speed of the host.
+constexpr auto lIdleSkipUs = long { 10 };
+#endif // #if !PORT_HOST_VIRTUAL_TIME
+#if KERNEL_TICKLESS
+KERNEL_INSTANCE_STATE uint32_t s_u32Suppressed; //!< Length of the one-shot programmed by Suppress(), in ticks
+#endif // #if KERNEL_TICKLESS
+#if KERNEL_HIRES_TIMERS
+KERNEL_INSTANCE_STATE timer_t s_stCompareTimer; //!< POSIX timer generating the compare signal
+
+// Furthest a compare is programmed ahead, in kernel clock cycles, to keep the
+// conversion to ns from overflowing.  Later compares just interrupt early.
+constexpr auto u64MaxCompare = uint64_t { PORT_TIMER_FREQ } * 1000;
+#endif // #if KERNEL_HIRES_TIMERS
+
+#if !PORT_HOST_VIRTUAL_TIME
+//---------------------------------------------------------------------------
+long long KernelTimer_ToNs(const timespec& stTime_)
+{
+    return (static_cast<long long>(stTime_.tv_sec) * 1000000000) + stTime_.tv_nsec;
+}
+
+//---------------------------------------------------------------------------
+long long KernelTimer_NowNs()
+{
+    auto stNow = timespec {};
+    clock_gettime(CLOCK_MONOTONIC, &stNow);
+    return KernelTimer_ToNs(stNow);
+}
+#endif // #if !PORT_HOST_VIRTUAL_TIME
+
+//---------------------------------------------------------------------------
+void KernelTimer_Arm(long lDelayUs_)
+{
+    // First tick after the given delay, then periodic
+    auto stTimer                = itimerspec {};
+    stTimer.it_interval.tv_nsec = PORT_HOST_TICK_PERIOD_US * 1000;
+    stTimer.it_value.tv_nsec    = lDelayUs_ * 1000;
+    timer_settime(s_stTimer, 0, &stTimer, nullptr);
+}
+
+#if PORT_HOST_VIRTUAL_TIME
+//---------------------------------------------------------------------------
+void KernelTimer_SkipIdle()
+{
+    // Only ever called with the timer thread caught up, so the timer list is
+    // current.  With no active timers there is no event to skip to, so time
+    // just passes in real time.
+    auto u32Ticks = TimerScheduler::GetNextExpiry();
+    if (uTimerTicksInvalid != u32Ticks) {
+        s_bSkipping = true;
+        KernelTimer_Arm(lIdleSkipUs);
+    } else {
+        u32Ticks = 1;
+        if (s_bSkipping) {
+            s_bSkipping = false;
+            KernelTimer_Arm(PORT_HOST_TICK_PERIOD_US);
+        }
+    }
+    s_u32PendingTicks += u32Ticks;
+    Kernel::Tick(u32Ticks);
+    s_clTimerSemaphore.Post();
+}
+#endif // #if PORT_HOST_VIRTUAL_TIME
+
+//---------------------------------------------------------------------------
+void KernelTimer_Handler(int /*iSignal_*/)
+{
+    ThreadPort_IsrEnter();
+#if KERNEL_TRACE
+    KernelTrace::IsrEnter(uTraceVectorTick);
+#endif // #if KERNEL_TRACE
+    if (Kernel::IsStarted()) {
+#if PORT_HOST_VIRTUAL_TIME
+        // If the tick caught the idle thread, nothing can happen until the
+        // next timer expires, so skip the clock straight there.  The timer
+        // thread outranks the idle thread, so it has normally processed
+        // every tick already; if not, just count this one.
+        if ((0 == Scheduler::GetCurrentThread()->GetCurPriority()) && (0 == s_u32PendingTicks)) {
+            KernelTimer_SkipIdle();
+        } else if (s_bSkipping) {
+            // An early tick that found a thread still running doesn't mark a
+            // tick period; start counting real time from here instead.
+            s_bSkipping = false;
+            KernelTimer_Arm(PORT_HOST_TICK_PERIOD_US);
+        } else if ((nullptr == g_pclBlocked) || (&s_clTimerThread == g_pclBlocked)) {
+            // Only count real time if no thread has blocked for the whole
+            // tick period, i.e. the threads running are busy-waiting or
+            // CPU-bound.  The timer thread blocks again after each tick, so
+            // it doesn't count.  Threads that block regularly only see
+            // virtual time, so their runs stay repeatable.
+            s_u32PendingTicks++;
+            Kernel::Tick();
+            s_clTimerSemaphore.Post();
+        }
+        g_pclBlocked = nullptr;
+#else
+        Kernel::Tick();
+        s_llTickNs = KernelTimer_NowNs();
+#if KERNEL_TICKLESS
+        s_u32PendingTicks++;
+#endif // #if KERNEL_TICKLESS
+        s_clTimerSemaphore.Post();
+#endif // #if PORT_HOST_VIRTUAL_TIME
+    }
+#if KERNEL_TRACE
+    KernelTrace::IsrExit(uTraceVectorTick);
+#endif // #if KERNEL_TRACE
+    ThreadPort_IsrExit();
+}
+
+#if KERNEL_HIRES_TIMERS
+//---------------------------------------------------------------------------
+void KernelTimer_CompareHandler(int /*iSignal_*/)
+{
+    ThreadPort_IsrEnter();
+    if (Kernel::IsStarted()) {
+        HiResTimer::Process();
+    }
+    ThreadPort_IsrExit();
+}
+#endif // #if KERNEL_HIRES_TIMERS
+
+#if KERNEL_TICKLESS || KERNEL_HIRES_TIMERS
+//---------------------------------------------------------------------------
+timespec KernelTimer_FromNs(long long llNs_)
+{
+    auto stTime    = timespec {};
+    stTime.tv_sec  = static_cast<time_t>(llNs_ / 1000000000);
+    stTime.tv_nsec = static_cast<long>(llNs_ % 1000000000);
+    return stTime;
+}
+#endif // #if KERNEL_TICKLESS || KERNEL_HIRES_TIMERS
+} // anonymous namespace
 
 namespace Mark3
 {
+//---------------------------------------------------------------------------
+static void KernelTimer_Task(void* unused)
+{
+    (void)unused;
+    while (1) {
+        s_clTimerSemaphore.Pend();
+#if KERNEL_ROUND_ROBIN
+        Quantum::SetInTimer();
+#endif // #if KERNEL_ROUND_ROBIN
+#if PORT_HOST_VIRTUAL_TIME || KERNEL_TICKLESS
+        auto u32Ticks = uint32_t {};
+        {
+            const auto cs     = CriticalGuard {};
+            u32Ticks          = s_u32PendingTicks;
+            s_u32PendingTicks = 0;
+        }
+        TimerScheduler::Process(u32Ticks);
+#else
+        TimerScheduler::Process();
+#endif // #if PORT_HOST_VIRTUAL_TIME || KERNEL_TICKLESS
+#if KERNEL_ROUND_ROBIN
+        Quantum::ClearInTimer();
+#endif // #if KERNEL_ROUND_ROBIN
+    }
+}
 
 //---------------------------------------------------------------------------
 void KernelTimer::Config(void)
 {
+    s_clTimerSemaphore.Init(0, 1);
+    s_clTimerThread.Init(s_clTimerThreadStack,
+                         sizeof(s_clTimerThreadStack),
+                         KERNEL_TIMERS_THREAD_PRIORITY,
+                         KernelTimer_Task,
+                         0);
+#if KERNEL_ROUND_ROBIN
+    Quantum::SetTimerThread(&s_clTimerThread);
+#endif // #if KERNEL_ROUND_ROBIN
+#if KERNEL_SMP
+    // The tick is only delivered to core 0, so service it there.
+    s_clTimerThread.SetCore(0);
+#endif // #if KERNEL_SMP
+    s_clTimerThread.Start();
+
+    // Other kernel signals are masked while the handler runs, as "interrupts"
+    // don't nest; SA_RESTART keeps the tick from interrupting blocking host
+    // syscalls.
+    auto stAction       = (struct sigaction) {};
+    stAction.sa_handler = KernelTimer_Handler;
+    stAction.sa_flags   = SA_RESTART;
+    stAction.sa_mask    = g_stIrqMask;
+    sigaction(SIGALRM, &stAction, nullptr);
+
+    // Direct the tick at this host thread, rather than the process
+    auto stEvent                   = sigevent {};
+    stEvent.sigev_notify           = SIGEV_THREAD_ID;
+    stEvent.sigev_signo            = SIGALRM;
+    stEvent.sigev_notify_thread_id = gettid();
+    timer_create(CLOCK_MONOTONIC, &stEvent, &s_stTimer);
+
+#if KERNEL_HIRES_TIMERS
+    stAction.sa_handler = KernelTimer_CompareHandler;
+    sigaction(SIGRTMIN, &stAction, nullptr);
+
+    stEvent.sigev_signo = SIGRTMIN;
+    timer_create(CLOCK_MONOTONIC, &stEvent, &s_stCompareTimer);
+#endif // #if KERNEL_HIRES_TIMERS
 }
 
 //---------------------------------------------------------------------------
 void KernelTimer::Start(void)
 {
+#if !PORT_HOST_VIRTUAL_TIME
+    s_llTickNs = KernelTimer_NowNs();
+#endif // #if !PORT_HOST_VIRTUAL_TIME
+    KernelTimer_Arm(PORT_HOST_TICK_PERIOD_US); // 1KHz fixed clock...
 }
 
 //---------------------------------------------------------------------------
 void KernelTimer::Stop(void)
 {
+    timer_delete(s_stTimer);
+#if KERNEL_HIRES_TIMERS
+    timer_delete(s_stCompareTimer);
+#endif // #if KERNEL_HIRES_TIMERS
+    // Only called when shutting down the kernel instance, so the timer thread
+    // is retired as well -- leaving it blocked would trigger a descoping panic
+    // when its (thread-local) storage is destroyed.
+    s_clTimerThread.Exit();
+}
+
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::GetCycleCount(void)
+{
+    // Host time-stamp counter; only the low 32 bits are used, which wrap
+    // every second or two at current clock rates.
+    return static_cast<uint32_t>(__builtin_ia32_rdtsc());
+}
+
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::GetTickOffset(void)
+{
+#if PORT_HOST_VIRTUAL_TIME
+    // Time only passes in whole ticks
+    return 0;
+#else
+    // Scale the host time since the last tick signal was handled.  There's
+    // no way to see a pending signal, so a late one holds the offset at the
+    // end of the tick, rather than letting it run on into the next.
+    auto llNs = KernelTimer_NowNs() - s_llTickNs;
+    if (llNs <= 0) {
+        return 0;
+    }
+    if (llNs >= llTickNs) {
+        return PORT_TIMER_FREQ - 1;
+    }
+    return static_cast<uint32_t>((llNs * PORT_TIMER_FREQ) / llTickNs);
+#endif // #if PORT_HOST_VIRTUAL_TIME
+}
+
+#if KERNEL_TICKLESS
+//---------------------------------------------------------------------------
+void KernelTimer::Suppress(uint32_t u32Ticks_)
+{
+    // Run on from the next boundary of the periodic tick
+    auto stTimer = itimerspec {};
+    timer_gettime(s_stTimer, &stTimer);
+    auto llNs = KernelTimer_ToNs(stTimer.it_value) + ((u32Ticks_ - 1) * llTickNs);
+
+    stTimer.it_interval = timespec {};
+    stTimer.it_value    = KernelTimer_FromNs(llNs);
+    timer_settime(s_stTimer, 0, &stTimer, nullptr);
+    s_u32Suppressed = u32Ticks_;
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer::Wait(void)
+{
+    // The kernel's signals are blocked, so take the first one to arrive
+    // without running its handler, and raise it again to be handled once the
+    // caller unblocks them.
+    auto iSignal = int {};
+    sigwait(&g_stIrqMask, &iSignal);
+    raise(iSignal);
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer::Resume(void)
+{
+    auto stTimer = itimerspec {};
+    timer_gettime(s_stTimer, &stTimer);
+    auto llRemain = KernelTimer_ToNs(stTimer.it_value);
+
+    // A disarmed timer means the one-shot expired, and its pending signal
+    // accounts for the final tick.  Otherwise, count the boundaries passed.
+    auto u32Left   = uint32_t { 1 };
+    auto llToFirst = llTickNs;
+    if (0 != llRemain) {
+        u32Left   = static_cast<uint32_t>((llRemain + llTickNs - 1) / llTickNs);
+        llToFirst = llRemain - ((u32Left - 1) * llTickNs);
+    }
+
+    // Restart the periodic tick, due at the next boundary
+    stTimer.it_interval = KernelTimer_FromNs(llTickNs);
+    stTimer.it_value    = KernelTimer_FromNs(llToFirst);
+    timer_settime(s_stTimer, 0, &stTimer, nullptr);
+    s_llTickNs = KernelTimer_NowNs() - (llTickNs - llToFirst);
+
+    auto u32Elapsed = s_u32Suppressed - u32Left;
+    if (0 != u32Elapsed) {
+        Kernel::Tick(u32Elapsed);
+        s_u32PendingTicks += u32Elapsed;
+        s_clTimerSemaphore.Post();
+    }
+}
+#endif // #if KERNEL_TICKLESS
+
+#if KERNEL_HIRES_TIMERS
+//---------------------------------------------------------------------------
+bool KernelTimer::SetCompare(uint64_t u64Clock_)
+{
+    auto u64Now = Kernel::GetClock();
+    auto llNow  = KernelTimer_NowNs();
+    if (u64Clock_ <= u64Now) {
+        return false;
+    }
+
+    // Round up, so the compare never fires before the clock gets there.  If
+    // the clock is held back by a late tick, the compare can still arrive
+    // early, and HiResTimer::Process() just re-arms it.
+    auto u64Delta = u64Clock_ - u64Now;
+    if (u64Delta > u64MaxCompare) {
+        u64Delta = u64MaxCompare;
+    }
+    auto llDelta = ((static_cast<long long>(u64Delta) * llTickNs) + PORT_TIMER_FREQ - 1) / PORT_TIMER_FREQ;
+
+    auto stTimer     = itimerspec {};
+    stTimer.it_value = KernelTimer_FromNs(llNow + llDelta);
+    timer_settime(s_stCompareTimer, TIMER_ABSTIME, &stTimer, nullptr);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+void KernelTimer::ClearCompare(void)
+{
+    auto stTimer = itimerspec {};
+    timer_settime(s_stCompareTimer, 0, &stTimer, nullptr);
 }
+#endif // #if KERNEL_HIRES_TIMERS
 } // namespace Mark3
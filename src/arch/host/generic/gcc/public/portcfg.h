@@ -30,9 +30,12 @@ See license.txt for more information
     thread priority.
 
     In practice, systems rarely need more than 32 priority levels, with the
-    most complex having the capacity for 256.
+    most complex having the capacity for 256.  Larger values (i.e. 1024+ for
+    deadline or QoS encodings) are supported by the N-level priority map.
 */
+#if !defined(KERNEL_NUM_PRIORITIES)
 #define KERNEL_NUM_PRIORITIES (64)
+#endif
 
 #define KERNEL_TIMERS_THREAD_PRIORITY (KERNEL_NUM_PRIORITIES - 1)
 
@@ -91,14 +94,81 @@ See license.txt for more information
 #define PORT_TIMER_FREQ ((uint32_t)(PORT_SYSTEM_FREQ / 1000)) //!< Fixed timer interrupt frequency
 
 /**
-    Define the default/minimum size of a thread stack
+    Set the period of the host's kernel tick signal, in microseconds.
+*/
+#define PORT_HOST_TICK_PERIOD_US (1000)
+
+/**
+    Set this to 1 to drive the kernel tick from virtual time.  Whenever the
+    tick signal finds the idle (priority 0) thread running, the kernel clock
+    jumps directly to the next timer expiry, so long sleeps/timeouts
+    complete at the speed of the host CPU.  Time only passes in real time
+    for tick periods in which no thread blocks (i.e. while threads are
+    busy-waiting, or CPU-bound); workloads that block regularly see only
+    virtual time, so their runs are repeatable.  Sub-tick clock readings are
+    not available in this mode.
+*/
+#if !defined(PORT_HOST_VIRTUAL_TIME)
+#define PORT_HOST_VIRTUAL_TIME (0)
+#endif
+
+/**
+    The host port supports running multiple independent kernel instances in
+    one process (one per host thread) when KERNEL_MULTI_INSTANCE is enabled.
 */
-#define PORT_KERNEL_DEFAULT_STACK_SIZE ((K_ADDR)384)
+#define PORT_SUPPORTS_MULTI_INSTANCE (1)
+
+/**
+    The host port can emulate a symmetric multiprocessor, with each core run
+    on its own host thread, when KERNEL_NUM_CORES is greater than 1.
+*/
+#define PORT_SUPPORTS_SMP (1)
+
+/**
+    The host's tick timer can be reprogrammed as a one-shot to suppress the
+    kernel tick while idle when KERNEL_TICKLESS is enabled.  Virtual time is
+    already driven by the next timer expiry, so the two can't be combined.
+*/
+#define PORT_SUPPORTS_TICKLESS (!PORT_HOST_VIRTUAL_TIME)
+#define PORT_TICKLESS_MAX_TICKS ((uint32_t)(1UL << 20))
+
+/**
+    High-resolution timers use a second POSIX timer, signalling SIGRTMIN, as
+    the compare channel on the kernel clock.  The kernel clock has no
+    sub-tick resolution in virtual time, so the two can't be combined.
+*/
+#define PORT_SUPPORTS_HIRES_TIMER (!PORT_HOST_VIRTUAL_TIME)
+
+/**
+    The host shares its CPUs with other processes, so how much work a thread
+    gets done in a tick - real or virtual - depends on what else the host is
+    running.  Round-robin scheduling still gives threads the same number of
+    ticks each, but not the same amount of work.
+*/
+#define PORT_SHARED_CPU (1)
+
+/**
+    Room required on a thread stack for the thread's own usage and the kernel's
+    signal handlers, on top of the signal frame itself.  On the host, kernel
+    "interrupts" are signals delivered on the running thread's stack, and the
+    size of a signal frame depends on the extended register state of the CPU
+    (AVX-512 and AMX state alone take ~11KB).  The minimum frame size is read
+    from the OS at runtime (sysconf(_SC_MINSIGSTKSZ)), and every thread stack
+    is checked against it, plus this margin, when the thread is initialized.
+*/
+#define PORT_HOST_STACK_MARGIN ((K_ADDR)16384)
+
+/**
+    Define the default/minimum size of a thread stack.  This must cover the
+    largest signal frame of any x86-64 CPU the host runs on, plus
+    PORT_HOST_STACK_MARGIN.
+*/
+#define PORT_KERNEL_DEFAULT_STACK_SIZE ((K_ADDR)32768)
 
 /**
     Define the size of the kernel-timer thread stack (if one is configured)
 */
-#define PORT_KERNEL_TIMERS_THREAD_STACK ((K_ADDR)384)
+#define PORT_KERNEL_TIMERS_THREAD_STACK ((K_ADDR)32768)
 
 /**
     Define the native type corresponding to the kernel timer hardware's counter register.
@@ -123,6 +193,13 @@ See license.txt for more information
 */
 #define PORT_STACK_GROWS_DOWN (1)
 
+/**
+    Offset (in bytes) of the stack-top pointer within the Thread object, used by the
+    context-switch code.  This is the size of the linked-list node the Thread inherits
+    (two pointers), and is checked against the Thread layout at compile time.
+*/
+#define PORT_THREAD_STACK_TOP_OFFSET (16)
+
 /**
     Set this to 1 if the target CPU/toolchain supports an optimized Count-leading-zeros instruction,
     or count-leading-zeros intrinsic.  If such functionality is not available, a general-purpose
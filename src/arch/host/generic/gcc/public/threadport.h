@@ -15,51 +15,184 @@ See license.txt for more information
 
     @file   threadport.h
 
-    @brief  ATMega328p Multithreading support.
+    @brief  x86-64 Linux host multithreading support.
+
+    The host port runs each Mark3 thread on its own statically-allocated
+    stack inside a single OS thread.  Context switches are performed by a
+    hand-written x86-64 register save/restore routine, while the kernel's
+    "interrupts" are POSIX signals.  Critical sections are implemented by
+    masking those signals, which gives the same semantics as disabling
+    interrupts on a microcontroller target.
+
+    In SMP mode (KERNEL_NUM_CORES > 1), each core is emulated by its own OS
+    thread.  Critical sections additionally take a kernel-wide spinlock, and
+    inter-processor interrupts are delivered to a core's OS thread as SIGUSR1.
  */
 #pragma once
 
-#include "portcfg.h"
+#include "mark3cfg.h"
 #include "kerneltypes.h"
 
+#include <signal.h>
+#include <pthread.h>
+
 namespace Mark3
 {
-
+// clang-format off
 //---------------------------------------------------------------------------
 //! Macro to find the top of a stack given its size and top address
-#define PORT_TOP_OF_STACK(x, y)         (reinterpret_cast<K_WORD*>(reinterpret_cast<K_ADDR>(x) + (static_cast<K_ADDR>(y) - 1)))
+#define PORT_TOP_OF_STACK(x, y)         (reinterpret_cast<K_WORD*>(reinterpret_cast<K_ADDR>(x) + (static_cast<K_ADDR>(y) - sizeof(K_WORD))))
 //! Push a value y to the stack pointer x and decrement the stack pointer
 #define PORT_PUSH_TO_STACK(x, y)        *x = y; x--;
 
+//! Count-leading-zeros for the 64-bit priority map words.  CLZ of 0 is undefined for the builtin.
+#define PORT_CLZ(x)      ((x) ? static_cast<PORT_PRIO_TYPE>(__builtin_clzll((x))) : PORT_PRIO_TYPE { 64 })
+// clang-format on
+
+#if KERNEL_SMP && PORT_HOST_VIRTUAL_TIME
+#error "PORT_HOST_VIRTUAL_TIME is not supported with KERNEL_NUM_CORES > 1"
+#endif // #if KERNEL_SMP && PORT_HOST_VIRTUAL_TIME
+
+class Thread;
+
 //------------------------------------------------------------------------
 extern "C" {
-   extern uint8_t g_u8SR;
-   extern K_WORD g_kwCriticalCount;
+#if KERNEL_SMP
+extern K_WORD g_akwCriticalCount[KERNEL_NUM_CORES];
+extern bool   g_abSwitchPending[KERNEL_NUM_CORES];
+extern bool   g_abInIsr[KERNEL_NUM_CORES];
+#else
+extern KERNEL_INSTANCE_STATE K_WORD   g_kwCriticalCount;
+extern KERNEL_INSTANCE_STATE bool     g_bSwitchPending;
+extern KERNEL_INSTANCE_STATE bool     g_bInIsr;
+#endif // #if KERNEL_SMP
+#if PORT_HOST_VIRTUAL_TIME
+extern KERNEL_INSTANCE_STATE Thread* g_pclBlocked; //!< Last thread to block/exit since the tick cleared this
+#endif // #if PORT_HOST_VIRTUAL_TIME
+extern KERNEL_INSTANCE_STATE sigset_t g_stIrqMask;
 }
 
+#if KERNEL_SMP
+//------------------------------------------------------------------------
+/**
+ * @brief ThreadPort_CoreId
+ * Return the index of the core (OS thread) executing the caller.  Never
+ * inlined, so that the result isn't cached across a context switch.
+ */
+uint8_t ThreadPort_CoreId() __attribute__((noinline));
+
+//------------------------------------------------------------------------
+/**
+ * @brief ThreadPort_LockKernel
+ * Acquire the kernel spinlock.  Must be called with kernel signals masked.
+ */
+void ThreadPort_LockKernel();
+
+//------------------------------------------------------------------------
+/**
+ * @brief ThreadPort_UnlockKernel
+ * Release the kernel spinlock.
+ */
+void ThreadPort_UnlockKernel();
+
+//! Per-core port state is that of the executing core
+#define g_kwCriticalCount (g_akwCriticalCount[Mark3::ThreadPort_CoreId()])
+#define g_bSwitchPending (g_abSwitchPending[Mark3::ThreadPort_CoreId()])
+#define g_bInIsr (g_abInIsr[Mark3::ThreadPort_CoreId()])
+#endif // #if KERNEL_SMP
+
+//------------------------------------------------------------------------
+/**
+ * @brief ThreadPort_Switch
+ * Perform a pending context switch from g_pclCurrent to g_pclNext.  Must be
+ * called with kernel signals masked (and in SMP mode, the kernel lock held;
+ * the lock is released by the incoming thread once it resumes).
+ */
+void ThreadPort_Switch();
+
+//------------------------------------------------------------------------
+/**
+ * @brief ThreadPort_IsrEnter
+ * Must be called at the start of any signal handler that calls into the
+ * kernel.  Context switches requested from within the handler are deferred
+ * until the matching ThreadPort_IsrExit().
+ */
+void ThreadPort_IsrEnter();
+
+//------------------------------------------------------------------------
+/**
+ * @brief ThreadPort_IsrExit
+ * Must be called at the end of any signal handler that calls into the kernel.
+ * Performs any context switch requested by the handler, emulating a
+ * PendSV-style deferred switch on interrupt return.
+ */
+void ThreadPort_IsrExit();
+
+#if !KERNEL_SMP
+//------------------------------------------------------------------------
+/**
+ * @brief ThreadPort_ExitKernel
+ * Shut down the calling kernel instance, and resume the host context that
+ * called Kernel::Start(), which then returns.  Must be called from thread
+ * context.  The kernel's signals remain masked on the host thread afterwards.
+ *
+ * The instance's threads and objects are abandoned in place -- any that are
+ * later destroyed while still in use will trigger the usual descoping
+ * panics, so they should either be left in storage that is never destroyed,
+ * or be destroyed with a panic handler installed that ignores those causes.
+ */
+void ThreadPort_ExitKernel();
+#endif // #if !KERNEL_SMP
+
 //------------------------------------------------------------------------
 inline void PORT_IRQ_ENABLE()
 {
+    pthread_sigmask(SIG_UNBLOCK, &g_stIrqMask, nullptr);
 }
 
 //------------------------------------------------------------------------
 inline void PORT_IRQ_DISABLE()
 {
+    pthread_sigmask(SIG_BLOCK, &g_stIrqMask, nullptr);
 }
 
 //------------------------------------------------------------------------
 inline void PORT_CS_ENTER()
 {
+    if (!g_kwCriticalCount) {
+        // Signals are already masked by the OS while a handler is running
+        if (!g_bInIsr) {
+            PORT_IRQ_DISABLE();
+        }
+#if KERNEL_SMP
+        ThreadPort_LockKernel();
+#endif // #if KERNEL_SMP
+    }
+    g_kwCriticalCount++;
 }
 //------------------------------------------------------------------------
 inline void PORT_CS_EXIT()
 {
+    g_kwCriticalCount--;
+    if (!g_kwCriticalCount) {
+        // Equivalent of a pended software interrupt firing as soon as
+        // interrupts are re-enabled.
+        if (!g_bInIsr && g_bSwitchPending) {
+            ThreadPort_Switch();
+        }
+#if KERNEL_SMP
+        ThreadPort_UnlockKernel();
+#endif // #if KERNEL_SMP
+        if (!g_bInIsr) {
+            PORT_IRQ_ENABLE();
+        }
+    }
 }
 
 //---------------------------------------------------------------------------
 inline K_WORD PORT_CS_NESTING()
 {
-    return 0;
+    return g_kwCriticalCount;
 }
 
 } // namespace Mark3
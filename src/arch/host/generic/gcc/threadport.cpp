@@ -15,7 +15,7 @@ See license.txt for more information
 
     @file   threadport.cpp
 
-    @brief  Stubs for host build -- NON-FUNCTIONAL!
+    @brief  x86-64 Linux host multithreading
 
 */
 
@@ -23,18 +23,414 @@ See license.txt for more information
 #include "mark3cfg.h"
 #include "thread.h"
 #include "threadport.h"
+#include "kernelswi.h"
+#include "kerneltimer.h"
+#include "timerlist.h"
+#include "quantum.h"
+#include "kernel.h"
+#include "kerneldebug.h"
+
+#include <unistd.h>
+
+//---------------------------------------------------------------------------
+extern "C" {
+#if KERNEL_SMP
+K_WORD g_akwCriticalCount[KERNEL_NUM_CORES];
+bool   g_abSwitchPending[KERNEL_NUM_CORES];
+bool   g_abInIsr[KERNEL_NUM_CORES];
+#else
+KERNEL_INSTANCE_STATE K_WORD   g_kwCriticalCount;
+KERNEL_INSTANCE_STATE bool     g_bSwitchPending;
+KERNEL_INSTANCE_STATE bool     g_bInIsr;
+#endif // #if KERNEL_SMP
+#if PORT_HOST_VIRTUAL_TIME
+KERNEL_INSTANCE_STATE Mark3::Thread* g_pclBlocked;
+#endif // #if PORT_HOST_VIRTUAL_TIME
+KERNEL_INSTANCE_STATE sigset_t g_stIrqMask;
+
+void ThreadPort_SwapContext(K_WORD** ppwSaveStack_, K_WORD* pwNewStack_);
+void ThreadPort_LoadContext(K_WORD* pwNewStack_) __attribute__((noreturn));
+void ThreadPort_ThreadStart(void);
+void ThreadPort_ThreadEntry(Mark3::ThreadEntryFunc pfEntry_, void* pvArg_) __attribute__((noreturn));
+}
 
 //---------------------------------------------------------------------------
+/*
+    Context Switching:
+
+    Unlike the microcontroller ports, the host port doesn't have an exception
+    mechanism that stacks half of the register file for us, so the context
+    switch is a plain function call.  Because of that, only the registers the
+    System-V AMD64 ABI defines as callee-saved need to be preserved:
+
+    rbp, rbx, r12-r15, the MXCSR register, and the x87 control word.
+
+    Everything else is either caller-saved (and thus already spilled by the
+    compiler around the call), or is the stack pointer itself, which is
+    stored into the outgoing thread's m_pwStackTop.
+
+    ThreadPort_SwapContext(&outgoing->m_pwStackTop, incoming->m_pwStackTop):
+
+        push rbp, rbx, r12-r15
+        sub  8, rsp             ; room for MXCSR + x87 control word
+        stmxcsr (rsp)
+        fnstcw 4(rsp)
+        mov  rsp, (rdi)         ; save outgoing top-of-stack
+        mov  rsi, rsp           ; switch to incoming stack
+        ldmxcsr (rsp)
+        fldcw 4(rsp)
+        add  8, rsp
+        pop  r15-r12, rbx, rbp
+        ret                     ; return into the incoming thread
+
+    ThreadPort_LoadContext() is the second half of the same sequence, used to
+    start the first thread.
+
+    A new thread's stack is built so that the "ret" lands in
+    ThreadPort_ThreadStart, with the entrypoint and argument held in r12/r13.
+    The trampoline aligns the stack as the ABI requires and calls into
+    ThreadPort_ThreadEntry(), which never returns.
+*/
+asm(R"(
+    .text
+    .globl  ThreadPort_SwapContext
+    .type   ThreadPort_SwapContext, @function
+ThreadPort_SwapContext:
+    pushq   %rbp
+    pushq   %rbx
+    pushq   %r12
+    pushq   %r13
+    pushq   %r14
+    pushq   %r15
+    subq    $8, %rsp
+    stmxcsr (%rsp)
+    fnstcw  4(%rsp)
+    movq    %rsp, (%rdi)
+    movq    %rsi, %rsp
+    ldmxcsr (%rsp)
+    fldcw   4(%rsp)
+    addq    $8, %rsp
+    popq    %r15
+    popq    %r14
+    popq    %r13
+    popq    %r12
+    popq    %rbx
+    popq    %rbp
+    ret
+    .size   ThreadPort_SwapContext, .-ThreadPort_SwapContext
+
+    .globl  ThreadPort_LoadContext
+    .type   ThreadPort_LoadContext, @function
+ThreadPort_LoadContext:
+    movq    %rdi, %rsp
+    ldmxcsr (%rsp)
+    fldcw   4(%rsp)
+    addq    $8, %rsp
+    popq    %r15
+    popq    %r14
+    popq    %r13
+    popq    %r12
+    popq    %rbx
+    popq    %rbp
+    ret
+    .size   ThreadPort_LoadContext, .-ThreadPort_LoadContext
+
+    .globl  ThreadPort_ThreadStart
+    .type   ThreadPort_ThreadStart, @function
+ThreadPort_ThreadStart:
+    movq    %r12, %rdi
+    movq    %r13, %rsi
+    andq    $-16, %rsp
+    call    ThreadPort_ThreadEntry
+    ud2
+    .size   ThreadPort_ThreadStart, .-ThreadPort_ThreadStart
+)");
+
 namespace Mark3
 {
+namespace
+{
+    //---------------------------------------------------------------------------
+    // The thread's top-of-stack pointer lives at PORT_THREAD_STACK_TOP_OFFSET
+    // within the Thread object, as for the other ports' assembly handlers.
+    K_WORD** StackTopPointer(Thread* pclThread_)
+    {
+        return reinterpret_cast<K_WORD**>(reinterpret_cast<K_ADDR>(pclThread_) + PORT_THREAD_STACK_TOP_OFFSET);
+    }
+
+    //---------------------------------------------------------------------------
+    // Default MXCSR (all exceptions masked, round-to-nearest), and default x87
+    // control word (extended precision, all exceptions masked), packed into
+    // a single stack word in the order the context-switch code expects.
+    constexpr auto uDefaultFpuWord = K_WORD { 0x00001F80 } | (K_WORD { 0x037F } << 32);
+
+    //---------------------------------------------------------------------------
+#if KERNEL_SMP
+    //---------------------------------------------------------------------------
+    // Core emulation: the index of the core each OS thread represents, the OS
+    // thread handles used to deliver IPIs, and the kernel spinlock.
+    thread_local uint8_t s_u8CoreId;
+    pthread_t            s_astCoreThread[KERNEL_NUM_CORES];
+    pthread_barrier_t    s_stCoreBarrier;
+    bool                 s_bKernelLock;
+    K_WORD*              s_apwBootStack[KERNEL_NUM_CORES];
+#else
+    //---------------------------------------------------------------------------
+    // Saved stack pointer of the host context that called Kernel::Start(),
+    // resumed by ThreadPort_ExitKernel().
+    KERNEL_INSTANCE_STATE K_WORD* s_pwBootStack;
+#endif // #if KERNEL_SMP
+
+#if KERNEL_DEBUG
+    //---------------------------------------------------------------------------
+    // Smallest stack that can take a kernel signal on this host: the OS's
+    // minimum signal frame size for the CPU, plus PORT_HOST_STACK_MARGIN.
+    K_ADDR MinStackSize()
+    {
+#if defined(_SC_MINSIGSTKSZ)
+        auto lFrame = sysconf(_SC_MINSIGSTKSZ);
+#else
+        auto lFrame = static_cast<long>(MINSIGSTKSZ);
+#endif // #if defined(_SC_MINSIGSTKSZ)
+        return static_cast<K_ADDR>(lFrame) + PORT_HOST_STACK_MARGIN;
+    }
+#endif // #if KERNEL_DEBUG
+} // anonymous namespace
+
 //---------------------------------------------------------------------------
+/*
+    Stack frame built by InitStack, from the top of the stack downwards:
+
+    [ 0                      ]  <- alignment padding / fake return address
+    [ ThreadPort_ThreadStart ]  <- consumed by "ret"
+    [ rbp = 0                ]
+    [ rbx = 0                ]
+    [ r12 = entrypoint       ]
+    [ r13 = argument         ]
+    [ r14 = 0                ]
+    [ r15 = 0                ]
+    [ MXCSR | x87 CW         ]  <- m_pwStackTop
+*/
 void ThreadPort::InitStack(Thread* pclThread_)
 {
+    KERNEL_ASSERT(pclThread_->m_uStackSize >= MinStackSize());
+
+    // Initialize the stack to all FF's to aid in stack depth checking
+#if KERNEL_STACK_PAINT
+    auto* pwTemp = pclThread_->m_pwStack;
+    for (K_ADDR i = 0; i < pclThread_->m_uStackSize / sizeof(K_WORD); i++) { pwTemp[i] = static_cast<K_WORD>(-1); }
+#endif // #if KERNEL_STACK_PAINT
+
+    // Keep the initial frame 16-byte aligned, as required by the ABI
+    auto* pwStack = reinterpret_cast<K_WORD*>(reinterpret_cast<K_ADDR>(pclThread_->m_pwStackTop) & ~K_ADDR { 15 });
+
+    PORT_PUSH_TO_STACK(pwStack, 0);
+    PORT_PUSH_TO_STACK(pwStack, reinterpret_cast<K_WORD>(ThreadPort_ThreadStart));
+    PORT_PUSH_TO_STACK(pwStack, 0); // rbp
+    PORT_PUSH_TO_STACK(pwStack, 0); // rbx
+    PORT_PUSH_TO_STACK(pwStack, reinterpret_cast<K_WORD>(pclThread_->m_pfEntryPoint)); // r12
+    PORT_PUSH_TO_STACK(pwStack, reinterpret_cast<K_WORD>(pclThread_->m_pvArg));        // r13
+    PORT_PUSH_TO_STACK(pwStack, 0); // r14
+    PORT_PUSH_TO_STACK(pwStack, 0); // r15
+    PORT_PUSH_TO_STACK(pwStack, uDefaultFpuWord);
+    pwStack++;
+
+    pclThread_->m_pwStackTop = pwStack;
 }
 
 //---------------------------------------------------------------------------
-void ThreadPort::StartThreads()
+void ThreadPort_Switch()
+{
+    g_bSwitchPending = false;
+
+    auto* pclPrev = g_pclCurrent;
+    g_pclCurrent  = g_pclNext;
+    if (pclPrev != g_pclCurrent) {
+#if PORT_HOST_VIRTUAL_TIME
+        if (ThreadState::Ready != pclPrev->GetState()) {
+            g_pclBlocked = pclPrev;
+        }
+#endif // #if PORT_HOST_VIRTUAL_TIME
+        ThreadPort_SwapContext(StackTopPointer(pclPrev), *StackTopPointer(g_pclCurrent));
+    }
+}
+
+//---------------------------------------------------------------------------
+void ThreadPort_IsrEnter()
 {
+    g_bInIsr = true;
 }
 
+//---------------------------------------------------------------------------
+void ThreadPort_IsrExit()
+{
+    g_bInIsr = false;
+    // The handler's frame stays on the interrupted thread's stack until that
+    // thread is switched back in, at which point it returns from the signal
+    // handler as normal.
+    if (g_bSwitchPending) {
+#if KERNEL_SMP
+        ThreadPort_LockKernel();
+        ThreadPort_Switch();
+        ThreadPort_UnlockKernel();
+#else
+        ThreadPort_Switch();
+#endif // #if KERNEL_SMP
+    }
+}
+
+#if KERNEL_SMP
+//---------------------------------------------------------------------------
+uint8_t ThreadPort_CoreId()
+{
+    return s_u8CoreId;
+}
+
+//---------------------------------------------------------------------------
+void ThreadPort_LockKernel()
+{
+    while (__atomic_test_and_set(&s_bKernelLock, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(&s_bKernelLock, __ATOMIC_RELAXED)) {
+            __builtin_ia32_pause();
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+void ThreadPort_UnlockKernel()
+{
+    __atomic_clear(&s_bKernelLock, __ATOMIC_RELEASE);
+}
+
+//---------------------------------------------------------------------------
+uint8_t ThreadPort::GetCoreId()
+{
+    return ThreadPort_CoreId();
+}
+
+//---------------------------------------------------------------------------
+void ThreadPort::SendIpi(uint8_t u8Core_)
+{
+    pthread_kill(s_astCoreThread[u8Core_], SIGUSR1);
+}
+
+namespace
+{
+    //---------------------------------------------------------------------------
+    // Common startup path for all cores, once the kernel has been configured.
+    void ThreadPort_RunCore(uint8_t u8Core_)
+    {
+        s_u8CoreId               = u8Core_;
+        s_astCoreThread[u8Core_] = pthread_self();
+
+        // Wait for every core to be reachable by IPIs before any of them
+        // start running threads.
+        pthread_barrier_wait(&s_stCoreBarrier);
+
+        PORT_CS_ENTER();
+        Scheduler::SetScheduler(1); // enable the scheduler on this core
+        Scheduler::Schedule();      // determine the first thread to run on this core
+        g_pclCurrent = g_pclNext;
+#if KERNEL_ROUND_ROBIN
+        Quantum::Update(g_pclCurrent);
+#endif // #if KERNEL_ROUND_ROBIN
+
+        // Switch to the first thread with the kernel lock still held - the new
+        // thread's entry trampoline releases it.
+        g_kwCriticalCount--;
+        ThreadPort_SwapContext(&s_apwBootStack[u8Core_], *StackTopPointer(g_pclCurrent));
+    }
+
+    //---------------------------------------------------------------------------
+    void* ThreadPort_SecondaryCore(void* pvCore_)
+    {
+        ThreadPort_RunCore(static_cast<uint8_t>(reinterpret_cast<K_ADDR>(pvCore_)));
+        return nullptr;
+    }
+} // anonymous namespace
+#else
+//---------------------------------------------------------------------------
+void ThreadPort_ExitKernel()
+{
+    PORT_CS_ENTER();
+
+    // Stop the tick and retire the timer thread.  Any reschedule this causes
+    // is left pending, and discarded along with the rest of the instance.
+    KernelTimer::Stop();
+
+    g_kwCriticalCount = 0;
+    g_bSwitchPending  = false;
+    g_bInIsr          = false;
+    ThreadPort_LoadContext(s_pwBootStack);
+}
+#endif // #if KERNEL_SMP
+
+//---------------------------------------------------------------------------
+void ThreadPort::StartThreads()
+{
+    KernelSWI::Config();   // configure the task switch SWI
+    KernelTimer::Config(); // configure the kernel timer
+
+    // Tell the kernel that we're ready to start scheduling threads
+    // for the first time.
+    Kernel::CompleteStart();
+
+#if KERNEL_SMP
+    // Secondary cores inherit the masked kernel signals from this thread
+    PORT_IRQ_DISABLE();
+    pthread_barrier_init(&s_stCoreBarrier, nullptr, KERNEL_NUM_CORES);
+    for (auto u8Core = uint8_t { 1 }; u8Core < KERNEL_NUM_CORES; u8Core++) {
+        auto stThread = pthread_t {};
+        pthread_create(&stThread, nullptr, ThreadPort_SecondaryCore, reinterpret_cast<void*>(u8Core));
+    }
+
+    KernelTimer::Start(); // enable the kernel timer (delivered to core 0 only)
+    KernelSWI::Start();   // enable the task switch SWI
+
+    // This thread becomes core 0.
+    ThreadPort_RunCore(0);
+#else
+    Scheduler::SetScheduler(1); // enable the scheduler
+    Scheduler::Schedule();      // run the scheduler - determine the first thread to run
+
+    // Don't take any kernel signals until the first thread is running - the
+    // new thread's entry trampoline unmasks them.
+    PORT_IRQ_DISABLE();
+    g_pclCurrent = g_pclNext; // Set the next scheduled thread to the current thread
+
+    KernelTimer::Start(); // enable the kernel timer
+    KernelSWI::Start();   // enable the task switch SWI
+
+#if KERNEL_ROUND_ROBIN
+    // Restart the thread quantum timer, as any value held prior to starting
+    // the kernel will be invalid.  This fixes a bug where multiple threads
+    // started with the highest priority before starting the kernel causes problems
+    // until the running thread voluntarily blocks.
+    Quantum::Update(g_pclCurrent);
+#endif // #if KERNEL_ROUND_ROBIN
+
+    // Jump to the first thread.  This only returns if the kernel instance is
+    // shut down via ThreadPort_ExitKernel().
+    ThreadPort_SwapContext(&s_pwBootStack, *StackTopPointer(g_pclCurrent));
+#endif // #if KERNEL_SMP
+}
 } // namespace Mark3
+
+using namespace Mark3;
+
+//---------------------------------------------------------------------------
+void ThreadPort_ThreadEntry(ThreadEntryFunc pfEntry_, void* pvArg_)
+{
+    // Threads are always switched in with kernel signals masked (and in SMP
+    // mode, with the kernel lock held by the switch that started them)
+#if KERNEL_SMP
+    ThreadPort_UnlockKernel();
+#endif // #if KERNEL_SMP
+    PORT_IRQ_ENABLE();
+
+    pfEntry_(pvArg_);
+
+    // Returning from a thread entrypoint terminates the thread.
+    Scheduler::GetCurrentThread()->Exit();
+    while (true) {}
+}
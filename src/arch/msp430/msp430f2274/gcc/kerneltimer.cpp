@@ -45,8 +45,14 @@ void __attribute__((interrupt(TIMERA0_VECTOR))) isr_KernelTIMER(void)
     if (!Kernel::IsStarted()) {
         return;
     }
+#if KERNEL_TRACE
+    KernelTrace::IsrEnter(uTraceVectorTick);
+#endif // #if KERNEL_TRACE
     Kernel::Tick();
     s_clTimerSemaphore.Post();
+#if KERNEL_TRACE
+    KernelTrace::IsrExit(uTraceVectorTick);
+#endif // #if KERNEL_TRACE
 }
 
 namespace Mark3
@@ -112,4 +118,23 @@ void KernelTimer::Stop(void)
     TACCR0 = 0;
 }
 
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::GetCycleCount(void)
+{
+    // Use the kernel clock, which extends Timer A with the tick count.
+    return static_cast<uint32_t>(Kernel::GetClock());
+}
+
+//---------------------------------------------------------------------------
+uint32_t KernelTimer::GetTickOffset(void)
+{
+    // Timer A counts SMCLK up to TACCR0 once per tick.  A compare match whose
+    // interrupt hasn't been serviced yet has already started the next tick.
+    auto u32Offset = static_cast<uint32_t>(TAR);
+    if (0 != (TACCTL0 & CCIFG)) {
+        u32Offset = PORT_TIMER_FREQ + TAR;
+    }
+    return u32Offset;
+}
+
 } // namespace Mark3
@@ -55,14 +55,14 @@ namespace Mark3
     ASM("push    r14\n"); \
     ASM("push    r15\n"); \
     ASM("mov.w    &g_pclCurrent, r12\n"); \
-    ASM("add.w  #4, r12"); \
+    ASM("add.w  #" KERNEL_STRINGIFY(PORT_THREAD_STACK_TOP_OFFSET) ", r12"); \
     ASM("mov.w    r1, 0(r12)\n");
 
 //---------------------------------------------------------------------------
 //! Restore the context of the Thread
 #define Thread_RestoreContext()\
     ASM("mov.w  &g_pclCurrent, r12"); \
-    ASM("add.w  #4, r12"); \
+    ASM("add.w  #" KERNEL_STRINGIFY(PORT_THREAD_STACK_TOP_OFFSET) ", r12"); \
     ASM("mov.w  @r12, r1"); \
     ASM("pop    r15"); \
     ASM("pop    r14"); \
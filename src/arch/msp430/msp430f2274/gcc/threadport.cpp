@@ -51,11 +51,11 @@ void ThreadPort::InitStack(Thread* pclThread_)
     // Start by finding the bottom of the stack
     pu16Stack = (uint16_t*)pclThread_->m_pwStackTop;
 
-#if KERNEL_STACK_CHECK
+#if KERNEL_STACK_PAINT
     // clear the stack, and initialize it to a known-default value (easier
     // to debug when things go sour with stack corruption or overflow)
-    for (i = 0; i < pclThread_->m_u16StackSize / sizeof(uint16_t); i++) { pclThread_->m_pwStack[i] = 0xFFFF; }
-#endif // #if KERNEL_STACK_CHECK
+    for (i = 0; i < pclThread_->m_uStackSize / sizeof(uint16_t); i++) { pclThread_->m_pwStack[i] = 0xFFFF; }
+#endif // #if KERNEL_STACK_PAINT
 
     // 1st - push start address... (R0/PC)
     PORT_PUSH_TO_STACK(pu16Stack, u16Addr);
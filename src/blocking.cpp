@@ -35,6 +35,9 @@ void BlockingObject::Block(Thread* pclThread_)
     // Set the "current" list location to the blocklist for this thread
     pclThread_->SetCurrent(&m_clBlockList);
     pclThread_->SetState(ThreadState::Blocked);
+#if KERNEL_TRACE
+    KernelTrace::Record(TraceEvent::ThreadBlock, pclThread_, this);
+#endif // #if KERNEL_TRACE
 }
 
 //---------------------------------------------------------------------------
@@ -50,6 +53,9 @@ void BlockingObject::BlockPriority(Thread* pclThread_)
     // Set the "current" list location to the blocklist for this thread
     pclThread_->SetCurrent(&m_clBlockList);
     pclThread_->SetState(ThreadState::Blocked);
+#if KERNEL_TRACE
+    KernelTrace::Record(TraceEvent::ThreadBlock, pclThread_, this);
+#endif // #if KERNEL_TRACE
 }
 
 //---------------------------------------------------------------------------
@@ -67,5 +73,8 @@ void BlockingObject::UnBlock(Thread* pclThread_)
     // Tag the thread's current list location to its owner
     pclThread_->SetCurrent(pclThread_->GetOwner());
     pclThread_->SetState(ThreadState::Ready);
+#if KERNEL_TRACE
+    KernelTrace::Record(TraceEvent::ThreadUnblock, pclThread_, this);
+#endif // #if KERNEL_TRACE
 }
 } // namespace Mark3
@@ -0,0 +1,137 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   budget.cpp
+
+    @brief  Per-thread CPU budget enforcement
+*/
+
+#include "mark3.h"
+
+#if KERNEL_BUDGET
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+KERNEL_INSTANCE_STATE Thread* Budget::m_apclActiveThread[KERNEL_NUM_CORES];
+KERNEL_INSTANCE_STATE Thread* Budget::m_pclTimerThread;
+
+//---------------------------------------------------------------------------
+void Budget::Update(Thread* pclThread_)
+{
+    // Time spent in the timer thread is charged to whichever thread it
+    // preempted, as with round-robin quanta.
+    if (pclThread_ != m_pclTimerThread) {
+        m_apclActiveThread[Scheduler::GetCurrentCore()] = pclThread_;
+    }
+}
+
+//---------------------------------------------------------------------------
+void Budget::Charge(uint32_t u32Ticks_)
+{
+    const auto cs = CriticalGuard{};
+
+    // Always called from the timer thread
+    m_pclTimerThread = g_pclCurrent;
+
+    for (auto u8Core = uint8_t { 0 }; u8Core < KERNEL_NUM_CORES; u8Core++) {
+        auto* pclThread = m_apclActiveThread[u8Core];
+        if ((nullptr == pclThread) || (0 == pclThread->m_u32Budget) || pclThread->m_bBudgetExhausted) {
+            continue;
+        }
+        if (pclThread->m_u32BudgetRemain > u32Ticks_) {
+            pclThread->m_u32BudgetRemain -= u32Ticks_;
+            continue;
+        }
+
+        // Out of budget - demote until the next replenishment
+        pclThread->m_u32BudgetRemain  = 0;
+        pclThread->m_bBudgetExhausted = true;
+        pclThread->m_uXBudgetPriority = pclThread->m_uXPriority;
+        Move(pclThread, pclThread->m_uXExhaustedPriority);
+    }
+}
+
+//---------------------------------------------------------------------------
+void Budget::Configure(Thread*        pclThread_,
+                       uint32_t       u32BudgetMs_,
+                       uint32_t       u32PeriodMs_,
+                       PORT_PRIO_TYPE uXExhaustedPriority_)
+{
+    KERNEL_ASSERT(nullptr != pclThread_);
+    KERNEL_ASSERT((0 == u32BudgetMs_) || ((u32BudgetMs_ <= u32PeriodMs_) && (0 != u32PeriodMs_)));
+    KERNEL_ASSERT(uXExhaustedPriority_ < KERNEL_NUM_PRIORITIES);
+
+    pclThread_->m_clBudgetTimer.Stop();
+
+    { // Begin critical section
+        const auto cs = CriticalGuard{};
+        if (pclThread_->m_bBudgetExhausted) {
+            pclThread_->m_bBudgetExhausted = false;
+            Move(pclThread_, pclThread_->m_uXBudgetPriority);
+        }
+        pclThread_->m_u32Budget           = u32BudgetMs_;
+        pclThread_->m_u32BudgetRemain     = u32BudgetMs_;
+        pclThread_->m_uXExhaustedPriority = uXExhaustedPriority_;
+    } // End critical section
+
+    if (0 != u32BudgetMs_) {
+        pclThread_->m_clBudgetTimer.Start(true, u32PeriodMs_, Replenish, pclThread_);
+    }
+}
+
+//---------------------------------------------------------------------------
+void Budget::Replenish(Thread* /*pclOwner_*/, void* pvData_)
+{
+    auto* pclThread = static_cast<Thread*>(pvData_);
+
+    const auto cs = CriticalGuard{};
+    pclThread->m_u32BudgetRemain = pclThread->m_u32Budget;
+    if (pclThread->m_bBudgetExhausted) {
+        pclThread->m_bBudgetExhausted = false;
+        Move(pclThread, pclThread->m_uXBudgetPriority);
+    }
+}
+
+//---------------------------------------------------------------------------
+void Budget::Move(Thread* pclThread_, PORT_PRIO_TYPE uXPriority_)
+{
+    auto u8Core = pclThread_->GetCore();
+    if (ThreadState::Ready == pclThread_->m_eState) {
+        Scheduler::Remove(pclThread_);
+        pclThread_->m_uXPriority    = uXPriority_;
+        pclThread_->m_uXCurPriority = uXPriority_;
+        Scheduler::Add(pclThread_);
+        pclThread_->m_pclOwner   = Scheduler::GetThreadList(uXPriority_, u8Core, pclThread_->GetPartition());
+        pclThread_->m_pclCurrent = pclThread_->m_pclOwner;
+    } else {
+        // Blocked threads return to the ready list of their new priority
+        // when woken; stopped threads pick it up when started.
+        pclThread_->m_uXPriority    = uXPriority_;
+        pclThread_->m_uXCurPriority = uXPriority_;
+        if (ThreadState::Blocked == pclThread_->m_eState) {
+            pclThread_->m_pclOwner = Scheduler::GetThreadList(uXPriority_, u8Core, pclThread_->GetPartition());
+        }
+    }
+
+    // The calling (timer) thread reschedules when it blocks again, but a
+    // thread running on another core must be told to reschedule now.
+#if KERNEL_SMP
+    if (u8Core != Scheduler::GetCurrentCore()) {
+        ThreadPort::SendIpi(u8Core);
+    }
+#endif // #if KERNEL_SMP
+}
+} // namespace Mark3
+#endif // #if KERNEL_BUDGET
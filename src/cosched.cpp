@@ -21,9 +21,9 @@ See license.txt for more information
 #include "criticalguard.h"
 
 namespace Mark3 {
-CoList CoScheduler::m_aclPriorities[PORT_COROUTINE_PRIORITIES];
-CoList CoScheduler::m_clStopList;
-CoPrioMap CoScheduler::m_clPrioMap;
+KERNEL_INSTANCE_STATE CoList CoScheduler::m_aclPriorities[PORT_COROUTINE_PRIORITIES];
+KERNEL_INSTANCE_STATE CoList CoScheduler::m_clStopList;
+KERNEL_INSTANCE_STATE CoPrioMap CoScheduler::m_clPrioMap;
 
 //---------------------------------------------------------------------------
 void CoScheduler::Init()
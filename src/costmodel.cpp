@@ -0,0 +1,82 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   costmodel.cpp
+
+    @brief  Target cycle-cost estimation for host runs
+*/
+
+#include "mark3.h"
+
+#if KERNEL_COST_MODEL
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+// Cycle estimates per event, in CostEvent order:
+// context switch, schedule, list add, list remove, timer node, mailbox copy, mailbox byte,
+// semaphore op, mutex op, timer add, timer remove.
+//
+// The context switch figures cover the port's save/restore sequence plus
+// exception entry/exit (PendSV on Cortex-M); the remaining figures are the
+// instruction counts of the generic kernel code for each architecture, with
+// the priority-map lookup using CLZ on Cortex-M3/M4F and a software search
+// elsewhere.  The semaphore and mutex figures are the uncontended paths
+// (critical section or scheduler lock, plus the count/owner update); blocking
+// and waking are charged separately through the thread list events.
+const CostTable CostModel::clAVR       = { "avr", { 220, 140, 95, 85, 110, 24, 9, 60, 80, 70, 60 } };
+const CostTable CostModel::clMSP430    = { "msp430", { 150, 95, 60, 55, 70, 18, 7, 40, 55, 45, 40 } };
+const CostTable CostModel::clCortexM0  = { "cm0", { 95, 70, 45, 40, 50, 14, 6, 30, 40, 35, 30 } };
+const CostTable CostModel::clCortexM3  = { "cm3", { 60, 35, 32, 28, 36, 10, 4, 22, 30, 26, 22 } };
+const CostTable CostModel::clCortexM4F = { "cm4f", { 70, 35, 32, 28, 36, 10, 4, 22, 30, 26, 22 } };
+
+KERNEL_INSTANCE_STATE const CostTable* CostModel::m_pclTable;
+KERNEL_INSTANCE_STATE uint64_t         CostModel::m_u64Cycles;
+KERNEL_INSTANCE_STATE uint32_t         CostModel::m_au32Count[CostModel::m_uNumEvents];
+KERNEL_INSTANCE_STATE uint64_t         CostModel::m_au64Cycles[CostModel::m_uNumEvents];
+
+//---------------------------------------------------------------------------
+void CostModel::Init()
+{
+    m_pclTable  = &clCortexM3;
+    m_u64Cycles = 0;
+    for (uint8_t i = 0; i < m_uNumEvents; i++) {
+        m_au32Count[i]  = 0;
+        m_au64Cycles[i] = 0;
+    }
+}
+
+//---------------------------------------------------------------------------
+void CostModel::SetTarget(const CostTable* pclTable_)
+{
+    KERNEL_ASSERT(nullptr != pclTable_);
+    m_pclTable = pclTable_;
+}
+
+//---------------------------------------------------------------------------
+void CostModel::Charge(CostEvent eEvent_, uint16_t u16Count_)
+{
+    auto u8Event = static_cast<uint8_t>(eEvent_);
+    auto u32Cost = static_cast<uint32_t>(m_pclTable->au16Cycles[u8Event]) * u16Count_;
+
+    const auto cs = CriticalGuard{};
+    m_u64Cycles += u32Cost;
+    m_au32Count[u8Event] += u16Count_;
+    m_au64Cycles[u8Event] += u32Cost;
+    if (nullptr != g_pclCurrent) {
+        g_pclCurrent->m_u64EstCycles += u32Cost;
+    }
+}
+} // namespace Mark3
+#endif // #if KERNEL_COST_MODEL
@@ -0,0 +1,119 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   deadlineheap.cpp
+
+    @brief  Deadline-ordered heap of threads, used for EDF scheduling
+*/
+
+#include "mark3.h"
+
+#if KERNEL_EDF
+namespace Mark3
+{
+namespace
+{
+    //---------------------------------------------------------------------------
+    // Wraparound-safe comparison of absolute deadlines
+    bool DeadlineHeap_IsEarlier(uint32_t u32A_, uint32_t u32B_)
+    {
+        return static_cast<int32_t>(u32A_ - u32B_) < 0;
+    }
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+void DeadlineHeap::Add(Thread* pclThread_, uint32_t u32Deadline_)
+{
+    KERNEL_ASSERT(nullptr != pclThread_);
+    if (m_u16Count >= m_uMaxThreads) {
+        // The panic handler may return; don't write past the end of the heap.
+        Kernel::Panic(PANIC_EDF_HEAP_FULL);
+        return;
+    }
+
+    pclThread_->m_u32AbsDeadline = u32Deadline_;
+    Place(m_u16Count, pclThread_);
+    SiftUp(m_u16Count++);
+}
+
+//---------------------------------------------------------------------------
+void DeadlineHeap::Remove(Thread* pclThread_)
+{
+    KERNEL_ASSERT(nullptr != pclThread_);
+
+    auto u16Index = pclThread_->m_u16HeapIndex;
+    if ((u16Index >= m_u16Count) || (m_apclHeap[u16Index] != pclThread_)) {
+        return;
+    }
+
+    // Fill the hole with the last thread in the heap, then restore the heap
+    // property in whichever direction it was broken.
+    m_u16Count--;
+    if (u16Index != m_u16Count) {
+        auto* pclLast = m_apclHeap[m_u16Count];
+        Place(u16Index, pclLast);
+        SiftUp(u16Index);
+        SiftDown(pclLast->m_u16HeapIndex);
+    }
+}
+
+//---------------------------------------------------------------------------
+void DeadlineHeap::Place(uint16_t u16Index_, Thread* pclThread_)
+{
+    m_apclHeap[u16Index_]      = pclThread_;
+    pclThread_->m_u16HeapIndex = u16Index_;
+}
+
+//---------------------------------------------------------------------------
+void DeadlineHeap::SiftUp(uint16_t u16Index_)
+{
+    auto* pclThread = m_apclHeap[u16Index_];
+    while (0 != u16Index_) {
+        auto  u16Parent = static_cast<uint16_t>((u16Index_ - 1) / 2);
+        auto* pclParent = m_apclHeap[u16Parent];
+        if (!DeadlineHeap_IsEarlier(pclThread->m_u32AbsDeadline, pclParent->m_u32AbsDeadline)) {
+            break;
+        }
+        Place(u16Index_, pclParent);
+        u16Index_ = u16Parent;
+    }
+    Place(u16Index_, pclThread);
+}
+
+//---------------------------------------------------------------------------
+void DeadlineHeap::SiftDown(uint16_t u16Index_)
+{
+    auto* pclThread = m_apclHeap[u16Index_];
+    while (true) {
+        auto u16Child = static_cast<uint16_t>((u16Index_ * 2) + 1);
+        if (u16Child >= m_u16Count) {
+            break;
+        }
+        // Pick the child with the earlier deadline
+        if (((u16Child + 1) < m_u16Count)
+            && DeadlineHeap_IsEarlier(m_apclHeap[u16Child + 1]->m_u32AbsDeadline,
+                                      m_apclHeap[u16Child]->m_u32AbsDeadline)) {
+            u16Child++;
+        }
+        if (!DeadlineHeap_IsEarlier(m_apclHeap[u16Child]->m_u32AbsDeadline, pclThread->m_u32AbsDeadline)) {
+            break;
+        }
+        Place(u16Index_, m_apclHeap[u16Child]);
+        u16Index_ = u16Child;
+    }
+    Place(u16Index_, pclThread);
+}
+} // namespace Mark3
+#endif // #if KERNEL_EDF
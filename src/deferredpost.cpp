@@ -0,0 +1,115 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   deferredpost.cpp
+
+    @brief  Deferred posting of kernel objects from interrupts
+*/
+
+#include "mark3.h"
+
+#if KERNEL_DEFERRED_POST
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+KERNEL_INSTANCE_STATE DeferredPost::Request DeferredPost::m_astQueue[DeferredPost::m_u8Depth];
+KERNEL_INSTANCE_STATE uint8_t               DeferredPost::m_u8Head;
+KERNEL_INSTANCE_STATE uint8_t               DeferredPost::m_u8Count;
+KERNEL_INSTANCE_STATE bool                  DeferredPost::m_abDraining[KERNEL_NUM_CORES];
+
+//---------------------------------------------------------------------------
+bool DeferredPost::Push(DeferredOp eOp_, void* pvObject_, uint16_t u16Arg_)
+{
+    KERNEL_ASSERT(nullptr != pvObject_);
+
+    const auto cs = CriticalGuard{};
+    if (m_u8Count == m_u8Depth) {
+        return false;
+    }
+
+    auto u8Tail = static_cast<uint8_t>(m_u8Head + m_u8Count);
+    if (u8Tail >= m_u8Depth) {
+        u8Tail -= m_u8Depth;
+    }
+    m_astQueue[u8Tail].pvObject = pvObject_;
+    m_astQueue[u8Tail].u16Arg   = u16Arg_;
+    m_astQueue[u8Tail].eOp      = eOp_;
+    m_u8Count++;
+    return true;
+}
+
+//---------------------------------------------------------------------------
+void DeferredPost::Commit()
+{
+    if (IsPending()) {
+        Thread::Yield();
+    }
+}
+
+//---------------------------------------------------------------------------
+void DeferredPost::Drain()
+{
+    auto u8Core = Scheduler::GetCurrentCore();
+    if (!IsPending() || !Scheduler::IsEnabled() || m_abDraining[u8Core]) {
+        return;
+    }
+
+    // Thread switches requested by each operation are left to the caller,
+    // which schedules once the whole batch is done.
+    auto stRequest       = Request {};
+    m_abDraining[u8Core] = true;
+    while (Pop(&stRequest)) {
+        switch (stRequest.eOp) {
+            case DeferredOp::SemaphorePost: {
+                static_cast<Semaphore*>(stRequest.pvObject)->Post();
+            } break;
+            case DeferredOp::NotifySignal: {
+                static_cast<Notify*>(stRequest.pvObject)->Signal();
+            } break;
+#if KERNEL_EVENT_FLAGS
+            case DeferredOp::EventFlagSet: {
+                static_cast<EventFlag*>(stRequest.pvObject)->Set(stRequest.u16Arg);
+            } break;
+#endif // #if KERNEL_EVENT_FLAGS
+            default: break;
+        }
+    }
+    m_abDraining[u8Core] = false;
+}
+
+//---------------------------------------------------------------------------
+bool DeferredPost::IsDraining()
+{
+    return m_abDraining[Scheduler::GetCurrentCore()];
+}
+
+//---------------------------------------------------------------------------
+bool DeferredPost::Pop(Request* pstRequest_)
+{
+    const auto cs = CriticalGuard{};
+    if (0 == m_u8Count) {
+        return false;
+    }
+
+    *pstRequest_ = m_astQueue[m_u8Head];
+    m_u8Head++;
+    if (m_u8Head == m_u8Depth) {
+        m_u8Head = 0;
+    }
+    m_u8Count--;
+    return true;
+}
+} // namespace Mark3
+#endif // #if KERNEL_DEFERRED_POST
@@ -46,7 +46,7 @@ namespace
         pclOwner_->SetEventFlagMask(0);
 
         pclEventFlag->WakeMe(pclOwner_);
-        if (pclOwner_->GetCurPriority() >= Scheduler::GetCurrentThread()->GetCurPriority()) {
+        if (Scheduler::WillPreempt(pclOwner_)) {
             Thread::Yield();
         }
     }
@@ -281,6 +281,15 @@ void EventFlag::Set(uint16_t u16Mask_)
     m_u16SetMask = u16NewMask;
 }
 
+#if KERNEL_DEFERRED_POST
+//---------------------------------------------------------------------------
+bool EventFlag::SetFromIsr(uint16_t u16Mask_)
+{
+    KERNEL_ASSERT(IsInitialized());
+    return DeferredPost::Push(DeferredOp::EventFlagSet, this, u16Mask_);
+}
+#endif // #if KERNEL_DEFERRED_POST
+
 //---------------------------------------------------------------------------
 void EventFlag::Clear(uint16_t u16Mask_)
 {
@@ -0,0 +1,175 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   hirestimer.cpp
+
+    @brief  Microsecond-resolution timers, driven by a hardware compare channel
+*/
+
+#include "mark3.h"
+
+#if KERNEL_HIRES_TIMERS
+namespace Mark3
+{
+KERNEL_INSTANCE_STATE TypedDoubleLinkList<HiResTimer> HiResTimer::m_clQueue;
+
+//---------------------------------------------------------------------------
+HiResTimer::HiResTimer()
+{
+    m_u8Initialized = m_uTimerInvalidCookie;
+    m_u8Flags       = 0;
+}
+
+//---------------------------------------------------------------------------
+void HiResTimer::Init()
+{
+    if (m_uTimerInitCookie == m_u8Initialized) {
+        KERNEL_ASSERT((m_u8Flags & uTimerFlagActive) == 0);
+    }
+
+    ClearNode();
+    m_u64Interval = 0;
+    m_u64Expiry   = 0;
+    m_u8Flags     = 0;
+
+    m_u8Initialized = m_uTimerInitCookie;
+}
+
+//---------------------------------------------------------------------------
+void HiResTimer::Start(bool bRepeat_, uint32_t u32IntervalUs_, TimerCallback pfCallback_, void* pvData_)
+{
+    KERNEL_ASSERT(m_uTimerInitCookie == m_u8Initialized);
+
+    if ((m_u8Flags & uTimerFlagActive) != 0) {
+        return;
+    }
+
+    m_u64Interval = USecondsToCycles(u32IntervalUs_);
+    m_pfCallback  = pfCallback_;
+    m_pvData      = pvData_;
+
+    if (!bRepeat_) {
+        m_u8Flags = uTimerFlagOneShot;
+    } else {
+        m_u8Flags = 0;
+    }
+
+    Start();
+}
+
+//---------------------------------------------------------------------------
+void HiResTimer::Start()
+{
+    KERNEL_ASSERT(m_uTimerInitCookie == m_u8Initialized);
+    KERNEL_ASSERT(Kernel::IsStarted());
+
+    const auto cs = CriticalGuard {};
+    if ((m_u8Flags & uTimerFlagActive) != 0) {
+        return;
+    }
+
+    m_pclOwner  = Scheduler::GetCurrentThread();
+    m_u64Expiry = Kernel::GetClock() + m_u64Interval;
+    m_u8Flags   = (m_u8Flags & ~uTimerFlagExpired) | uTimerFlagActive;
+    Insert(this);
+
+    // The compare is programmed for the head of the queue, so only a new head
+    // needs it re-armed.
+    if (m_clQueue.GetHead() == this) {
+        Process();
+    }
+}
+
+//---------------------------------------------------------------------------
+void HiResTimer::Stop()
+{
+    KERNEL_ASSERT(m_uTimerInitCookie == m_u8Initialized);
+
+    // If this was the head of the queue, the compare is left armed for it;
+    // the resulting interrupt finds nothing due, and re-arms for the next.
+    const auto cs = CriticalGuard {};
+    if ((m_u8Flags & uTimerFlagActive) == 0) {
+        return;
+    }
+    m_clQueue.Remove(this);
+    m_u8Flags &= ~uTimerFlagActive;
+}
+
+//---------------------------------------------------------------------------
+void HiResTimer::Process()
+{
+    const auto cs = CriticalGuard {};
+
+    auto* pclCurr = m_clQueue.GetHead();
+    while (nullptr != pclCurr) {
+        auto u64Now = Kernel::GetClock();
+        if (pclCurr->m_u64Expiry > u64Now) {
+            // Not due yet.  If the expiry passes before the compare can be
+            // armed, go around again to expire it here instead.
+            if (KernelTimer::SetCompare(pclCurr->m_u64Expiry)) {
+                return;
+            }
+            continue;
+        }
+
+        // Requeue the timer before running its callback, so that the callback
+        // can stop it, or restart it if it's a one-shot.
+        m_clQueue.Remove(pclCurr);
+        if ((pclCurr->m_u8Flags & uTimerFlagOneShot) != 0) {
+            pclCurr->m_u8Flags |= uTimerFlagExpired;
+            pclCurr->m_u8Flags &= ~uTimerFlagActive;
+        } else {
+            // Reload from the previous expiry, rather than from now, so the
+            // period doesn't drift.  Skip any expiries missed entirely.
+            auto u64Interval = pclCurr->m_u64Interval;
+            pclCurr->m_u64Expiry += u64Interval;
+            if (pclCurr->m_u64Expiry <= u64Now) {
+                pclCurr->m_u64Expiry += (((u64Now - pclCurr->m_u64Expiry) / u64Interval) + 1) * u64Interval;
+            }
+            Insert(pclCurr);
+        }
+
+#if KERNEL_TRACE
+        KernelTrace::Record(TraceEvent::TimerExpiry, pclCurr->m_pclOwner, pclCurr);
+#endif // #if KERNEL_TRACE
+        if (nullptr != pclCurr->m_pfCallback) {
+            pclCurr->m_pfCallback(pclCurr->m_pclOwner, pclCurr->m_pvData);
+        }
+        pclCurr = m_clQueue.GetHead();
+    }
+    KernelTimer::ClearCompare();
+}
+
+//---------------------------------------------------------------------------
+uint64_t HiResTimer::USecondsToCycles(uint32_t u32Us_)
+{
+    auto u64Cycles = ((static_cast<uint64_t>(u32Us_) * PORT_TIMER_FREQ) + 999) / 1000;
+    return (0 != u64Cycles) ? u64Cycles : 1;
+}
+
+//---------------------------------------------------------------------------
+void HiResTimer::Insert(HiResTimer* pclTimer_)
+{
+    // Walk back from the tail: periodic timers are requeued behind the
+    // timers they just expired with, so the insertion point is usually near
+    // the end of the queue.
+    auto* pclCurr = m_clQueue.GetTail();
+    while ((nullptr != pclCurr) && (pclCurr->m_u64Expiry > pclTimer_->m_u64Expiry)) {
+        pclCurr = pclCurr->GetPrev();
+    }
+    m_clQueue.InsertNodeBefore(pclTimer_, (nullptr != pclCurr) ? pclCurr->GetNext() : m_clQueue.GetHead());
+}
+} // namespace Mark3
+#endif // #if KERNEL_HIRES_TIMERS
@@ -21,28 +21,35 @@ See license.txt for more information
 #include "mark3.h"
 namespace Mark3
 {
-bool      Kernel::m_bIsStarted; //!< true if kernel is running, false otherwise
-bool      Kernel::m_bIsPanic;   //!< true if kernel is in panic state, false otherwise
-PanicFunc Kernel::m_pfPanic;    //!< set panic function
+KERNEL_INSTANCE_STATE bool      Kernel::m_bIsStarted; //!< true if kernel is running, false otherwise
+KERNEL_INSTANCE_STATE bool      Kernel::m_bIsPanic;   //!< true if kernel is in panic state, false otherwise
+KERNEL_INSTANCE_STATE PanicFunc Kernel::m_pfPanic;    //!< set panic function
 
 #if KERNEL_THREAD_CREATE_CALLOUT
-ThreadCreateCallout Kernel::m_pfThreadCreateCallout; //!< Function to call on thread creation
+KERNEL_INSTANCE_STATE ThreadCreateCallout Kernel::m_pfThreadCreateCallout; //!< Function to call on thread creation
 #endif                                               // #if KERNEL_THREAD_CREATE_CALLOUT
 #if KERNEL_THREAD_EXIT_CALLOUT
-ThreadExitCallout Kernel::m_pfThreadExitCallout; //!< Function to call on thread exit
+KERNEL_INSTANCE_STATE ThreadExitCallout Kernel::m_pfThreadExitCallout; //!< Function to call on thread exit
 #endif                                           // #if KERNEL_THREAD_EXIT_CALLOUT
 #if KERNEL_CONTEXT_SWITCH_CALLOUT
-ThreadContextCallout Kernel::m_pfThreadContextCallout; //!< Function to call on context switch
+KERNEL_INSTANCE_STATE ThreadContextCallout Kernel::m_pfThreadContextCallout; //!< Function to call on context switch
 #endif                                                 // #if KERNEL_CONTEXT_SWITCH_CALLOUT
-DebugPrintFunction Kernel::m_pfDebugPrintFunction;     //!< Function to call when printing debug info
+KERNEL_INSTANCE_STATE DebugPrintFunction Kernel::m_pfDebugPrintFunction;     //!< Function to call when printing debug info
 #if KERNEL_STACK_CHECK
-uint16_t Kernel::m_u16GuardThreshold;
+KERNEL_INSTANCE_STATE uint16_t Kernel::m_u16GuardThreshold;
 #endif // #if KERNEL_STACK_CHECK
-uint32_t Kernel::m_u32Ticks;
+KERNEL_INSTANCE_STATE uint64_t Kernel::m_au64Ticks[2];
+KERNEL_INSTANCE_STATE K_WORD   Kernel::m_kwTickSeq;
 
 //---------------------------------------------------------------------------
 void Kernel::Init()
 {
+#if KERNEL_COST_MODEL
+    CostModel::Init();
+#endif // #if KERNEL_COST_MODEL
+#if KERNEL_TRACE
+    KernelTrace::Init();
+#endif // #if KERNEL_TRACE
     // Call port-specific early init function
     ThreadPort::Init();
     AutoAlloc::Init();
@@ -57,6 +64,9 @@ void Kernel::Init()
 //---------------------------------------------------------------------------
 void Kernel::Start()
 {
+#if KERNEL_RUN_TIME
+    RunTime::Start();
+#endif // #if KERNEL_RUN_TIME
     ThreadPort::StartThreads();
 }
 
@@ -87,10 +97,56 @@ void Kernel::DebugPrint(const char* szString_)
 }
 
 //---------------------------------------------------------------------------
-uint32_t Kernel::GetTicks()
+void Kernel::Tick(uint32_t u32Ticks_)
 {
-    auto cs = CriticalGuard{};
-    return m_u32Ticks;
+    // Readers never see the copy being written, so a reader interrupting
+    // this function (e.g. from a higher-priority interrupt) still gets a
+    // consistent count.  Readers interrupted by it see the sequence change,
+    // and read again.
+    auto kwSeq = m_kwTickSeq;
+
+    m_au64Ticks[(kwSeq + 1) & 1] = m_au64Ticks[kwSeq & 1] + u32Ticks_;
+    __atomic_store_n(&m_kwTickSeq, static_cast<K_WORD>(kwSeq + 1), __ATOMIC_RELEASE);
+}
+
+//---------------------------------------------------------------------------
+uint64_t Kernel::GetTicks64()
+{
+    if (m_bTickSeqLocked) {
+        const auto cs = CriticalGuard{};
+        return m_au64Ticks[m_kwTickSeq & 1];
+    }
+
+    auto u64Ticks = uint64_t {};
+    auto kwSeq    = K_WORD {};
+    do {
+        kwSeq    = __atomic_load_n(&m_kwTickSeq, __ATOMIC_ACQUIRE);
+        u64Ticks = m_au64Ticks[kwSeq & 1];
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (kwSeq != __atomic_load_n(&m_kwTickSeq, __ATOMIC_RELAXED));
+    return u64Ticks;
+}
+
+//---------------------------------------------------------------------------
+uint64_t Kernel::GetClock()
+{
+    if (m_bTickSeqLocked) {
+        const auto cs = CriticalGuard{};
+        return (m_au64Ticks[m_kwTickSeq & 1] * PORT_TIMER_FREQ) + KernelTimer::GetTickOffset();
+    }
+
+    // The timer is read inside the same loop, so that a tick counted between
+    // reading the count and the timer is caught and the read retried.
+    auto u64Ticks  = uint64_t {};
+    auto u32Offset = uint32_t {};
+    auto kwSeq     = K_WORD {};
+    do {
+        kwSeq     = __atomic_load_n(&m_kwTickSeq, __ATOMIC_ACQUIRE);
+        u64Ticks  = m_au64Ticks[kwSeq & 1];
+        u32Offset = KernelTimer::GetTickOffset();
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (kwSeq != __atomic_load_n(&m_kwTickSeq, __ATOMIC_RELAXED));
+    return (u64Ticks * PORT_TIMER_FREQ) + u32Offset;
 }
 
 } // namespace Mark3
@@ -0,0 +1,155 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   kerneltrace.cpp
+
+    @brief  Binary kernel event tracer
+*/
+
+#include "mark3.h"
+
+#if KERNEL_TRACE
+namespace Mark3
+{
+namespace
+{
+    //---------------------------------------------------------------------------
+    // Time source for trace records - the same as used by ProfileTimer
+    uint32_t KernelTrace_Now()
+    {
+#if KERNEL_COST_MODEL
+        return static_cast<uint32_t>(CostModel::GetCycles());
+#else
+        return KernelTimer::GetCycleCount();
+#endif // #if KERNEL_COST_MODEL
+    }
+
+    //---------------------------------------------------------------------------
+    uint32_t KernelTrace_Address(const void* pv_)
+    {
+        return static_cast<uint32_t>(reinterpret_cast<K_ADDR>(pv_));
+    }
+} // anonymous namespace
+
+KERNEL_INSTANCE_STATE TraceRecord KernelTrace::m_astRecords[KernelTrace::m_uNumRecords];
+KERNEL_INSTANCE_STATE uint16_t    KernelTrace::m_u16Head;
+KERNEL_INSTANCE_STATE uint16_t    KernelTrace::m_u16Count;
+KERNEL_INSTANCE_STATE uint32_t    KernelTrace::m_u32Lost;
+KERNEL_INSTANCE_STATE bool        KernelTrace::m_bEnabled;
+
+//---------------------------------------------------------------------------
+void KernelTrace::Init()
+{
+    m_u16Head  = 0;
+    m_u16Count = 0;
+    m_u32Lost  = 0;
+    m_bEnabled = true;
+}
+
+//---------------------------------------------------------------------------
+void KernelTrace::Record(TraceEvent eEvent_, const void* pvThread_, const void* pvObject_, uint16_t u16Arg_)
+{
+    const auto cs = CriticalGuard{};
+    if (!m_bEnabled) {
+        return;
+    }
+
+    auto u16Index = static_cast<uint16_t>(m_u16Head + m_u16Count);
+    if (u16Index >= m_uNumRecords) {
+        u16Index -= m_uNumRecords;
+    }
+
+    // Full - overwrite the oldest record
+    if (m_u16Count == m_uNumRecords) {
+        m_u16Head = ((m_u16Head + 1) == m_uNumRecords) ? 0 : (m_u16Head + 1);
+        m_u32Lost++;
+    } else {
+        m_u16Count++;
+    }
+
+    auto* pstRecord         = &m_astRecords[u16Index];
+    pstRecord->u32Timestamp = KernelTrace_Now();
+    pstRecord->u32Thread    = KernelTrace_Address(pvThread_);
+    pstRecord->u32Object    = KernelTrace_Address(pvObject_);
+    pstRecord->u8Event      = static_cast<uint8_t>(eEvent_);
+    pstRecord->u8Core       = Scheduler::GetCurrentCore();
+    pstRecord->u16Arg       = u16Arg_;
+}
+
+//---------------------------------------------------------------------------
+void KernelTrace::IsrEnter(uint16_t u16Vector_)
+{
+    Record(TraceEvent::IsrEnter, g_pclCurrent, nullptr, u16Vector_);
+}
+
+//---------------------------------------------------------------------------
+void KernelTrace::IsrExit(uint16_t u16Vector_)
+{
+    Record(TraceEvent::IsrExit, g_pclCurrent, nullptr, u16Vector_);
+}
+
+//---------------------------------------------------------------------------
+uint16_t KernelTrace::Read(TraceRecord* pstRecords_, uint16_t u16Max_)
+{
+    KERNEL_ASSERT(nullptr != pstRecords_);
+
+    const auto cs = CriticalGuard{};
+    auto u16Read  = uint16_t { 0 };
+    while ((u16Read < u16Max_) && (0u != m_u16Count)) {
+        pstRecords_[u16Read++] = m_astRecords[m_u16Head];
+        m_u16Head              = ((m_u16Head + 1) == m_uNumRecords) ? 0 : (m_u16Head + 1);
+        m_u16Count--;
+    }
+    return u16Read;
+}
+
+//---------------------------------------------------------------------------
+void KernelTrace::Dump(TraceWriteFunc pfWrite_, void* pvContext_)
+{
+    KERNEL_ASSERT(nullptr != pfWrite_);
+
+    // Records are written straight out of the ring buffer, so stop recording
+    // until the dump is complete.
+    auto bEnabled = false;
+    { // Begin critical section
+        const auto cs = CriticalGuard{};
+        bEnabled      = m_bEnabled;
+        m_bEnabled    = false;
+    } // End critical section
+
+    auto stHeader               = TraceHeader {};
+    stHeader.u32Magic           = TraceHeader::uMagic;
+    stHeader.u16Version         = TraceHeader::uVersion;
+    stHeader.u16RecordSize      = sizeof(TraceRecord);
+    stHeader.u32CyclesPerSecond = PORT_SYSTEM_FREQ;
+    stHeader.u32Records         = m_u16Count;
+    stHeader.u32Lost            = m_u32Lost;
+    pfWrite_(&stHeader, sizeof(stHeader), pvContext_);
+
+    // Oldest records first
+    auto u16Index = m_u16Head;
+    for (uint16_t i = 0; i < m_u16Count; i++) {
+        pfWrite_(&m_astRecords[u16Index], sizeof(TraceRecord), pvContext_);
+        u16Index = ((u16Index + 1) == m_uNumRecords) ? 0 : (u16Index + 1);
+    }
+
+    const auto cs = CriticalGuard{};
+    m_u16Head     = 0;
+    m_u16Count    = 0;
+    m_u32Lost     = 0;
+    m_bEnabled    = bEnabled;
+}
+} // namespace Mark3
+#endif // #if KERNEL_TRACE
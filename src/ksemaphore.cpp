@@ -48,7 +48,7 @@ namespace
         // Wake up the thread that was blocked on this semaphore.
         pclSemaphore->WakeMe(pclOwner_);
 
-        if (pclOwner_->GetCurPriority() >= Scheduler::GetCurrentThread()->GetCurPriority()) {
+        if (Scheduler::WillPreempt(pclOwner_)) {
             Thread::Yield();
         }
     }
@@ -84,7 +84,7 @@ uint8_t Semaphore::WakeNext()
     UnBlock(pclChosenOne);
 
     // Call a task switch if higher or equal priority thread
-    if (pclChosenOne->GetCurPriority() >= Scheduler::GetCurrentThread()->GetCurPriority()) {
+    if (Scheduler::WillPreempt(pclChosenOne)) {
         return 1;
     }
     return 0;
@@ -94,6 +94,9 @@ uint8_t Semaphore::WakeNext()
 void Semaphore::Init(uint16_t u16InitVal_, uint16_t u16MaxVal_)
 {
     KERNEL_ASSERT(!m_clBlockList.GetHead());
+#if KERNEL_COST_MODEL
+    CostModel::Charge(CostEvent::SemaphoreOp);
+#endif // #if KERNEL_COST_MODEL
 
     // Copy the paramters into the object - set the maximum value for this
     // semaphore to implement either binary or counting semaphores, and set
@@ -108,6 +111,12 @@ void Semaphore::Init(uint16_t u16InitVal_, uint16_t u16MaxVal_)
 bool Semaphore::Post()
 {
     KERNEL_ASSERT(IsInitialized());
+#if KERNEL_TRACE
+    KernelTrace::Record(TraceEvent::SemaphorePost, g_pclCurrent, this);
+#endif // #if KERNEL_TRACE
+#if KERNEL_COST_MODEL
+    CostModel::Charge(CostEvent::SemaphoreOp);
+#endif // #if KERNEL_COST_MODEL
 
     auto bThreadWake = false;
     auto bBail       = false;
@@ -148,10 +157,25 @@ bool Semaphore::Post()
     return true;
 }
 
+#if KERNEL_DEFERRED_POST
+//---------------------------------------------------------------------------
+bool Semaphore::PostFromIsr()
+{
+    KERNEL_ASSERT(IsInitialized());
+    return DeferredPost::Push(DeferredOp::SemaphorePost, this, 0);
+}
+#endif // #if KERNEL_DEFERRED_POST
+
 //---------------------------------------------------------------------------
 bool Semaphore::Pend_i(uint32_t u32WaitTimeMS_)
 {
     KERNEL_ASSERT(IsInitialized());
+#if KERNEL_TRACE
+    KernelTrace::Record(TraceEvent::SemaphorePend, g_pclCurrent, this);
+#endif // #if KERNEL_TRACE
+#if KERNEL_COST_MODEL
+    CostModel::Charge(CostEvent::SemaphoreOp);
+#endif // #if KERNEL_COST_MODEL
 
     auto clSemTimer = Timer {};
     auto bUseTimer  = false;
@@ -77,6 +77,27 @@ void DoubleLinkList::Remove(LinkListNode* node_)
     node_->ClearNode();
 }
 
+//---------------------------------------------------------------------------
+void DoubleLinkList::InsertNodeBefore(LinkListNode* node_, LinkListNode* insert_)
+{
+    KERNEL_ASSERT(nullptr != node_);
+
+    if (nullptr == insert_) {
+        Add(node_);
+        return;
+    }
+
+    node_->next = insert_;
+    node_->prev = insert_->prev;
+
+    if (nullptr != insert_->prev) {
+        insert_->prev->next = node_;
+    } else {
+        m_pclHead = node_;
+    }
+    insert_->prev = node_;
+}
+
 //---------------------------------------------------------------------------
 void CircularLinkList::Add(LinkListNode* node_)
 {
@@ -139,21 +139,25 @@ bool Mailbox::SendTail(void* pvData_, uint32_t u32TimeoutMS_)
 bool Mailbox::Send_i(const void* pvData_, bool bTail_, uint32_t u32TimeoutMS_)
 {
     KERNEL_ASSERT(nullptr != pvData_);
+#if KERNEL_TRACE
+    KernelTrace::Record(TraceEvent::MailboxSend, g_pclCurrent, this);
+#endif // #if KERNEL_TRACE
 
     void* pvDst = nullptr;
 
-    auto bRet        = false;
-    auto bSchedState = Scheduler::SetScheduler(false);
-    auto bBlock      = false;
-    auto bDone       = false;
+    auto bRet   = false;
+    auto bBlock = false;
+    auto bDone  = false;
+
+    Scheduler::Lock();
 
     while (!bDone) {
         // Try to claim a slot first before resorting to blocking.
         if (bBlock) {
             bDone = true;
-            Scheduler::SetScheduler(bSchedState);
+            Scheduler::Unlock();
             m_clSendSem.Pend(u32TimeoutMS_);
-            Scheduler::SetScheduler(false);
+            Scheduler::Lock();
         }
 
         { // Begin critical section
@@ -179,17 +183,15 @@ bool Mailbox::Send_i(const void* pvData_, bool bTail_, uint32_t u32TimeoutMS_)
         } // End critical section
     }
 
-    // Copy data to the claimed slot, and post the counting semaphore
+    // Copy data to the claimed slot, and post the counting semaphore.  Any
+    // thread switch this causes is deferred until the scheduler is unlocked.
     if (bRet) {
         CopyData(pvData_, pvDst, m_u16ElementSize);
-    }
-
-    Scheduler::SetScheduler(bSchedState);
-
-    if (bRet) {
         m_clRecvSem.Post();
     }
 
+    Scheduler::Unlock();
+
     return bRet;
 }
 
@@ -197,6 +199,9 @@ bool Mailbox::Send_i(const void* pvData_, bool bTail_, uint32_t u32TimeoutMS_)
 bool Mailbox::Receive_i(void* pvData_, bool bTail_, uint32_t u32WaitTimeMS_)
 {
     KERNEL_ASSERT(nullptr != pvData_);
+#if KERNEL_TRACE
+    KernelTrace::Record(TraceEvent::MailboxReceive, g_pclCurrent, this);
+#endif // #if KERNEL_TRACE
     auto* pvSrc = (const void*){};
 
     if (!m_clRecvSem.Pend(u32WaitTimeMS_)) {
@@ -208,7 +213,7 @@ bool Mailbox::Receive_i(void* pvData_, bool bTail_, uint32_t u32WaitTimeMS_)
     // Disable the scheduler while we do this -- this ensures we don't have
     // multiple concurrent readers off the same queue, which could be problematic
     // if multiple writes occur during reads, etc.
-    auto bSchedState = Scheduler::SetScheduler(false);
+    Scheduler::Lock();
 
     // Update the head/tail indexes, and get the associated data pointer for
     // the read operation.
@@ -228,11 +233,12 @@ bool Mailbox::Receive_i(void* pvData_, bool bTail_, uint32_t u32WaitTimeMS_)
     KERNEL_ASSERT(pvSrc);
     CopyData(pvSrc, pvData_, m_u16ElementSize);
 
-    Scheduler::SetScheduler(bSchedState);
-
-    // Unblock a thread waiting for a free slot to send to
+    // Unblock a thread waiting for a free slot to send to, switching to it
+    // (if required) as the scheduler is unlocked.
     m_clSendSem.Post();
 
+    Scheduler::Unlock();
+
     return true;
 }
 } // namespace Mark3
@@ -45,7 +45,7 @@ namespace
         // Wake up the thread that was blocked on this semaphore.
         pclMutex->WakeMe(pclOwner_);
 
-        if (pclOwner_->GetCurPriority() >= Scheduler::GetCurrentThread()->GetCurPriority()) {
+        if (Scheduler::WillPreempt(pclOwner_)) {
             Thread::Yield();
         }
     }
@@ -83,7 +83,7 @@ uint8_t Mutex::WakeNext()
     m_pclOwner = pclChosenOne;
 
     // Signal a context switch if it's a greater than or equal to the current priority
-    if (pclChosenOne->GetCurPriority() >= Scheduler::GetCurrentThread()->GetCurPriority()) {
+    if (Scheduler::WillPreempt(pclChosenOne)) {
         return 1;
     }
     return 0;
@@ -94,6 +94,9 @@ void Mutex::Init(bool bRecursive_)
 {
     // Cannot re-init a mutex which has threads blocked on it
     KERNEL_ASSERT(!m_clBlockList.GetHead());
+#if KERNEL_COST_MODEL
+    CostModel::Charge(CostEvent::MutexOp);
+#endif // #if KERNEL_COST_MODEL
 
     // Reset the data in the mutex
     m_bReady     = true;    // The mutex is free.
@@ -108,6 +111,12 @@ void Mutex::Init(bool bRecursive_)
 bool Mutex::Claim_i(uint32_t u32WaitTimeMS_)
 {
     KERNEL_ASSERT(IsInitialized());
+#if KERNEL_TRACE
+    KernelTrace::Record(TraceEvent::MutexClaim, g_pclCurrent, this);
+#endif // #if KERNEL_TRACE
+#if KERNEL_COST_MODEL
+    CostModel::Charge(CostEvent::MutexOp);
+#endif // #if KERNEL_COST_MODEL
 
     auto clTimer   = Timer {};
     auto bUseTimer = false;
@@ -115,7 +124,7 @@ bool Mutex::Claim_i(uint32_t u32WaitTimeMS_)
     // Disable the scheduler while claiming the mutex - we're dealing with all
     // sorts of private thread data, can't have a thread switch while messing
     // with internal data structures.
-    Scheduler::SetScheduler(false);
+    Scheduler::Lock();
 
     // Check to see if the mutex is claimed or not
     if (false != m_bReady) {
@@ -125,7 +134,7 @@ bool Mutex::Claim_i(uint32_t u32WaitTimeMS_)
         m_uMaxPri   = g_pclCurrent->GetPriority();
         m_pclOwner  = g_pclCurrent;
 
-        Scheduler::SetScheduler(true);
+        Scheduler::Unlock();
         return true;
     }
 
@@ -137,7 +146,7 @@ bool Mutex::Claim_i(uint32_t u32WaitTimeMS_)
         m_u8Recurse++;
 
         // Increment the lock count and bail
-        Scheduler::SetScheduler(true);
+        Scheduler::Unlock();
         return true;
     }
 
@@ -168,11 +177,14 @@ bool Mutex::Claim_i(uint32_t u32WaitTimeMS_)
         m_pclOwner->InheritPriority(m_uMaxPri);
     }
 
-    // Done with thread data -reenable the scheduler
-    Scheduler::SetScheduler(true);
+    // Done with thread data - re-enable the scheduler, switching away from
+    // this thread (now blocked) in the process.  Any switch requested while
+    // inheriting priorities is folded into the same reschedule.
+    Scheduler::QueueScheduler();
+    Scheduler::Unlock();
 
-    // Switch threads if this thread acquired the mutex
-    Thread::Yield();
+    // Blocking requires that the scheduler isn't locked by the caller
+    KERNEL_ASSERT(Scheduler::IsEnabled());
 
     if (bUseTimer) {
         clTimer.Stop();
@@ -197,11 +209,17 @@ bool Mutex::Claim(uint32_t u32WaitTimeMS_)
 void Mutex::Release()
 {
     KERNEL_ASSERT(IsInitialized());
+#if KERNEL_TRACE
+    KernelTrace::Record(TraceEvent::MutexRelease, g_pclCurrent, this);
+#endif // #if KERNEL_TRACE
+#if KERNEL_COST_MODEL
+    CostModel::Charge(CostEvent::MutexOp);
+#endif // #if KERNEL_COST_MODEL
 
     auto bSchedule = false;
 
     // Disable the scheduler while we deal with internal data structures.
-    Scheduler::SetScheduler(false);
+    Scheduler::Lock();
 
     // This thread had better be the one that owns the mutex currently...
     KERNEL_ASSERT((g_pclCurrent == m_pclOwner));
@@ -210,7 +228,7 @@ void Mutex::Release()
     // count and return immediately.
     if (m_bRecursive && (0u != m_u8Recurse)) {
         m_u8Recurse--;
-        Scheduler::SetScheduler(true);
+        Scheduler::Unlock();
         return;
     }
 
@@ -236,11 +254,11 @@ void Mutex::Release()
         }
     }
 
-    // Must enable the scheduler again in order to switch threads.
-    Scheduler::SetScheduler(true);
+    // Switch threads if a higher-priority thread was woken, once the
+    // scheduler is enabled again.
     if (bSchedule) {
-        // Switch threads if a higher-priority thread was woken
-        Thread::Yield();
+        Scheduler::QueueScheduler();
     }
+    Scheduler::Unlock();
 }
 } // namespace Mark3
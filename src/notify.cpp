@@ -37,7 +37,7 @@ namespace
         // Wake up the thread that was blocked on this semaphore.
         pclNotify->WakeMe(pclOwner_);
 
-        if (pclOwner_->GetCurPriority() >= Scheduler::GetCurrentThread()->GetCurPriority()) {
+        if (Scheduler::WillPreempt(pclOwner_)) {
             Thread::Yield();
         }
     }
@@ -77,7 +77,7 @@ void Notify::Signal(void)
         } else {
             while (nullptr != pclCurrent) {
                 UnBlock(pclCurrent);
-                if (!bReschedule && (pclCurrent->GetCurPriority() >= Scheduler::GetCurrentThread()->GetCurPriority())) {
+                if (!bReschedule && Scheduler::WillPreempt(pclCurrent)) {
                     bReschedule = true;
                 }
                 pclCurrent = m_clBlockList.GetHead();
@@ -91,6 +91,15 @@ void Notify::Signal(void)
     }
 }
 
+#if KERNEL_DEFERRED_POST
+//---------------------------------------------------------------------------
+bool Notify::SignalFromIsr(void)
+{
+    KERNEL_ASSERT(IsInitialized());
+    return DeferredPost::Push(DeferredOp::NotifySignal, this, 0);
+}
+#endif // #if KERNEL_DEFERRED_POST
+
 //---------------------------------------------------------------------------
 void Notify::Wait(bool* pbFlag_)
 {
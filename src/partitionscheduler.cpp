@@ -0,0 +1,97 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   partitionscheduler.cpp
+
+    @brief  Time-partitioned scheduling (ARINC-653 style major/minor frames)
+*/
+
+#include "mark3.h"
+
+#if KERNEL_PARTITIONS
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+KERNEL_INSTANCE_STATE const PartitionWindow* PartitionScheduler::m_pastWindows;
+KERNEL_INSTANCE_STATE uint8_t                PartitionScheduler::m_u8NumWindows;
+KERNEL_INSTANCE_STATE uint8_t                PartitionScheduler::m_u8Window;
+KERNEL_INSTANCE_STATE uint32_t               PartitionScheduler::m_u32TicksRemain;
+
+//---------------------------------------------------------------------------
+void PartitionScheduler::SetSchedule(const PartitionWindow* pastWindows_, uint8_t u8NumWindows_)
+{
+    KERNEL_ASSERT((nullptr != pastWindows_) && (0 != u8NumWindows_));
+    for (uint8_t i = 0; i < u8NumWindows_; i++) {
+        if ((pastWindows_[i].u8Partition >= KERNEL_NUM_PARTITIONS) || (0 == pastWindows_[i].u16Ticks)) {
+            // The panic handler may return; keep running the current schedule.
+            Kernel::Panic(PANIC_PARTITION_INVALID);
+            return;
+        }
+    }
+
+    { // Begin critical section
+        const auto cs  = CriticalGuard{};
+        m_pastWindows  = pastWindows_;
+        m_u8NumWindows = u8NumWindows_;
+        m_u8Window     = 0;
+        StartWindow();
+    } // End critical section
+
+    if (Kernel::IsStarted()) {
+        Thread::Yield();
+    }
+}
+
+//---------------------------------------------------------------------------
+void PartitionScheduler::Process(uint32_t u32Ticks_)
+{
+    const auto cs = CriticalGuard{};
+    if (nullptr == m_pastWindows) {
+        return;
+    }
+
+    // Several windows may end within one epoch when time advances in steps
+    auto bSwitch = false;
+    while (u32Ticks_ >= m_u32TicksRemain) {
+        u32Ticks_ -= m_u32TicksRemain;
+        m_u8Window = ((m_u8Window + 1) == m_u8NumWindows) ? 0 : (m_u8Window + 1);
+        StartWindow();
+        bSwitch = true;
+    }
+    m_u32TicksRemain -= u32Ticks_;
+
+    // The timer thread is in the system partition, so this core reschedules
+    // as soon as it blocks again; the others must be told.
+#if KERNEL_SMP
+    if (bSwitch) {
+        for (auto u8Core = uint8_t { 0 }; u8Core < KERNEL_NUM_CORES; u8Core++) {
+            if (u8Core != Scheduler::GetCurrentCore()) {
+                ThreadPort::SendIpi(u8Core);
+            }
+        }
+    }
+#else
+    (void)bSwitch;
+#endif // #if KERNEL_SMP
+}
+
+//---------------------------------------------------------------------------
+void PartitionScheduler::StartWindow()
+{
+    m_u32TicksRemain = m_pastWindows[m_u8Window].u16Ticks;
+    Scheduler::SetActivePartition(m_pastWindows[m_u8Window].u8Partition);
+}
+} // namespace Mark3
+#endif // #if KERNEL_PARTITIONS
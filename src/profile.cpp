@@ -21,40 +21,75 @@ See license.txt for more information
 #include "mark3.h"
 namespace Mark3
 {
+namespace
+{
+    //---------------------------------------------------------------------------
+    // Time source for profiling - estimated target cycles when the cost model
+    // is enabled, the port's free-running cycle counter otherwise.
+    uint32_t ProfileTimer_Now()
+    {
+#if KERNEL_COST_MODEL
+        return static_cast<uint32_t>(CostModel::GetCycles());
+#else
+        return KernelTimer::GetCycleCount();
+#endif // #if KERNEL_COST_MODEL
+    }
+
+    //---------------------------------------------------------------------------
+    // Index of the log2 histogram bucket for a given cycle count
+    uint8_t ProfileTimer_Bucket(uint32_t u32Cycles_)
+    {
+        auto u8Bucket = uint8_t { 0 };
+        while ((0u != u32Cycles_) && (u8Bucket < (ProfileTimer::m_uNumBuckets - 1))) {
+            u32Cycles_ >>= 1;
+            u8Bucket++;
+        }
+        return u8Bucket;
+    }
+} // anonymous namespace
+
 //---------------------------------------------------------------------------
 void ProfileTimer::Init()
 {
-    m_u32StartTicks = 0;
-    m_u32Cumulative = 0;
-    m_u16Iterations = 0;
-    m_bActive       = false;
+    m_u32StartTicks       = 0;
+    m_u64Cumulative       = 0;
+    m_u32Iterations       = 0;
+    m_u32CurrentIteration = 0;
+    m_u32Min              = UINT32_MAX;
+    m_u32Max              = 0;
+    for (auto& u32Count : m_au32Histogram) { u32Count = 0; }
+    m_bActive = false;
 }
 
 //---------------------------------------------------------------------------
 void ProfileTimer::Start()
 {
+    const auto cs = CriticalGuard{};
     if (!m_bActive) {
-        { // Begin critical section
-            const auto cs = CriticalGuard{};
-            m_u32StartTicks = Kernel::GetTicks();
-        } // End Critical Section
-        m_bActive = true;
+        m_u32StartTicks = ProfileTimer_Now();
+        m_bActive       = true;
     }
 }
 
 //---------------------------------------------------------------------------
 void ProfileTimer::Stop()
 {
+    // Read the counter and record the iteration in one critical section, so
+    // that a Start()/Stop() from an interrupt can't land in between and tear
+    // the statistics.
+    const auto cs = CriticalGuard{};
     if (m_bActive) {
-        uint32_t u32Final;
-        { // Begin critical section
-            const auto cs = CriticalGuard{};
-            u32Final = Kernel::GetTicks();
-            // Compute total for current iteration...
-            m_u32CurrentIteration = u32Final - m_u32StartTicks;
-            m_u32Cumulative += m_u32CurrentIteration;
-            m_u16Iterations++;
-        } // End critical section
+        auto u32Iteration     = ProfileTimer_Now() - m_u32StartTicks;
+        m_u32CurrentIteration = u32Iteration;
+        m_u64Cumulative += u32Iteration;
+        m_u32Iterations++;
+        if (u32Iteration < m_u32Min) {
+            m_u32Min = u32Iteration;
+        }
+        if (u32Iteration > m_u32Max) {
+            m_u32Max = u32Iteration;
+        }
+        m_au32Histogram[ProfileTimer_Bucket(u32Iteration)]++;
         m_bActive = false;
     }
 }
@@ -62,8 +97,8 @@ void ProfileTimer::Stop()
 //---------------------------------------------------------------------------
 uint32_t ProfileTimer::GetAverage()
 {
-    if (0u != m_u16Iterations) {
-        return (m_u32Cumulative + static_cast<uint32_t>(m_u16Iterations / 2)) / static_cast<uint32_t>(m_u16Iterations);
+    if (0u != m_u32Iterations) {
+        return static_cast<uint32_t>((m_u64Cumulative + (m_u32Iterations / 2)) / m_u32Iterations);
     }
     return 0;
 }
@@ -71,13 +106,9 @@ uint32_t ProfileTimer::GetAverage()
 //---------------------------------------------------------------------------
 uint32_t ProfileTimer::GetCurrent()
 {
+    const auto cs = CriticalGuard{};
     if (m_bActive) {
-        uint32_t u32Current;
-        { // Begin critical section
-            const auto cs = CriticalGuard{};
-            u32Current = Kernel::GetTicks() - m_u32StartTicks;
-        } // End critical section
-        return u32Current;
+        return ProfileTimer_Now() - m_u32StartTicks;
     }
     return m_u32CurrentIteration;
 }
@@ -0,0 +1,124 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   budget.h
+
+    @brief  Per-thread CPU budget enforcement
+
+    When KERNEL_BUDGET is enabled, a thread can be given a CPU budget: a
+    number of ticks it may run for in each replenishment period (see
+    Thread::SetBudget()).  The kernel tracks the thread running on each core
+    at every context switch, and charges it for each tick processed by the
+    timer thread.  Once a thread's budget is used up, it's demoted to its
+    "exhausted" priority until the start of its next period, at which point
+    its budget is refilled and its original priority restored.
+
+    This allows a bursty thread to be given a high priority for low latency,
+    without allowing it to starve lower-priority threads if it misbehaves.
+
+    @code
+
+    // Network processing may use up to 2ms of every 10ms at priority 6,
+    // and runs in the background (priority 1) otherwise.
+    clNetThread.SetBudget(2, 10, 1);
+
+    @endcode
+
+    Accounting is done at tick granularity, in the same way as round-robin
+    quanta: a thread that runs for less than a tick at a time may be charged
+    less (or more) than it used.
+ */
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#if KERNEL_BUDGET
+namespace Mark3
+{
+class Thread;
+
+//---------------------------------------------------------------------------
+/**
+ * @brief The Budget Class.
+ * Static-class used to account for, and enforce, per-thread CPU budgets.
+ */
+class Budget
+{
+public:
+    /**
+     * @brief Update
+     * Track the thread about to run on the current core, which will be
+     * charged for ticks until the next context switch.  Called from the
+     * context switch path.
+     *
+     * @param pclThread_ Thread being switched in
+     */
+    static void Update(Thread* pclThread_);
+
+    /**
+     * @brief Charge
+     * Charge the thread running on each core for elapsed ticks, demoting any
+     * thread that runs out of budget.  Called from the timer thread for
+     * each timer epoch.
+     *
+     * @param u32Ticks_ Number of ticks elapsed
+     */
+    static void Charge(uint32_t u32Ticks_);
+
+    /**
+     * @brief Configure
+     * Set a thread's budget and period, and start its replenishment timer.
+     * A budget of 0 removes any budget from the thread.  See
+     * Thread::SetBudget().
+     *
+     * @param pclThread_ Thread to configure
+     * @param u32BudgetMs_ Ticks the thread may run for in each period
+     * @param u32PeriodMs_ Replenishment period, in ticks
+     * @param uXExhaustedPriority_ Priority of the thread while out of budget
+     */
+    static void Configure(Thread*        pclThread_,
+                          uint32_t       u32BudgetMs_,
+                          uint32_t       u32PeriodMs_,
+                          PORT_PRIO_TYPE uXExhaustedPriority_);
+
+private:
+    /**
+     * @brief Replenish
+     * Timer callback run at the start of each of a thread's periods, which
+     * refills its budget and restores its priority.
+     *
+     * @param pclOwner_ Unused
+     * @param pvData_ Thread to replenish
+     */
+    static void Replenish(Thread* pclOwner_, void* pvData_);
+
+    /**
+     * @brief Move
+     * Move a thread to a new base priority, whatever its state.
+     *
+     * @param pclThread_ Thread to move
+     * @param uXPriority_ New priority
+     */
+    static void Move(Thread* pclThread_, PORT_PRIO_TYPE uXPriority_);
+
+    //! Thread being charged on each core
+    static KERNEL_INSTANCE_STATE Thread* m_apclActiveThread[KERNEL_NUM_CORES];
+
+    //! The timer thread, whose own time is charged to the thread it preempted
+    static KERNEL_INSTANCE_STATE Thread* m_pclTimerThread;
+};
+} // namespace Mark3
+#endif // #if KERNEL_BUDGET
@@ -20,17 +20,12 @@ See license.txt for more information
 
 #include "mark3cfg.h"
 #include "ll.h"
-#include "priomapl1.h"
-#include "priomapl2.h"
+#include "priomapn.h"
 
 namespace Mark3 {
 
 // Priority map type declaration, based on port configuration
-#if PORT_COROUTINE_PRIORITIES <= (PORT_PRIO_MAP_WORD_SIZE * 8u)
-using CoPrioMap = PriorityMapL1<PORT_PRIO_TYPE, PORT_COROUTINE_PRIORITIES>;
-#else
-using CoPrioMap = PriorityMapL2<PORT_PRIO_TYPE, PORT_COROUTINE_PRIORITIES>;
-#endif
+using CoPrioMap = PriorityMapN<PORT_PRIO_TYPE, PORT_COROUTINE_PRIORITIES>;
 
 // Forward declarations
 class CoList;
@@ -77,8 +77,8 @@ public:
     static Coroutine* Schedule();
 
 private:
-    static CoList m_aclPriorities[PORT_COROUTINE_PRIORITIES];
-    static CoList m_clStopList;
-    static CoPrioMap m_clPrioMap;
+    static KERNEL_INSTANCE_STATE CoList m_aclPriorities[PORT_COROUTINE_PRIORITIES];
+    static KERNEL_INSTANCE_STATE CoList m_clStopList;
+    static KERNEL_INSTANCE_STATE CoPrioMap m_clPrioMap;
 };
 } // namespace Mark3
@@ -0,0 +1,157 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   costmodel.h
+
+    @brief  Target cycle-cost estimation for host runs
+
+    When KERNEL_COST_MODEL is enabled, each kernel primitive charges an
+    estimated number of target CPU cycles to the running thread, based on a
+    per-target cost table.  This allows the scheduling overhead of a target
+    to be tracked while running at full speed on the host, catching
+    regressions before code is run on hardware.
+
+    In this mode, ProfileTimer measures estimated target cycles instead of
+    kernel ticks, so existing profiling code reports a per-call budget.
+
+    Usage:
+
+    @code
+
+    CostModel::SetTarget(&CostModel::clCortexM3);
+
+    ...
+
+    // Estimated cycles spent by a thread in kernel primitives
+    u64Cycles = clMyThread.GetEstimatedCycles();
+
+    // Number of context switches, and total cost charged for them
+    u32Count  = CostModel::GetEventCount(CostEvent::ContextSwitch);
+    u64Cycles = CostModel::GetEventCycles(CostEvent::ContextSwitch);
+
+    @endcode
+ */
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#if KERNEL_COST_MODEL
+namespace Mark3
+{
+/**
+ * List of kernel primitives tracked by the cost model
+ */
+enum class CostEvent : uint8_t {
+    ContextSwitch = 0, //!< Thread context switch (save + restore)
+    Schedule,          //!< Scheduler::Schedule()
+    ThreadListAdd,     //!< ThreadList::Add() / AddPriority()
+    ThreadListRemove,  //!< ThreadList::Remove()
+    TimerNode,         //!< TimerList::Process(), per timer node
+    MailboxCopy,       //!< Mailbox::CopyData(), fixed overhead
+    MailboxByte,       //!< Mailbox::CopyData(), per byte copied
+    SemaphoreOp,       //!< Semaphore::Init() / Post() / Pend(), fixed overhead
+    MutexOp,           //!< Mutex::Init() / Claim() / Release(), fixed overhead
+    TimerListAdd,      //!< TimerList::Add() / TimerWheel::Add()
+    TimerListRemove,   //!< TimerList::Remove() / TimerWheel::Remove()
+    //---
+    Count
+};
+
+/**
+ * Cost, in target CPU cycles, of each kernel primitive on a given target
+ */
+struct CostTable {
+    const char* szName;                                           //!< Name of the target
+    uint16_t    au16Cycles[static_cast<uint8_t>(CostEvent::Count)]; //!< Cost per event, indexed by CostEvent
+};
+
+/**
+ * @brief The CostModel class
+ *
+ * Accumulates the estimated target cycles charged by kernel primitives,
+ * both globally and per thread.  Costs are charged to the thread that was
+ * running at the time, including those incurred from interrupt context.
+ */
+class CostModel
+{
+public:
+    //! Built-in cost tables, estimated from the instruction sequences used by each port
+    static const CostTable clAVR;
+    static const CostTable clMSP430;
+    static const CostTable clCortexM0;
+    static const CostTable clCortexM3;
+    static const CostTable clCortexM4F;
+
+    /**
+     * @brief Init
+     * Reset all accumulated costs, and select the default (Cortex-M3) cost table.
+     * Called from Kernel::Init().
+     */
+    static void Init();
+
+    /**
+     * @brief SetTarget
+     * Select the cost table used for subsequent events.
+     *
+     * @param pclTable_ Cost table for the target to be estimated
+     */
+    static void SetTarget(const CostTable* pclTable_);
+
+    /**
+     * @brief GetTarget
+     * @return The cost table currently in use
+     */
+    static const CostTable* GetTarget() { return m_pclTable; }
+
+    /**
+     * @brief Charge
+     * Charge the cost of a kernel primitive to the running thread.
+     *
+     * @param eEvent_ Type of primitive executed
+     * @param u16Count_ Number of times it was executed
+     */
+    static void Charge(CostEvent eEvent_, uint16_t u16Count_ = 1);
+
+    /**
+     * @brief GetCycles
+     * @return Total estimated target cycles charged since Init()
+     */
+    static uint64_t GetCycles() { return m_u64Cycles; }
+
+    /**
+     * @brief GetEventCount
+     * @param eEvent_ Type of primitive to query
+     * @return Number of times the primitive has been executed since Init()
+     */
+    static uint32_t GetEventCount(CostEvent eEvent_) { return m_au32Count[static_cast<uint8_t>(eEvent_)]; }
+
+    /**
+     * @brief GetEventCycles
+     * @param eEvent_ Type of primitive to query
+     * @return Estimated target cycles charged for the primitive since Init()
+     */
+    static uint64_t GetEventCycles(CostEvent eEvent_) { return m_au64Cycles[static_cast<uint8_t>(eEvent_)]; }
+
+private:
+    static constexpr auto m_uNumEvents = static_cast<uint8_t>(CostEvent::Count);
+
+    static KERNEL_INSTANCE_STATE const CostTable* m_pclTable;
+    static KERNEL_INSTANCE_STATE uint64_t         m_u64Cycles;
+    static KERNEL_INSTANCE_STATE uint32_t         m_au32Count[m_uNumEvents];
+    static KERNEL_INSTANCE_STATE uint64_t         m_au64Cycles[m_uNumEvents];
+};
+} // namespace Mark3
+#endif // #if KERNEL_COST_MODEL
@@ -0,0 +1,119 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   deadlineheap.h
+
+    @brief  Deadline-ordered heap of threads, used for EDF scheduling
+
+    When KERNEL_EDF is enabled, the ready threads at priority
+    KERNEL_EDF_PRIORITY are scheduled earliest-deadline-first rather than
+    round-robin.  Each such thread declares a relative deadline (see
+    Thread::SetDeadline()), which is converted to an absolute deadline in
+    kernel ticks every time the thread becomes ready.  The scheduler keeps
+    the ready threads in the band in a binary min-heap keyed on that absolute
+    deadline, so that adding or removing a thread is O(log n), and finding
+    the earliest deadline is O(1).
+
+    Threads at priorities above and below the band are scheduled exactly as
+    before; the band as a whole runs whenever it's the highest-priority level
+    with ready threads.
+ */
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#if KERNEL_EDF
+namespace Mark3
+{
+class Thread;
+
+//---------------------------------------------------------------------------
+/**
+ * @brief The DeadlineHeap class
+ * Fixed-capacity binary min-heap of threads, ordered by absolute deadline.
+ * Deadlines are compared modulo 2^32, so the ordering is correct across
+ * wraparound of the tick count as long as all deadlines in the heap are
+ * within 2^31 ticks of each other.
+ */
+class DeadlineHeap
+{
+public:
+    /**
+     * @brief Init
+     * Remove all threads from the heap
+     */
+    void Init() { m_u16Count = 0; }
+
+    /**
+     * @brief Add
+     * Add a thread to the heap, with the given absolute deadline.  If the
+     * heap is full, PANIC_EDF_HEAP_FULL is raised and the thread is not
+     * added.
+     *
+     * @param pclThread_ Thread to add
+     * @param u32Deadline_ Absolute deadline of the thread, in kernel ticks
+     */
+    void Add(Thread* pclThread_, uint32_t u32Deadline_);
+
+    /**
+     * @brief Remove
+     * Remove a thread from the heap
+     *
+     * @param pclThread_ Thread to remove.  Threads not in the heap - such as
+     *                   one refused by Add() - are ignored.
+     */
+    void Remove(Thread* pclThread_);
+
+    /**
+     * @brief GetHead
+     * @return The thread with the earliest deadline, or nullptr if empty
+     */
+    Thread* GetHead() { return (0 != m_u16Count) ? m_apclHeap[0] : nullptr; }
+
+    /**
+     * @brief GetCount
+     * @return Number of threads in the heap
+     */
+    uint16_t GetCount() { return m_u16Count; }
+
+private:
+    static constexpr auto m_uMaxThreads = uint16_t { KERNEL_EDF_MAX_THREADS };
+
+    /**
+     * @brief Place
+     * Store a thread at the given heap index, and record the index in the thread
+     */
+    void Place(uint16_t u16Index_, Thread* pclThread_);
+
+    /**
+     * @brief SiftUp
+     * Move the thread at the given index towards the root, until its parent's
+     * deadline is no later than its own
+     */
+    void SiftUp(uint16_t u16Index_);
+
+    /**
+     * @brief SiftDown
+     * Move the thread at the given index towards the leaves, until neither
+     * child has an earlier deadline
+     */
+    void SiftDown(uint16_t u16Index_);
+
+    Thread*  m_apclHeap[m_uMaxThreads];
+    uint16_t m_u16Count;
+};
+} // namespace Mark3
+#endif // #if KERNEL_EDF
@@ -0,0 +1,148 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   deferredpost.h
+
+    @brief  Deferred posting of kernel objects from interrupts
+
+    Posting a semaphore, signalling a notification or setting event flags
+    from an interrupt normally runs the whole wake path in the interrupt, with
+    interrupts disabled: unblocking the waiting thread(s), adding them to the
+    scheduler, and rescheduling.  When KERNEL_DEFERRED_POST is enabled, the
+    "FromIsr" variants of those calls (Semaphore::PostFromIsr(),
+    Notify::SignalFromIsr(), EventFlag::SetFromIsr()) instead record the
+    request in a small queue, in constant time.
+
+    The queue is drained in one batch at the start of the next scheduling
+    decision (Thread::Yield()), which defers the thread switches requested by
+    each operation until the batch is done, so that however many requests
+    were queued, threads are only rescheduled once.  Each
+    request is carried out by the normal thread-context call, in its own
+    critical section, so interrupts aren't held off for the whole batch.
+
+    @code
+
+    void UART_RX_ISR()
+    {
+        ...
+        clRxFlags.SetFromIsr(RX_DATA);
+        if (bLineComplete) {
+            clLineSem.PostFromIsr();
+        }
+        // Run the queued requests, and switch threads if required
+        DeferredPost::Commit();
+    }
+
+    @endcode
+ */
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#if KERNEL_DEFERRED_POST
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+/**
+ * Operations which can be deferred from interrupt context
+ */
+enum class DeferredOp : uint8_t {
+    SemaphorePost = 0, //!< Semaphore::Post()
+    NotifySignal,      //!< Notify::Signal()
+    EventFlagSet       //!< EventFlag::Set(), with the request's argument as the mask
+};
+
+//---------------------------------------------------------------------------
+/**
+ * @brief The DeferredPost Class.
+ * Static-class implementing the queue of requests posted from interrupts.
+ */
+class DeferredPost
+{
+public:
+    /**
+     * @brief Push
+     * Queue a request, to be carried out at the next scheduling decision.
+     * Safe to call from interrupts, and takes constant time.
+     *
+     * @param eOp_ Operation to perform
+     * @param pvObject_ Kernel object to perform it on
+     * @param u16Arg_ Operation-specific argument
+     * @return true if the request was queued, false if the queue is full
+     */
+    static bool Push(DeferredOp eOp_, void* pvObject_, uint16_t u16Arg_);
+
+    /**
+     * @brief Commit
+     * Carry out any queued requests, and reschedule if required.  Intended to
+     * be called once at the end of an interrupt handler which has queued
+     * requests.
+     */
+    static void Commit();
+
+    /**
+     * @brief Drain
+     * Carry out all queued requests.  Called at the start of Thread::Yield(),
+     * which then makes a single scheduling decision for the whole batch.  Has
+     * no effect while the scheduler is locked; the requests are carried out
+     * when it's unlocked instead.
+     */
+    static void Drain();
+
+    /**
+     * @brief IsDraining
+     * @return true if the current core is carrying out queued requests, in
+     *         which case any thread switch they request is left to the
+     *         Thread::Yield() call that's draining them
+     */
+    static bool IsDraining();
+
+    /**
+     * @brief IsPending
+     * @return true if there are requests waiting to be carried out
+     */
+    static bool IsPending() { return 0 != m_u8Count; }
+
+private:
+    static constexpr auto m_u8Depth = uint8_t { KERNEL_DEFERRED_POST_DEPTH };
+
+    /**
+     * A single queued request
+     */
+    struct Request {
+        void*      pvObject; //!< Object to operate on
+        uint16_t   u16Arg;   //!< Operation-specific argument
+        DeferredOp eOp;      //!< Operation to perform
+    };
+
+    /**
+     * @brief Pop
+     * Remove the oldest request from the queue
+     *
+     * @param pstRequest_ Request to fill in
+     * @return true if a request was removed, false if the queue is empty
+     */
+    static bool Pop(Request* pstRequest_);
+
+    static KERNEL_INSTANCE_STATE Request m_astQueue[m_u8Depth];
+    static KERNEL_INSTANCE_STATE uint8_t m_u8Head;  //!< Index of the oldest request
+    static KERNEL_INSTANCE_STATE uint8_t m_u8Count; //!< Number of requests queued
+
+    //! Whether each core is draining the queue
+    static KERNEL_INSTANCE_STATE bool m_abDraining[KERNEL_NUM_CORES];
+};
+} // namespace Mark3
+#endif // #if KERNEL_DEFERRED_POST
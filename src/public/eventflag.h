@@ -90,6 +90,17 @@ public:
      */
     void Set(uint16_t u16Mask_);
 
+#if KERNEL_DEFERRED_POST
+    /**
+     * @brief SetFromIsr
+     * Queue a Set() of flags in this object from an interrupt, to be carried
+     * out at the next scheduling decision (see DeferredPost).
+     * @param u16Mask_ - Bitmask of flags to set.
+     * @return true if the request was queued, false if the queue is full
+     */
+    bool SetFromIsr(uint16_t u16Mask_);
+#endif // #if KERNEL_DEFERRED_POST
+
     /**
      * @brief ClearFlags - Clear a specific set of flags within this object, specific by bitmask
      * @param u16Mask_ - Bitmask of flags to clear
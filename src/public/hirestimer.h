@@ -0,0 +1,190 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   hirestimer.h
+
+    @brief  Microsecond-resolution timers, driven by a hardware compare channel
+
+    When KERNEL_HIRES_TIMERS is enabled, HiResTimer objects provide one-shot
+    and periodic timers with intervals in microseconds, for work that needs
+    finer timing than the kernel tick (motor control, sampling, etc.).
+
+    High-resolution timers are independent of the Timer objects multiplexed
+    by the timer thread.  Active timers are kept in their own queue, sorted by
+    absolute expiry time on the kernel clock (see Kernel::GetClock()), and
+    the port programs a hardware compare interrupt for the timer at the head
+    of the queue.  The compare interrupt calls HiResTimer::Process(), which
+    expires all timers that are due, and re-arms the compare for the next.
+
+    @code
+
+    HiResTimer clSampleTimer;
+
+    void SampleCallback(Thread* pclOwner_, void* pvData_)
+    {
+        // Runs in interrupt context, every 250us
+        static_cast<Semaphore*>(pvData_)->Post();
+    }
+
+    clSampleTimer.Init();
+    clSampleTimer.Start(true, 250, SampleCallback, &clSampleSem);
+
+    @endcode
+
+    Callbacks run directly from the compare interrupt, rather than from the
+    timer thread, so they must be short, and may only use the kernel APIs
+    that are safe to call from an interrupt.
+
+    Periodic timers are reloaded relative to their previous expiry rather
+    than the time their callback ran, so they don't drift.  If a periodic
+    timer falls a whole interval or more behind (i.e. its interrupt was held
+    off for that long), the missed expiries are skipped, and the timer
+    continues in phase with its original schedule.
+
+    The resolution of a timer is one kernel clock cycle, PORT_TIMER_FREQ per
+    tick, or that of the port's compare hardware if coarser.  Intervals are
+    rounded up to a whole number of clock cycles.
+ */
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#include "ll.h"
+#include "timer.h"
+
+#if KERNEL_HIRES_TIMERS
+namespace Mark3
+{
+class Thread;
+
+//---------------------------------------------------------------------------
+/**
+ * @brief The HiResTimer Class.
+ * Provides one-shot and periodic timers with microsecond intervals, expired
+ * from a hardware compare interrupt.
+ */
+class HiResTimer : public TypedLinkListNode<HiResTimer>
+{
+public:
+    void* operator new(size_t sz, void* pv) { return reinterpret_cast<HiResTimer*>(pv); }
+    ~HiResTimer() {}
+
+    /**
+     *  @brief HiResTimer
+     *  Default Constructor - Do nothing.  Allow the init call to perform
+     *  the necessary object initialization prior to use.
+     */
+    HiResTimer();
+
+    /**
+     *  @brief Init
+     *  Re-initialize the HiResTimer to default values.
+     */
+    void Init();
+
+    /**
+     *  @brief Start
+     *  Start a timer, using repeats as an option, and microsecond resolution.
+     *  The first expiry is one interval from now.  Has no effect on a timer
+     *  that's already active.  May only be called once the kernel has been
+     *  started.
+     *
+     *  @param bRepeat_ 0 - timer is one-shot.  1 - timer is repeating.
+     *  @param u32IntervalUs_ - Interval of the timer in microseconds
+     *  @param pfCallback_ - Function to call on timer expiry, from interrupt context
+     *  @param pvData_ - Data to pass into the callback function
+     */
+    void Start(bool bRepeat_, uint32_t u32IntervalUs_, TimerCallback pfCallback_, void* pvData_);
+
+    /**
+     *  @brief Start
+     *  Start or restart a timer using the parameters from the last call to
+     *  Start(<with args>).
+     */
+    void Start();
+
+    /**
+     *  @brief Stop
+     *  Stop a timer already in progress.  Has no effect on timers that have
+     *  already been stopped.
+     */
+    void Stop();
+
+    /**
+     *  @brief IsActive
+     *  @return true if the timer is waiting to expire
+     */
+    bool IsActive() { return (0 != (m_u8Flags & uTimerFlagActive)); }
+
+    /**
+     *  @brief Process
+     *  Expire all timers that are due, running their callbacks and reloading
+     *  periodic timers, then program the port's compare interrupt for the
+     *  next expiry.  Called by the port from the compare interrupt, and when
+     *  a new timer is added at the head of the queue.  Spurious (early) calls
+     *  are harmless.
+     */
+    static void Process();
+
+private:
+    /**
+     *  @brief USecondsToCycles
+     *  Convert an interval in microseconds to kernel clock cycles, rounding
+     *  up.  An interval of 0 expires on the next clock cycle.
+     *
+     *  @param u32Us_ Interval in microseconds
+     *  @return Interval in kernel clock cycles
+     */
+    static uint64_t USecondsToCycles(uint32_t u32Us_);
+
+    /**
+     *  @brief Insert
+     *  Add a timer to the queue, in order of expiry.  Timers with the same
+     *  expiry time expire in the order they were added.
+     *
+     *  @param pclTimer_ Timer to add
+     */
+    static void Insert(HiResTimer* pclTimer_);
+
+    static constexpr auto m_uTimerInvalidCookie = uint8_t { 0x5A };
+    static constexpr auto m_uTimerInitCookie    = uint8_t { 0xA5 };
+
+    //! Cookie used to determine whether or not the timer is initialized
+    uint8_t m_u8Initialized;
+
+    //! Flags for the timer, defining if the timer is one-shot or repeated
+    uint8_t m_u8Flags;
+
+    //! Pointer to the callback function
+    TimerCallback m_pfCallback;
+
+    //! Interval of the timer, in kernel clock cycles
+    uint64_t m_u64Interval;
+
+    //! Kernel clock value at which the timer expires
+    uint64_t m_u64Expiry;
+
+    //! Pointer to the owner thread
+    Thread* m_pclOwner;
+
+    //! Pointer to the callback data
+    void* m_pvData;
+
+    //! Active timers, in order of expiry
+    static KERNEL_INSTANCE_STATE TypedDoubleLinkList<HiResTimer> m_clQueue;
+};
+} // namespace Mark3
+#endif // #if KERNEL_HIRES_TIMERS
@@ -20,6 +20,7 @@ See license.txt for more information
 #pragma once
 
 #include <stdint.h>
+#include "mark3cfg.h"
 
 namespace Mark3
 {
@@ -47,6 +48,35 @@ public:
      *  Function to start the scheduler, initial threads, etc.
      */
     static void StartThreads();
+
+#if KERNEL_SMP
+    /**
+     *  @brief GetCoreId
+     *  Return the index of the core executing the caller.
+     *
+     *  @return Index of the current core, from 0 to KERNEL_NUM_CORES - 1
+     */
+    static uint8_t GetCoreId();
+
+    /**
+     *  @brief SendIpi
+     *  Send an inter-processor interrupt to the given core, causing it to
+     *  run its scheduler as soon as it has interrupts enabled.
+     *
+     *  @param u8Core_ Index of the core to interrupt
+     */
+    static void SendIpi(uint8_t u8Core_);
+#endif // #if KERNEL_SMP
+#if KERNEL_STACK_CHECK && (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_MPU)
+    /**
+     *  @brief SetStackGuard
+     *  Move the MPU guard region to the limit of the given thread's stack,
+     *  ahead of it being switched in.
+     *
+     *  @param pclThread_ Thread about to run
+     */
+    static void SetStackGuard(Thread* pclThread_);
+#endif // #if KERNEL_STACK_CHECK && (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_MPU)
     friend class Thread;
 
 private:
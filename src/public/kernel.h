@@ -92,6 +92,13 @@ public:
      * @param pfPanic_ Panic function pointer
      */
     static void SetPanic(PanicFunc pfPanic_) { m_pfPanic = pfPanic_; }
+    /**
+     * @brief GetPanic Return the function called when a kernel panic occurs
+     *
+     * @return Pointer to the currently-installed panic function,
+     *         or nullptr if not set.
+     */
+    static PanicFunc GetPanic() { return m_pfPanic; }
     /**
      * @brief IsPanic Returns whether or not the kernel is in a panic state
      * @return Whether or not the kernel is in a panic state
@@ -202,28 +209,73 @@ public:
     static uint16_t GetStackGuardThreshold() { return m_u16GuardThreshold; }
 #endif // #if KERNEL_STACK_CHECK
 
-    static void     Tick() { m_u32Ticks++; }
-    static uint32_t GetTicks();
+    /**
+     * @brief Tick
+     * Advance the kernel tick count.  Must only be called from the kernel
+     * timer's interrupt, or with interrupts disabled, so that there is only
+     * ever one update in progress.
+     *
+     * @param u32Ticks_ Number of ticks elapsed
+     */
+    static void Tick(uint32_t u32Ticks_);
+    static void Tick() { Tick(1); }
+
+    /**
+     * @brief GetTicks
+     * @return The low 32 bits of the kernel tick count
+     */
+    static uint32_t GetTicks() { return static_cast<uint32_t>(GetTicks64()); }
+
+    /**
+     * @brief GetTicks64
+     * Read the full 64-bit kernel tick count.  The read is lock-free (except
+     * on 8-bit targets, where it's made with interrupts disabled), and may be
+     * made from any context, including interrupts.
+     *
+     * @return Number of ticks since the kernel was started
+     */
+    static uint64_t GetTicks64();
+
+    /**
+     * @brief GetClock
+     * Read a 64-bit monotonic clock, made up of the kernel tick count and the
+     * time elapsed within the current tick, as read from the kernel timer.
+     * The clock counts PORT_TIMER_FREQ cycles per tick, so its resolution is
+     * that of the timer hardware.  Like GetTicks64(), the read is lock-free,
+     * and may be made from any context.
+     *
+     * @return Cycles since the kernel was started
+     */
+    static uint64_t GetClock();
 
 private:
-    static bool      m_bIsStarted; //!< true if kernel is running, false otherwise
-    static bool      m_bIsPanic;   //!< true if kernel is in panic state, false otherwise
-    static PanicFunc m_pfPanic;    //!< set panic function
+    static KERNEL_INSTANCE_STATE bool      m_bIsStarted; //!< true if kernel is running, false otherwise
+    static KERNEL_INSTANCE_STATE bool      m_bIsPanic;   //!< true if kernel is in panic state, false otherwise
+    static KERNEL_INSTANCE_STATE PanicFunc m_pfPanic;    //!< set panic function
 
 #if KERNEL_THREAD_CREATE_CALLOUT
-    static ThreadCreateCallout m_pfThreadCreateCallout; //!< Function to call on thread creation
+    static KERNEL_INSTANCE_STATE ThreadCreateCallout m_pfThreadCreateCallout; //!< Function to call on thread creation
 #endif                                                  // #if KERNEL_THREAD_CREATE_HOOK
 #if KERNEL_THREAD_EXIT_CALLOUT
-    static ThreadExitCallout m_pfThreadExitCallout; //!< Function to call on thread exit
+    static KERNEL_INSTANCE_STATE ThreadExitCallout m_pfThreadExitCallout; //!< Function to call on thread exit
 #endif                                              // #if KERNEL_THREAD_EXIT_HOOK
 #if KERNEL_CONTEXT_SWITCH_CALLOUT
-    static ThreadContextCallout m_pfThreadContextCallout; //!< Function to call on context switch
+    static KERNEL_INSTANCE_STATE ThreadContextCallout m_pfThreadContextCallout; //!< Function to call on context switch
 #endif                                                    // #if KERNEL_CONTEXT_SWITCH_CALLOUT
-    static DebugPrintFunction m_pfDebugPrintFunction;     //!< Function to call to print debug info
+    static KERNEL_INSTANCE_STATE DebugPrintFunction m_pfDebugPrintFunction;     //!< Function to call to print debug info
 #if KERNEL_STACK_CHECK
-    static uint16_t m_u16GuardThreshold;
+    static KERNEL_INSTANCE_STATE uint16_t m_u16GuardThreshold;
 #endif // #if KERNEL_STACK_CHECK
-    static uint32_t m_u32Ticks;
+
+    //! Kernel tick count, kept twice: readers use the copy selected by the low
+    //! bit of m_kwTickSeq, and Tick() writes the other copy before selecting it.
+    static KERNEL_INSTANCE_STATE uint64_t m_au64Ticks[2];
+    static KERNEL_INSTANCE_STATE K_WORD   m_kwTickSeq; //!< Incremented on each update of the tick count
+
+    //! A sequence word narrower than 16 bits can wrap back to the value a
+    //! preempted reader started with, so those targets read the tick count
+    //! with interrupts disabled instead of retrying on a sequence change.
+    static constexpr auto m_bTickSeqLocked = bool { sizeof(K_WORD) < sizeof(uint16_t) };
 };
 
 } // namespace Mark3
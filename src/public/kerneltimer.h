@@ -51,5 +51,89 @@ public:
      *  Shut down the kernel timer, used when no timers are scheduled
      */
     static void Stop(void);
+
+    /**
+     *  @brief GetCycleCount
+     *  Read the port's free-running, high-resolution cycle counter, used for
+     *  profiling.  The counter wraps at 32 bits, so only differences between
+     *  two readings are meaningful.  Depending on the target, this is a
+     *  hardware cycle counter (DWT CYCCNT, TSC), or the kernel timer's counter
+     *  extended by the tick count; in the latter case, the resolution is that
+     *  of the timer's prescaler.
+     *
+     *  Intervals of 2^32 cycles or more can't be measured - on a host TSC,
+     *  that's only a second or two.
+     *
+     *  @return Current cycle count
+     */
+    static uint32_t GetCycleCount(void);
+
+    /**
+     *  @brief GetTickOffset
+     *  Read the time elapsed since the last tick counted by the kernel, in
+     *  cycles (PORT_TIMER_FREQ per tick).  If the next tick's interrupt is
+     *  pending but not yet serviced, the result includes that whole tick, so
+     *  that Kernel::GetClock() never runs backwards.  Where the hardware
+     *  allows, the timer should be read without a critical section: it's
+     *  read from Kernel::GetClock(), which retries if a tick is counted in
+     *  the meantime.
+     *
+     *  @return Cycles since the last counted tick
+     */
+    static uint32_t GetTickOffset(void);
+
+#if KERNEL_TICKLESS
+    /**
+     *  @brief Suppress
+     *  Stop the periodic tick, and program the timer to interrupt once, on
+     *  the u32Ticks_'th tick boundary from now.  Called with interrupts
+     *  disabled.
+     *
+     *  @param u32Ticks_ Number of ticks to suppress (1 - PORT_TICKLESS_MAX_TICKS)
+     */
+    static void Suppress(uint32_t u32Ticks_);
+
+    /**
+     *  @brief Wait
+     *  Put the CPU to sleep until an interrupt is pending.  Called with
+     *  interrupts disabled, which remain disabled on return, so that the
+     *  interrupt is only serviced once the tick has been resumed.
+     */
+    static void Wait(void);
+
+    /**
+     *  @brief Resume
+     *  Restart the periodic tick, in phase with the tick boundaries before
+     *  it was suppressed.  Ticks that elapsed while suppressed are added to
+     *  the kernel tick count, and passed on to the timer thread; if the
+     *  one-shot interrupt is pending, its own handler accounts for the final
+     *  tick.  Called with interrupts disabled.
+     */
+    static void Resume(void);
+#endif // #if KERNEL_TICKLESS
+
+#if KERNEL_HIRES_TIMERS
+    /**
+     *  @brief SetCompare
+     *  Program the high-resolution compare interrupt to fire once, when
+     *  Kernel::GetClock() reaches the given value, replacing any compare
+     *  already programmed.  The interrupt handler calls HiResTimer::Process().
+     *  The interrupt may fire early (e.g. if the value is beyond the range of
+     *  the compare hardware), but never late.  Called with interrupts
+     *  disabled.
+     *
+     *  @param u64Clock_ Kernel clock value at which to interrupt, in cycles
+     *  @return true if the compare was programmed, false if the clock had
+     *          already reached the value (the caller handles it instead).
+     */
+    static bool SetCompare(uint64_t u64Clock_);
+
+    /**
+     *  @brief ClearCompare
+     *  Disable the high-resolution compare interrupt.  Called with interrupts
+     *  disabled.
+     */
+    static void ClearCompare(void);
+#endif // #if KERNEL_HIRES_TIMERS
 };
 } // namespace Mark3
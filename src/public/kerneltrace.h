@@ -0,0 +1,227 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   kerneltrace.h
+
+    @brief  Binary kernel event tracer
+
+    When KERNEL_TRACE is enabled, the kernel records each scheduling event
+    as a fixed-size binary record in a ring buffer - one per kernel
+    instance.  The buffer can be drained at any point, and written out over
+    a UART, to a file, etc., along with a header describing its format.
+    The trace2json tool (tools/trace2json) converts such a dump into Chrome
+    trace-event JSON, which can be loaded in Perfetto (ui.perfetto.dev) or
+    chrome://tracing to give a timeline of thread execution, interrupts,
+    and blocking.
+
+    Usage:
+
+    @code
+
+    // Mark the entry/exit of application interrupts in the timeline
+    void MyUart_Handler()
+    {
+        KernelTrace::IsrEnter(UART0_IRQn);
+        ...
+        KernelTrace::IsrExit(UART0_IRQn);
+    }
+
+    // Dump the header and all buffered records
+    static void TraceWrite(const void* pvData_, uint16_t u16Size_, void* pvContext_)
+    {
+        static_cast<Driver*>(pvContext_)->Write(pvData_, u16Size_);
+    }
+    ...
+    KernelTrace::Dump(TraceWrite, pclUART);
+
+    @endcode
+
+    Timestamps are taken from KernelTimer::GetCycleCount(), or from the
+    cost model's estimated cycle count when KERNEL_COST_MODEL is enabled.
+    Object and thread addresses are truncated to 32 bits.
+ */
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#if KERNEL_TRACE
+namespace Mark3
+{
+/**
+ * Types of event recorded by the tracer.  Unless noted otherwise, the
+ * record's thread is the thread which performed the operation, and its
+ * object is the kernel object operated on.
+ */
+enum class TraceEvent : uint8_t {
+    ContextSwitch = 0, //!< Thread = outgoing thread, object = incoming thread, arg = incoming thread's priority
+    ThreadStart,       //!< Thread = started thread, arg = (thread ID << 8) | priority
+    ThreadExit,        //!< Thread = exiting thread
+    ThreadReady,       //!< Thread = thread added to a ready list, arg = priority
+    ThreadBlock,       //!< Thread = blocked thread, object = blocking object
+    ThreadUnblock,     //!< Thread = unblocked thread, object = blocking object
+    TimerExpiry,       //!< Thread = timer's owner, object = timer
+    SemaphorePost,     //!< Semaphore::Post()
+    SemaphorePend,     //!< Semaphore::Pend()
+    MutexClaim,        //!< Mutex::Claim()
+    MutexRelease,      //!< Mutex::Release()
+    MailboxSend,       //!< Mailbox::Send()
+    MailboxReceive,    //!< Mailbox::Receive()
+    IsrEnter,          //!< Thread = interrupted thread, arg = vector
+    IsrExit,           //!< Thread = interrupted thread, arg = vector
+    //---
+    Count
+};
+
+/**
+ * A single trace event, as stored in the ring buffer and dumped.  All fields
+ * are in the target's native byte order.
+ */
+struct TraceRecord {
+    uint32_t u32Timestamp; //!< Cycle count at which the event occurred
+    uint32_t u32Thread;    //!< Address of the thread the event applies to
+    uint32_t u32Object;    //!< Address of the kernel object involved, if any
+    uint8_t  u8Event;      //!< Event type (TraceEvent)
+    uint8_t  u8Core;       //!< Core on which the event occurred
+    uint16_t u16Arg;       //!< Event-specific argument
+};
+static_assert(sizeof(TraceRecord) == 16, "TraceRecord must be packed into 16 bytes");
+
+/**
+ * Header preceding the records in a dump
+ */
+struct TraceHeader {
+    uint32_t u32Magic;           //!< TraceHeader::uMagic - also identifies the byte order
+    uint16_t u16Version;         //!< Format version (TraceHeader::uVersion)
+    uint16_t u16RecordSize;      //!< sizeof(TraceRecord)
+    uint32_t u32CyclesPerSecond; //!< Frequency of the timestamp counter
+    uint32_t u32Records;         //!< Number of records following the header
+    uint32_t u32Lost;            //!< Number of records overwritten before being dumped
+
+    static constexpr auto uMagic   = uint32_t { 0x5254334D }; //!< "M3TR"
+    static constexpr auto uVersion = uint16_t { 1 };
+};
+
+//! Vector number used for the kernel tick interrupt
+static constexpr auto uTraceVectorTick = uint16_t { 0xFFFF };
+
+/**
+ * Function used to write a trace dump - called for the header, then once
+ * for each record.
+ */
+using TraceWriteFunc = void (*)(const void* pvData_, uint16_t u16Size_, void* pvContext_);
+
+/**
+ * @brief The KernelTrace class
+ *
+ * Ring buffer of binary kernel events, filled from the kernel's scheduling
+ * and synchronization paths.
+ */
+class KernelTrace
+{
+public:
+    /**
+     * @brief Init
+     * Clear the ring buffer, and enable tracing.  Called from Kernel::Init().
+     */
+    static void Init();
+
+    /**
+     * @brief SetEnabled
+     * Start or stop recording events.  Records already in the buffer are
+     * preserved.
+     *
+     * @param bEnable_ true to record events, false to stop recording
+     */
+    static void SetEnabled(bool bEnable_) { m_bEnabled = bEnable_; }
+
+    /**
+     * @brief IsEnabled
+     * @return true if events are currently being recorded
+     */
+    static bool IsEnabled() { return m_bEnabled; }
+
+    /**
+     * @brief Record
+     * Add an event to the ring buffer, overwriting the oldest record if the
+     * buffer is full.  Safe to call from interrupt context.
+     *
+     * @param eEvent_ Type of event
+     * @param pvThread_ Thread the event applies to
+     * @param pvObject_ Kernel object involved in the event
+     * @param u16Arg_ Event-specific argument
+     */
+    static void Record(TraceEvent eEvent_, const void* pvThread_, const void* pvObject_, uint16_t u16Arg_ = 0);
+
+    /**
+     * @brief IsrEnter
+     * Record entry into an interrupt handler
+     *
+     * @param u16Vector_ Interrupt vector (application-defined)
+     */
+    static void IsrEnter(uint16_t u16Vector_);
+
+    /**
+     * @brief IsrExit
+     * Record exit from an interrupt handler
+     *
+     * @param u16Vector_ Interrupt vector (application-defined)
+     */
+    static void IsrExit(uint16_t u16Vector_);
+
+    /**
+     * @brief Read
+     * Remove the oldest records from the ring buffer
+     *
+     * @param pstRecords_ Array to copy the records into
+     * @param u16Max_ Maximum number of records to copy
+     * @return Number of records copied
+     */
+    static uint16_t Read(TraceRecord* pstRecords_, uint16_t u16Max_);
+
+    /**
+     * @brief Dump
+     * Write a header followed by every record in the ring buffer (oldest
+     * first), then clear the buffer.  Recording is suspended for the
+     * duration of the dump.
+     *
+     * @param pfWrite_ Function used to write the dump
+     * @param pvContext_ Data passed to the write function
+     */
+    static void Dump(TraceWriteFunc pfWrite_, void* pvContext_);
+
+    /**
+     * @brief GetCount
+     * @return Number of records in the ring buffer
+     */
+    static uint16_t GetCount() { return m_u16Count; }
+
+    /**
+     * @brief GetLost
+     * @return Number of records overwritten since the buffer was last dumped
+     */
+    static uint32_t GetLost() { return m_u32Lost; }
+
+private:
+    static constexpr auto m_uNumRecords = uint16_t { KERNEL_TRACE_RECORDS };
+
+    static KERNEL_INSTANCE_STATE TraceRecord m_astRecords[m_uNumRecords];
+    static KERNEL_INSTANCE_STATE uint16_t    m_u16Head;  //!< Index of the oldest record
+    static KERNEL_INSTANCE_STATE uint16_t    m_u16Count; //!< Number of records in the buffer
+    static KERNEL_INSTANCE_STATE uint32_t    m_u32Lost;  //!< Records overwritten since the last dump
+    static KERNEL_INSTANCE_STATE bool        m_bEnabled;
+};
+} // namespace Mark3
+#endif // #if KERNEL_TRACE
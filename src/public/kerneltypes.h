@@ -21,6 +21,11 @@ See license.txt for more information
 #include <stddef.h>
 
 #pragma once
+
+//! Expand a macro, and convert the result to a string literal (i.e. for use in inline assembly)
+#define KERNEL_STRINGIFY(x) KERNEL_STRINGIFY_IMPL(x)
+#define KERNEL_STRINGIFY_IMPL(x) #x
+
 namespace Mark3
 {
 //---------------------------------------------------------------------------
@@ -76,6 +76,17 @@ public:
      */
     bool Post();
 
+#if KERNEL_DEFERRED_POST
+    /**
+     *  @brief PostFromIsr
+     *  Queue a Post() of the semaphore from an interrupt, to be carried out
+     *  at the next scheduling decision (see DeferredPost).
+     *
+     *  @return true if the request was queued, false if the queue is full
+     */
+    bool PostFromIsr();
+#endif // #if KERNEL_DEFERRED_POST
+
     /**
      *  @brief
      *  Decrement the semaphore count.  If the count is zero, the calling
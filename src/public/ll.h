@@ -208,6 +208,16 @@ public:
      *  @param node_ Pointer to the node to remove
      */
     void Remove(LinkListNode* node_);
+
+    /**
+     * @brief InsertNodeBefore
+     * Insert a linked-list node into the list before the specified insertion
+     * point, or at the tail of the list if the insertion point is nullptr.
+     *
+     * @param node_     Node to insert into the list
+     * @param insert_   Insert point, or nullptr
+     */
+    void InsertNodeBefore(LinkListNode* node_, LinkListNode* insert_);
 };
 
 //---------------------------------------------------------------------------
@@ -335,6 +345,19 @@ public:
     {
         DoubleLinkList::Remove(pNode_);
     }
+
+    /**
+     * @brief InsertNodeBefore
+     * Insert a linked-list node into the list before the specified insertion
+     * point, or at the tail of the list if the insertion point is nullptr.
+     *
+     * @param pNode_     Node to insert into the list
+     * @param pInsert_   Insert point, or nullptr
+     */
+    void InsertNodeBefore(T* pNode_, T* pInsert_)
+    {
+        DoubleLinkList::InsertNodeBefore(pNode_, pInsert_);
+    }
 };
 
 //---------------------------------------------------------------------------
@@ -23,6 +23,7 @@ See license.txt for more information
 #include "kerneltypes.h"
 #include "ithreadport.h"
 #include "ksemaphore.h"
+#include "costmodel.h"
 
 namespace Mark3
 {
@@ -217,6 +218,10 @@ private:
     {
         auto* u8Src = reinterpret_cast<const uint8_t*>(src_);
         auto* u8Dst = reinterpret_cast<uint8_t*>(dst_);
+#if KERNEL_COST_MODEL
+        CostModel::Charge(CostEvent::MailboxCopy);
+        CostModel::Charge(CostEvent::MailboxByte, len_);
+#endif // #if KERNEL_COST_MODEL
         while (len_--) { *u8Dst++ = *u8Src++; }
     }
 
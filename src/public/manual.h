@@ -130,13 +130,27 @@ See license.txt for more information
     <b>KERNEL_STACK_CHECK</b>
 
     Perform stack-depth checks on threads at each context switch, which is useful
-    in detecting stack overflows / near overflows.  Near-overflow detection uses
-    thresholds defined in the target's portcfg.h.  Enabling this also adds the
-    Thread::GetStackSlack() method, which allows a thread's stack to be profiled
-    on-demand.
-
-    Note:  When enabled, the additional stack checks result in a performance hit
-    to context switches and thread initialization.
+    in detecting stack overflows / near overflows.  The check performed is
+    selected by KERNEL_STACK_GUARD:
+
+    - KERNEL_STACK_GUARD_CANARY (default): a few words at the limit of each
+      stack are filled with a known pattern when the thread is initialized,
+      and checked at each context switch, along with the incoming thread's
+      saved stack pointer.  The cost is constant, regardless of stack size.
+    - KERNEL_STACK_GUARD_MPU: on ports that define PORT_SUPPORTS_STACK_GUARD_MPU,
+      an MPU region is moved to the limit of the incoming thread's stack at each
+      context switch, so an overflow faults at the offending instruction.
+    - KERNEL_STACK_GUARD_SLACK: the original check, which searches the painted
+      stack for its high-water mark at every context switch.  The cost grows
+      with the stack size.
+
+    Near-overflow detection uses the threshold defined in the target's
+    portcfg.h (see Kernel::SetStackGuardThreshold()).
+
+    Stacks are painted when KERNEL_STACK_PAINT is set (the default when stack
+    checking is enabled), which adds the Thread::GetStackSlack() method.  This
+    allows a thread's stack to be profiled on-demand, or periodically from a
+    low-priority thread, without adding to the cost of each context switch.
 
     <b>KERNEL_NAMED_THREADS</b>
 
@@ -615,6 +629,13 @@ See license.txt for more information
 
     @endcode
 
+    Timer intervals are in whole kernel ticks (milliseconds).  Where finer
+    timing is needed, and the port provides a hardware compare channel,
+    KERNEL_HIRES_TIMERS adds HiResTimer objects, with intervals in
+    microseconds.  These are kept in their own queue and expire directly from
+    the compare interrupt, rather than from the timer thread -- see
+    hirestimer.h for details.
+
     @section SEM Semaphores
 
     Semaphores are used to synchronized execution of threads based on the
@@ -1204,6 +1225,23 @@ See license.txt for more information
     }
     @endcode
 
+    Sleep() is relative to the time it's called, so a loop that sleeps for
+    its period after doing its work drifts by the time the work takes.  For
+    periodic work, Thread::SleepUntil() sleeps until an absolute tick count
+    instead, and with KERNEL_PERIODIC_THREADS enabled, Thread::SetPeriod() and
+    Thread::WaitForPeriod() keep track of a thread's releases for it:
+
+    @code
+    void ControlLoop(void* unused)
+    {
+        Scheduler::GetCurrentThread()->SetPeriod(1);    // Release every 1ms
+        while (1) {
+            RunController();
+            Thread::WaitForPeriod();                    // Sleep until the next release
+        }
+    }
+    @endcode
+
     @section RR Round-Robin Quantum
 
     Threads at the same thread priority are scheduled using a round-robin
@@ -1360,6 +1398,11 @@ See license.txt for more information
     object is declared, and scheduler state is restored when the SchedulerGuard object
     goes out-of-scope.  This is yet another form of RAII-based resource locking in Mark3.
 
+    Scheduler guards nest: the scheduler lock is counted, so only the outermost guard
+    re-enables the scheduler.  Kernel objects used within the guarded block (such as
+    posting a semaphore that wakes a higher-priority thread) defer any thread switch
+    until then, and it's performed once, when the outermost guard goes out-of-scope.
+
     @code
     void MyFunc()
     {
@@ -2480,6 +2523,9 @@ See license.txt for more information
     Timer - timer.h/timer.cpp<br>
     TimerScheduler - timerscheduler.h<br>
     TimerList - timerlist.h/cpp<br>
+    TimerWheel - timerwheel.h/cpp<br>
+    Tickless - tickless.h/cpp<br>
+    HiResTimer - hirestimer.h/cpp<br>
     KernelTimer - kerneltimer.cpp/.h **<br>
 
     <b>Synchronization</b><br>
@@ -2851,10 +2897,15 @@ See license.txt for more information
     the logic required to implement a timer tick (tick-based kernel) or timer
     expiry (tickless kernel) event.
 
-    The TimerScheduler class contains a single TimerList object, implementing a
-    single, system-wide list of Timer objects within the kernel.  It also
+    The TimerWheel class implements the same interface as a hierarchical timing
+    wheel, in which starting, stopping, and expiring a timer is O(1) amortized,
+    regardless of the number of active timers.  It is used in place of the
+    TimerList when KERNEL_TIMER_WHEEL is enabled.
+
+    The TimerScheduler class contains a single TimerWheel or TimerList object,
+    holding all of the active Timer objects within the kernel.  It also
     provides hooks for the hardware timer, such that when a timer tick or expiry
-    event occurs, the TimerList expiry handler is run.
+    event occurs, the expiry handler is run.
 
     The KernelTimer class (kerneltimer.cpp/.h) implements the CPU specific hardware
     timer driver that is used by the kernel and the TimerScheduler to implement
@@ -2916,6 +2967,14 @@ See license.txt for more information
     from the idle task when lower power/fewer interrupts are desired in most cases
     where a tickless timer would be of value.
 
+    In their place, KERNEL_TICKLESS provides tick suppression while the system
+    is idle, on ports that support it.  The tick runs at its fixed rate while
+    threads are busy, so timer processing is unchanged; but when the idle
+    thread calls Tickless::Idle(), the kernel timer is reprogrammed to
+    interrupt once, at the next timer expiry, and the CPU sleeps until then.
+    On wake-up, the periodic tick is restarted in phase, and the kernel tick
+    count advanced by the ticks slept through.  See tickless.h for details.
+
     ---
 
     In a tickless system, the kernel timer only runs when there are active
@@ -34,6 +34,7 @@ See license.txt for more information
 #include "kernel.h"
 #include "thread.h"
 #include "timerlist.h"
+#include "timerwheel.h"
 
 #include "ksemaphore.h"
 #include "mutex.h"
@@ -48,8 +49,18 @@ See license.txt for more information
 #include "atomic.h"
 
 #include "profile.h"
+#include "costmodel.h"
+#include "kerneltrace.h"
 #include "autoalloc.h"
 #include "priomap.h"
+#include "deadlineheap.h"
+#include "budget.h"
+#include "runtime.h"
+#include "deferredpost.h"
+#include "partitionscheduler.h"
+#include "stackguard.h"
+#include "tickless.h"
+#include "hirestimer.h"
 
 #include "threadlist.h"
 #include "threadlistlist.h"
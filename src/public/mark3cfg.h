@@ -32,16 +32,34 @@ See license.txt for more information
 /**
  * Perform stack-depth checks on threads at each context switch, which is useful
  * in detecting stack overflows / near overflows.  Near-overflow detection uses
- * thresholds defined in the target's portcfg.h.  Enabling this also adds the
- * Thread::GetStackSlack() method, which allows a thread's stack to be profiled
- * on-demand.
+ * thresholds defined in the target's portcfg.h.
  *
- * Note:  When enabled, the additional stack checks result in a performance hit
- * to context switches and thread initialization.
+ * KERNEL_STACK_GUARD selects how overflows are detected (see stackguard.h):
+ * - KERNEL_STACK_GUARD_SLACK measures the outgoing thread's stack slack on
+ *   every context switch - thorough, but O(log n) per switch.
+ * - KERNEL_STACK_GUARD_CANARY checks a canary word at the limit of each
+ *   thread's stack, and the saved stack pointer, in constant time.
+ * - KERNEL_STACK_GUARD_MPU places an MPU no-access region at the limit of the
+ *   running thread's stack, on ports which support it.
  *
+ * KERNEL_STACK_PAINT fills each thread's stack with a known value when it's
+ * initialized, which enables the Thread::GetStackSlack() method, allowing a
+ * thread's stack to be profiled on-demand.  Required for
+ * KERNEL_STACK_GUARD_SLACK; can be disabled otherwise to speed up thread
+ * initialization.
  */
 #define KERNEL_STACK_CHECK (1)
 
+#define KERNEL_STACK_GUARD_SLACK (0)
+#define KERNEL_STACK_GUARD_CANARY (1)
+#define KERNEL_STACK_GUARD_MPU (2)
+#if !defined(KERNEL_STACK_GUARD)
+#define KERNEL_STACK_GUARD (KERNEL_STACK_GUARD_CANARY)
+#endif
+#if !defined(KERNEL_STACK_PAINT)
+#define KERNEL_STACK_PAINT (KERNEL_STACK_CHECK)
+#endif
+
 /**
  * Enabling this provides the Thread::SetName() and Thread::GetName() methods,
  * allowing for each thread to be named with a null-terminated const char* string.
@@ -89,6 +107,53 @@ See license.txt for more information
  */
 #define KERNEL_ROUND_ROBIN (1)
 
+/**
+ * Use a hierarchical timing wheel to manage active timers (see timerwheel.h),
+ * instead of a single list that is walked on every tick.  Starting, stopping
+ * and expiring a timer is then O(1) amortized, regardless of the number of
+ * active timers, at the cost of a fixed table of list heads in RAM.
+ *
+ * KERNEL_TIMER_WHEEL_BITS sets the number of slots per level of the wheel,
+ * as a power of two (2 - 5).  The wheel has enough levels to cover 32-bit
+ * intervals, for a total of (32 / bits) * (2 ^ bits) slots - 128 by default.
+ * Disabled by default, as that RAM is too precious on the smaller targets;
+ * enable it for applications running many timers at once.
+ */
+#if !defined(KERNEL_TIMER_WHEEL)
+#define KERNEL_TIMER_WHEEL (0)
+#endif
+#if !defined(KERNEL_TIMER_WHEEL_BITS)
+#define KERNEL_TIMER_WHEEL_BITS (4)
+#endif
+
+/**
+ * Suppress the periodic kernel tick while the system is idle (see
+ * tickless.h).  The idle thread calls Tickless::Idle(), which programs the
+ * kernel timer to interrupt once, at the next timer expiry, and puts the CPU
+ * to sleep until then (or until some other interrupt arrives).  The kernel
+ * tick count is advanced by the time spent asleep on wake-up.
+ *
+ * KERNEL_TICKLESS_MIN_TICKS sets the shortest idle period, in ticks, for
+ * which the tick is suppressed (2 or more); shorter periods just wait for the
+ * next tick.
+ */
+#if !defined(KERNEL_TICKLESS)
+#define KERNEL_TICKLESS (0)
+#endif
+#if !defined(KERNEL_TICKLESS_MIN_TICKS)
+#define KERNEL_TICKLESS_MIN_TICKS (2)
+#endif
+
+/**
+ * Provide microsecond-resolution timers (see hirestimer.h), on ports with a
+ * hardware compare channel on the kernel clock.  High-resolution timers are
+ * kept in their own sorted queue, and expire directly from the compare
+ * interrupt rather than from the timer thread.
+ */
+#if !defined(KERNEL_HIRES_TIMERS)
+#define KERNEL_HIRES_TIMERS (0)
+#endif
+
 /**
  * Provide a special data pointer in the thread object, which may be used to add
  * additional context to a thread.  Typically this would be used to implement
@@ -96,4 +161,215 @@ See license.txt for more information
  */
 #define KERNEL_EXTENDED_CONTEXT (1)
 
+/**
+ * Place all kernel state (current/next thread, scheduler lists, timer list,
+ * tick count, quantum and coroutine scheduler data) in thread-local storage,
+ * so that each host thread which calls Kernel::Init() and Kernel::Start() runs
+ * its own, fully independent kernel instance.  This allows many kernels to be
+ * run side-by-side within a single process.
+ *
+ * Only supported on ports that provide thread-local storage (i.e. the host
+ * port).  Kernel objects must never be shared between instances.
+ */
+#if !defined(KERNEL_MULTI_INSTANCE)
+#define KERNEL_MULTI_INSTANCE (0)
+#endif
+
+/**
+ * Estimate the cost of running on a real target while running on the host.
+ * Each kernel primitive (context switch, scheduler run, thread list add/remove,
+ * timer list node processed, mailbox byte copied) charges an estimated number
+ * of target CPU cycles to the running thread, based on a per-target cost table
+ * (see costmodel.h).  ProfileTimer measures these estimated cycles instead of
+ * kernel ticks while enabled.
+ *
+ * Intended for host builds, to catch regressions in scheduling overhead before
+ * running on hardware.
+ */
+#if !defined(KERNEL_COST_MODEL)
+#define KERNEL_COST_MODEL (0)
+#endif
+
+/**
+ * Record kernel events (context switches, threads becoming ready, blocking and
+ * unblocking, timer expiry, semaphore/mutex/mailbox operations, and kernel ISR
+ * entry/exit) as fixed-size binary records in a ring buffer, for offline
+ * timeline analysis (see kerneltrace.h).  Once full, the oldest records are
+ * overwritten, so the buffer always holds the events leading up to the point
+ * at which it's read.
+ *
+ * KERNEL_TRACE_RECORDS sets the capacity of the ring buffer, in 16-byte records.
+ */
+#if !defined(KERNEL_TRACE)
+#define KERNEL_TRACE (0)
+#endif
+#if !defined(KERNEL_TRACE_RECORDS)
+#define KERNEL_TRACE_RECORDS (128)
+#endif
+
+/**
+ * Schedule the threads at one priority level earliest-deadline-first (EDF),
+ * rather than round-robin.  Threads at KERNEL_EDF_PRIORITY declare a relative
+ * deadline (Thread::SetDeadline()); each time one becomes ready, its absolute
+ * deadline is set to the current tick count plus its relative deadline, and
+ * whenever that priority level is the highest with ready threads, the ready
+ * thread with the earliest absolute deadline runs.  Threads at all other
+ * priorities are scheduled as normal.
+ *
+ * KERNEL_EDF_MAX_THREADS sets the maximum number of threads that can be ready
+ * in the EDF band at once (per core).  A thread made ready beyond that raises
+ * PANIC_EDF_HEAP_FULL, and isn't scheduled by deadline.
+ */
+#if !defined(KERNEL_EDF)
+#define KERNEL_EDF (0)
+#endif
+#if !defined(KERNEL_EDF_PRIORITY)
+#define KERNEL_EDF_PRIORITY (1)
+#endif
+#if !defined(KERNEL_EDF_MAX_THREADS)
+#define KERNEL_EDF_MAX_THREADS (16)
+#endif
+
+/**
+ * Enforce per-thread CPU budgets.  A thread given a budget (Thread::SetBudget())
+ * may run for a set number of ticks in each replenishment period; once the
+ * budget is used up, the thread is demoted to a lower priority until its next
+ * period begins.  Time is charged to the running thread on each core by the
+ * timer thread, in the same way as round-robin quanta (see budget.h).
+ */
+#if !defined(KERNEL_BUDGET)
+#define KERNEL_BUDGET (0)
+#endif
+
+/**
+ * Allow threads to be made periodic (Thread::SetPeriod()).  A periodic thread
+ * calls Thread::WaitForPeriod() at the end of each activation, which sleeps
+ * until its next release.  Each release is computed from the previous one, so
+ * the period doesn't drift with the thread's execution time or latency.
+ */
+#if !defined(KERNEL_PERIODIC_THREADS)
+#define KERNEL_PERIODIC_THREADS (0)
+#endif
+
+/**
+ * Give each thread a preemption threshold (Thread::SetPreemptThreshold()) in
+ * addition to its priority.  Once a thread with a threshold above its priority
+ * has been selected to run, it can only be preempted by threads with a higher
+ * priority than its threshold - and if it is, it keeps that protection against
+ * the threads in between when it resumes.  Threads sharing a threshold never
+ * preempt each other, which removes context switches, and lets them share
+ * assumptions about stack depth as if they were cooperative.
+ */
+#if !defined(KERNEL_PREEMPT_THRESHOLD)
+#define KERNEL_PREEMPT_THRESHOLD (0)
+#endif
+
+/**
+ * Account for the CPU time used by each thread.  On every context switch, the
+ * cycles elapsed on the port's cycle counter since the previous switch are
+ * added to the outgoing thread's run time (Thread::GetRunTime()), and to the
+ * idle time if it runs at priority 0.  RunTime::Snapshot() reads the run
+ * times of all threads at once (see runtime.h).
+ */
+#if !defined(KERNEL_RUN_TIME)
+#define KERNEL_RUN_TIME (0)
+#endif
+
+/**
+ * Provide "FromIsr" variants of Semaphore::Post(), Notify::Signal() and
+ * EventFlag::Set(), which queue the request in constant time instead of
+ * running the wake path in the interrupt.  Queued requests are carried out
+ * in one batch at the next scheduling decision, with a single reschedule
+ * (see deferredpost.h).
+ *
+ * KERNEL_DEFERRED_POST_DEPTH sets the number of requests that can be queued.
+ */
+#if !defined(KERNEL_DEFERRED_POST)
+#define KERNEL_DEFERRED_POST (0)
+#endif
+#if !defined(KERNEL_DEFERRED_POST_DEPTH)
+#define KERNEL_DEFERRED_POST_DEPTH (16)
+#endif
+
+/**
+ * Set the number of CPU cores managed by the kernel.  Values greater than 1
+ * enable symmetric-multiprocessing (SMP) mode, in which:
+ *
+ * - Each core has its own set of ready lists and priority map, and runs the
+ *   highest-priority ready thread assigned to it.
+ * - Each thread is assigned to exactly one core (see Thread::SetCore()).
+ *   Threads not explicitly assigned are distributed round-robin as they are
+ *   initialized.  Every core must have its own idle thread.
+ * - Critical sections disable interrupts on the local core, and take a
+ *   kernel-wide spinlock to exclude the other cores.
+ * - Making a thread ready on another core sends that core an inter-processor
+ *   interrupt, so that it can reschedule.
+ *
+ * Only supported on ports that provide SMP primitives (i.e. the host port).
+ */
+#if !defined(KERNEL_NUM_CORES)
+#define KERNEL_NUM_CORES (1)
+#endif
+#define KERNEL_SMP (KERNEL_NUM_CORES > 1)
+
+/**
+ * Set the number of time partitions.  Values greater than 1 enable ARINC-653
+ * style time-partitioned scheduling (see partitionscheduler.h):
+ *
+ * - Each thread belongs to one partition (see Thread::SetPartition()), and
+ *   each partition has its own ready lists and priority map.
+ * - A repeating major frame is divided into windows, each of which belongs to
+ *   one partition.  Only threads in the active window's partition, or in the
+ *   system partition (0), are eligible to run.
+ * - Threads are in the system partition unless assigned elsewhere, as must
+ *   be the kernel timer thread and idle thread(s).
+ */
+#if !defined(KERNEL_NUM_PARTITIONS)
+#define KERNEL_NUM_PARTITIONS (1)
+#endif
+#define KERNEL_PARTITIONS (KERNEL_NUM_PARTITIONS > 1)
+
 #include "portcfg.h" //!< include CPU/Port specific configuration options
+
+#if KERNEL_MULTI_INSTANCE
+#if !PORT_SUPPORTS_MULTI_INSTANCE
+#error "KERNEL_MULTI_INSTANCE is not supported by this port"
+#endif // #if !PORT_SUPPORTS_MULTI_INSTANCE
+//! Storage class applied to all per-kernel-instance state
+#define KERNEL_INSTANCE_STATE thread_local
+#else
+#define KERNEL_INSTANCE_STATE
+#endif // #if KERNEL_MULTI_INSTANCE
+
+#if KERNEL_SMP
+#if !PORT_SUPPORTS_SMP
+#error "KERNEL_NUM_CORES > 1 is not supported by this port"
+#endif // #if !PORT_SUPPORTS_SMP
+#if KERNEL_MULTI_INSTANCE
+#error "KERNEL_MULTI_INSTANCE and KERNEL_NUM_CORES > 1 are mutually exclusive"
+#endif // #if KERNEL_MULTI_INSTANCE
+#endif // #if KERNEL_SMP
+
+#if KERNEL_STACK_CHECK
+#if (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_SLACK) && !KERNEL_STACK_PAINT
+#error "KERNEL_STACK_GUARD_SLACK requires KERNEL_STACK_PAINT"
+#endif
+#if (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_MPU) && !PORT_SUPPORTS_STACK_GUARD_MPU
+#error "KERNEL_STACK_GUARD_MPU is not supported by this port"
+#endif
+#endif // #if KERNEL_STACK_CHECK
+
+#if KERNEL_TICKLESS
+#if !PORT_SUPPORTS_TICKLESS
+#error "KERNEL_TICKLESS is not supported by this port"
+#endif // #if !PORT_SUPPORTS_TICKLESS
+#if KERNEL_SMP
+#error "KERNEL_TICKLESS and KERNEL_NUM_CORES > 1 are mutually exclusive"
+#endif // #if KERNEL_SMP
+#endif // #if KERNEL_TICKLESS
+
+#if KERNEL_HIRES_TIMERS
+#if !PORT_SUPPORTS_HIRES_TIMER
+#error "KERNEL_HIRES_TIMERS is not supported by this port"
+#endif // #if !PORT_SUPPORTS_HIRES_TIMER
+#endif // #if KERNEL_HIRES_TIMERS
@@ -138,6 +138,16 @@ public:
      */
     void Release();
 
+    /**
+     *  @brief IsClaimed
+     *  Check whether the mutex is currently held by a thread.  Intended for
+     *  interrupt-context code that must not touch the data the mutex protects
+     *  while a thread is part-way through modifying it.
+     *
+     *  @return true if the mutex is claimed, false if it's available
+     */
+    bool IsClaimed() { return !m_bReady; }
+
 private:
     /**
      *  @brief WakeNext
@@ -52,6 +52,17 @@ public:
      */
     void Signal(void);
 
+#if KERNEL_DEFERRED_POST
+    /**
+     *  @brief SignalFromIsr
+     * Queue a Signal() of the notification object from an interrupt, to be
+     * carried out at the next scheduling decision (see DeferredPost).
+     *
+     * @return true if the request was queued, false if the queue is full
+     */
+    bool SignalFromIsr(void);
+#endif // #if KERNEL_DEFERRED_POST
+
     /**
      *  @brief Wait
      * Block the current thread, waiting for a signal on the
@@ -33,3 +33,5 @@ See license.txt for more information
 #define PANIC_ACTIVE_MAILBOX_DESCOPED (12)
 #define PANIC_ACTIVE_TIMER_DESCOPED (13)
 #define PANIC_ACTIVE_COROUTINE_DESCOPED (14)
+#define PANIC_PARTITION_INVALID (15)
+#define PANIC_EDF_HEAP_FULL (16)
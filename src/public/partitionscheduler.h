@@ -0,0 +1,127 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   partitionscheduler.h
+
+    @brief  Time-partitioned scheduling (ARINC-653 style major/minor frames)
+
+    When KERNEL_NUM_PARTITIONS is greater than 1, each thread belongs to a
+    time partition (Thread::SetPartition()).  The scheduler keeps a separate
+    set of ready lists and priority map for each partition, and only
+    consults those of the active partition - along with those of the system
+    partition (0), whose threads are eligible at all times.  The kernel timer
+    thread and idle threads must remain in the system partition.
+
+    The active partition is selected by a schedule of windows, which repeats
+    every major frame.  Switching windows is just a change of which priority
+    map the scheduler reads, performed from the kernel timer thread; a
+    partition overrunning its window is preempted, so partitions are
+    isolated from each other in time without each thread having to police
+    its own use of the CPU.
+
+    @code
+
+    // 10ms major frame - 4ms for the safety partition, 2ms for comms, and
+    // 4ms shared by the other threads in the system partition.
+    static const PartitionWindow astFrame[] = {
+        { 1, 4 },
+        { 2, 2 },
+        { 0, 4 },
+    };
+    ...
+    clControlThread.SetPartition(1);
+    clNetThread.SetPartition(2);
+    PartitionScheduler::SetSchedule(astFrame, 3);
+
+    @endcode
+ */
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#if KERNEL_PARTITIONS
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+/**
+ * A single window within a major frame, during which one partition runs
+ */
+struct PartitionWindow {
+    uint8_t  u8Partition; //!< Partition active during the window
+    uint16_t u16Ticks;    //!< Length of the window, in ticks
+};
+
+//---------------------------------------------------------------------------
+/**
+ * @brief The PartitionScheduler Class.
+ * Static-class used to switch the active partition according to a
+ * repeating schedule of windows.
+ */
+class PartitionScheduler
+{
+public:
+    /**
+     * @brief SetSchedule
+     * Set the schedule of windows making up the major frame, and start the
+     * first window.  The schedule is used in place, and must remain valid
+     * for as long as it's in use.
+     *
+     * A schedule naming a partition outside of KERNEL_NUM_PARTITIONS, or
+     * holding an empty window, raises PANIC_PARTITION_INVALID and is not
+     * used.
+     *
+     * @param pastWindows_ Array of windows, in the order they are run
+     * @param u8NumWindows_ Number of windows in the array
+     */
+    static void SetSchedule(const PartitionWindow* pastWindows_, uint8_t u8NumWindows_);
+
+    /**
+     * @brief Process
+     * Advance the schedule by a number of elapsed ticks, switching partition
+     * at the end of each window.  Called from the timer thread for each
+     * timer epoch.
+     *
+     * @param u32Ticks_ Number of ticks elapsed
+     */
+    static void Process(uint32_t u32Ticks_);
+
+    /**
+     * @brief GetWindow
+     * @return Index of the current window within the schedule
+     */
+    static uint8_t GetWindow() { return m_u8Window; }
+
+    /**
+     * @brief GetTicksRemaining
+     * @return Ticks left until the end of the current window, or 0 if no
+     *         schedule has been set
+     */
+    static uint32_t GetTicksRemaining() { return (nullptr != m_pastWindows) ? m_u32TicksRemain : 0; }
+
+private:
+    /**
+     * @brief StartWindow
+     * Activate the partition of the current window
+     */
+    static void StartWindow();
+
+    static KERNEL_INSTANCE_STATE const PartitionWindow* m_pastWindows;
+    static KERNEL_INSTANCE_STATE uint8_t                m_u8NumWindows;
+    static KERNEL_INSTANCE_STATE uint8_t                m_u8Window;
+    static KERNEL_INSTANCE_STATE uint32_t               m_u32TicksRemain; //!< Ticks left in the current window
+};
+} // namespace Mark3
+#endif // #if KERNEL_PARTITIONS
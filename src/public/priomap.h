@@ -23,11 +23,9 @@ See license.txt for more information
 
 #include "priomapl1.h"
 #include "priomapl2.h"
+#include "priomapn.h"
 
 namespace Mark3 {
-#if KERNEL_NUM_PRIORITIES <= (PORT_PRIO_MAP_WORD_SIZE * 8u)
-using PriorityMap = PriorityMapL1<PORT_PRIO_TYPE, KERNEL_NUM_PRIORITIES>;
-#else
-using PriorityMap = PriorityMapL2<PORT_PRIO_TYPE, KERNEL_NUM_PRIORITIES>;
-#endif
+// Number of levels is selected by the template based on KERNEL_NUM_PRIORITIES
+using PriorityMap = PriorityMapN<PORT_PRIO_TYPE, KERNEL_NUM_PRIORITIES>;
 } // namespace Mark3
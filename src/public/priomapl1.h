@@ -62,7 +62,7 @@ public:
     void Set(T uXPrio_)
     {
         auto uXPrioBit = PrioBit(uXPrio_);
-        m_uXPriorityMap |= (1 << uXPrioBit);
+        m_uXPriorityMap |= (T { 1 } << uXPrioBit);
     }
 
     /**
@@ -73,7 +73,7 @@ public:
     void Clear(T uXPrio_)
     {
         auto uXPrioBit = PrioBit(uXPrio_);
-        m_uXPriorityMap &= ~(1 << uXPrioBit);
+        m_uXPriorityMap &= ~(T { 1 } << uXPrioBit);
     }
 
     /**
@@ -101,7 +101,7 @@ private:
         return m_uXPrioMapBits - PORT_CLZ(uXPrio_);
 #else
         // Default un-optimized count-leading zeros operation
-        T uXMask  = 1 << (m_uXPrioMapBits - 1);
+        T uXMask  = T { 1 } << (m_uXPrioMapBits - 1);
         auto           u8Zeros = T { 0 };
 
         while (uXMask) {
@@ -119,7 +119,7 @@ private:
     static constexpr size_t m_uXPrioMapShiftLUT[9] = {0, 3, 4, 0, 5, 0, 0, 0, 6};
     static constexpr auto m_uXPrioMapWordShift = T { m_uXPrioMapShiftLUT[sizeof(T)] };
     static constexpr auto m_uXPrioMapBits    = T { 8 * sizeof(T) };
-    static constexpr auto m_uXPrioMapBitMask = T { (1 << m_uXPrioMapWordShift) - 1 };
+    static constexpr auto m_uXPrioMapBitMask = T { (T { 1 } << m_uXPrioMapWordShift) - 1 };
 
     T m_uXPriorityMap;
 };
@@ -70,8 +70,8 @@ public:
         auto uXPrioBit = PrioBit(uXPrio_);
         auto uXWordIdx = PrioMapWordIndex(uXPrio_);
 
-        m_auXPriorityMap[uXWordIdx] |= (1 << uXPrioBit);
-        m_uXPriorityMapL2 |= (1 << uXWordIdx);
+        m_auXPriorityMap[uXWordIdx] |= (T { 1 } << uXPrioBit);
+        m_uXPriorityMapL2 |= (T { 1 } << uXWordIdx);
     }
 
     /**
@@ -84,9 +84,9 @@ public:
         auto uXPrioBit = PrioBit(uXPrio_);
         auto uXWordIdx = PrioMapWordIndex(uXPrio_);
 
-        m_auXPriorityMap[uXWordIdx] &= ~(1 << uXPrioBit);
+        m_auXPriorityMap[uXWordIdx] &= ~(T { 1 } << uXPrioBit);
         if (!m_auXPriorityMap[uXWordIdx]) {
-            m_uXPriorityMapL2 &= ~(1 << uXWordIdx);
+            m_uXPriorityMapL2 &= ~(T { 1 } << uXWordIdx);
         }
     }
 
@@ -121,7 +121,7 @@ private:
         return m_uXPrioMapBits - PORT_CLZ(uXPrio_);
 #else
         // Default un-optimized count-leading zeros operation
-        T uXMask  = 1 << (m_uXPrioMapBits - 1);
+        T uXMask  = T { 1 } << (m_uXPrioMapBits - 1);
         auto           u8Zeros = T { 0 };
 
         while (uXMask) {
@@ -139,7 +139,7 @@ private:
     static constexpr size_t m_uXPrioMapShiftLUT[9] = {0, 3, 4, 0, 5, 0, 0, 0, 6};
     static constexpr auto m_uXPrioMapWordShift = T { m_uXPrioMapShiftLUT[sizeof(T)] };
     static constexpr auto m_uXPrioMapBits    = T { 8 * sizeof(T) };
-    static constexpr auto m_uXPrioMapBitMask = T { (1 << m_uXPrioMapWordShift) - 1 };
+    static constexpr auto m_uXPrioMapBitMask = T { (T { 1 } << m_uXPrioMapWordShift) - 1 };
 
     // Required size of the bitmap array in words
     static constexpr auto m_uXPrioMapNumWords
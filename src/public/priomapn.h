@@ -0,0 +1,225 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   priomapn.h
+
+    @brief  N-Level priority allocator template-class used for scheduler implementation
+*/
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+#include "threadport.h"
+
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+/**
+ * @brief The PriorityMapWord class
+ * Bit-manipulation helpers shared by each level of a PriorityMapN, for words
+ * of type "T" (8, 16, 32, or 64-bit unsigned integers).
+ */
+template <typename T>
+class PriorityMapWord
+{
+public:
+    static_assert((1 == sizeof(T)) || (2 == sizeof(T)) || (4 == sizeof(T)) || (8 == sizeof(T)),
+                  "Priority map words must be 8, 16, 32, or 64-bit");
+
+    static constexpr auto m_uXPrioMapBits = T { 8 * sizeof(T) };
+    static constexpr auto m_uXPrioMapWordShift
+        = T { (1 == sizeof(T)) ? 3 : (2 == sizeof(T)) ? 4 : (4 == sizeof(T)) ? 5 : 6 };
+    static constexpr auto m_uXPrioMapBitMask = T { m_uXPrioMapBits - 1 };
+
+    static inline T PrioBit(T uXPrio_) { return static_cast<T>(T { 1 } << (uXPrio_ & m_uXPrioMapBitMask)); }
+
+    static inline T PrioMapWordIndex(T uXPrio_) { return static_cast<T>(uXPrio_ >> m_uXPrioMapWordShift); }
+
+    /**
+     * @brief PriorityFromBitmap
+     * @param uXWord_ Bitmap word to search
+     * @return One plus the index of the most-significant set bit, or 0 if
+     *         no bits are set.
+     */
+    static inline T PriorityFromBitmap(T uXWord_)
+    {
+        if (0 == uXWord_) {
+            return 0;
+        }
+#if PORT_USE_HW_CLZ
+        // Support hardware-accelerated Count-leading-zeros instruction, where
+        // it operates on words of this size
+        if (sizeof(T) == PORT_PRIO_MAP_WORD_SIZE) {
+            return static_cast<T>(m_uXPrioMapBits - PORT_CLZ(uXWord_));
+        }
+#endif
+        // Binary search for the most-significant bit
+        auto uXBit = T { 1 };
+        for (auto uXShift = T { m_uXPrioMapBits / 2 }; 0 != uXShift; uXShift >>= 1) {
+            if (0 != (uXWord_ >> uXShift)) {
+                uXWord_ >>= uXShift;
+                uXBit += uXShift;
+            }
+        }
+        return uXBit;
+    }
+};
+
+//---------------------------------------------------------------------------
+/**
+ * @brief The PriorityMapN class
+ * This class implements a priority bitmap data structure.  Each bit in the
+ * objects internal storage represents a priority.  When a bit is set, it
+ * indicates that something is scheduled at the bit's corresponding priority,
+ * when a bit is clear it indicates that no entities are scheduled at that
+ * priority.
+ *
+ * The N-level version of the datastructure supports any number of priorities
+ * ("C"), using as many levels as required for words of type "T".  The first
+ * level is an array with one bit per priority; each subsequent level has one
+ * bit per word of the level below it, until a level fits in a single word.
+ * With n-bit words, L levels support n^L priorities - i.e. 4096 priorities
+ * take three levels of 16-bit words, or two levels of 64-bit words.
+ *
+ * Set() and Clear() touch the next level up only when a word changes between
+ * empty and non-empty, and HighestPriority() is one count-leading-zeros
+ * operation per level.  The depth is resolved at compile time.
+ */
+template <typename T, size_t C, bool = (C <= (8 * sizeof(T)))>
+class PriorityMapN;
+
+//---------------------------------------------------------------------------
+/**
+ * @brief PriorityMapN specialization for priorities which fit in a single word
+ */
+template <typename T, size_t C>
+class PriorityMapN<T, C, true> : private PriorityMapWord<T>
+{
+public:
+    using Word = PriorityMapWord<T>;
+
+    /**
+     * @brief PriorityMapN
+     * Initialize the priority map object, clearing the bitamp data to all 0's.
+     */
+    PriorityMapN() { m_uXPriorityMap = 0; }
+
+    /**
+     * @brief Set
+     * Set the priority map bitmap data, at all levels, for the given priority
+     * @param uXPrio_   Priority level to set the bitmap data for.
+     */
+    void Set(T uXPrio_) { m_uXPriorityMap |= Word::PrioBit(uXPrio_); }
+
+    /**
+     * @brief Clear
+     * Clear the priority map bitmap data, at all levels, for the given priority.
+     * @param uXPrio_   Priority level to clear the bitmap data for.
+     */
+    void Clear(T uXPrio_) { m_uXPriorityMap &= static_cast<T>(~Word::PrioBit(uXPrio_)); }
+
+    /**
+     * @brief HighestPriority
+     * Computes the numeric priority of the highest-priority thread represented in the
+     * priority map.
+     *
+     * @return Highest priority ready-thread's number, plus one (0 if none are set)
+     */
+    T HighestPriority(void) { return Word::PriorityFromBitmap(m_uXPriorityMap); }
+
+private:
+    // HighestPriority() returns the priority plus one, which must fit in T
+    static_assert(C <= static_cast<T>(~T { 0 }), "Priority map word type too small for the number of priorities");
+
+    T m_uXPriorityMap;
+};
+
+//---------------------------------------------------------------------------
+/**
+ * @brief PriorityMapN specialization for priorities spanning multiple words,
+ *        with one bit per word in the next level.
+ */
+template <typename T, size_t C>
+class PriorityMapN<T, C, false> : private PriorityMapWord<T>
+{
+public:
+    using Word = PriorityMapWord<T>;
+
+    /**
+     * @brief PriorityMapN
+     * Initialize the priority map object, clearing the bitamp data to all 0's.
+     */
+    PriorityMapN()
+    {
+        for (auto& uXWord : m_auXPriorityMap) { uXWord = 0; }
+    }
+
+    /**
+     * @brief Set
+     * Set the priority map bitmap data, at all levels, for the given priority
+     * @param uXPrio_   Priority level to set the bitmap data for.
+     */
+    void Set(T uXPrio_)
+    {
+        auto uXWordIdx = Word::PrioMapWordIndex(uXPrio_);
+        if (0 == m_auXPriorityMap[uXWordIdx]) {
+            m_clUpper.Set(uXWordIdx);
+        }
+        m_auXPriorityMap[uXWordIdx] |= Word::PrioBit(uXPrio_);
+    }
+
+    /**
+     * @brief Clear
+     * Clear the priority map bitmap data, at all levels, for the given priority.
+     * @param uXPrio_   Priority level to clear the bitmap data for.
+     */
+    void Clear(T uXPrio_)
+    {
+        auto uXWordIdx = Word::PrioMapWordIndex(uXPrio_);
+        m_auXPriorityMap[uXWordIdx] &= static_cast<T>(~Word::PrioBit(uXPrio_));
+        if (0 == m_auXPriorityMap[uXWordIdx]) {
+            m_clUpper.Clear(uXWordIdx);
+        }
+    }
+
+    /**
+     * @brief HighestPriority
+     * Computes the numeric priority of the highest-priority thread represented in the
+     * priority map.
+     *
+     * @return Highest priority ready-thread's number, plus one (0 if none are set)
+     */
+    T HighestPriority(void)
+    {
+        auto uXWordIdx = m_clUpper.HighestPriority();
+        if (0 == uXWordIdx) {
+            return 0;
+        }
+        uXWordIdx--;
+        return static_cast<T>((uXWordIdx << Word::m_uXPrioMapWordShift)
+                              + Word::PriorityFromBitmap(m_auXPriorityMap[uXWordIdx]));
+    }
+
+private:
+    // Required size of this level's bitmap array in words
+    static constexpr auto m_uNumWords = size_t { (C + (Word::m_uXPrioMapBits - 1)) / Word::m_uXPrioMapBits };
+
+    // HighestPriority() returns the priority plus one, which must fit in T
+    static_assert(C <= static_cast<T>(~T { 0 }), "Priority map word type too small for the number of priorities");
+
+    T                            m_auXPriorityMap[m_uNumWords];
+    PriorityMapN<T, m_uNumWords> m_clUpper; //!< One bit per word of m_auXPriorityMap
+};
+} // namespace Mark3
@@ -45,7 +45,20 @@ See license.txt for more information
     // Get the execution time from the last iteration
     u32LastTimer = clMyTimer.GetCurrent();
 
+    // Get the best/worst case, and the number of iterations that took
+    // between 2^(n-1) and 2^n - 1 cycles
+    u32Best  = clMyTimer.GetMin();
+    u32Worst = clMyTimer.GetMax();
+    u32Count = clMyTimer.GetHistogram(n);
+
     @endcode
+
+    All values are given in cycles of the port's free-running counter (see
+    KernelTimer::GetCycleCount()), or, when KERNEL_COST_MODEL is enabled,
+    in estimated target CPU cycles (see costmodel.h).  Each iteration must
+    be shorter than one wrap of that 32-bit counter.  Timers only contain
+    counters and fixed-size statistics, so they're cheap enough to leave in
+    production builds.
  */
 
 #pragma once
@@ -92,24 +105,58 @@ public:
      *  @brief GetAverage
      *  Get the average time associated with this operation.
      *
-     *  @return Average tick count normalized over all iterations
+     *  @return Average cycle count normalized over all iterations
      */
     uint32_t GetAverage();
 
     /**
      *  @brief GetCurrent
-     *  Return the current tick count held by the profiler.  Valid
+     *  Return the current cycle count held by the profiler.  Valid
      *  for both active and stopped timers.
      *
-     *  @return The currently held tick count.
+     *  @return The currently held cycle count.
      */
     uint32_t GetCurrent();
 
+    /**
+     *  @brief GetMin
+     *  @return Shortest iteration recorded since Init(), or 0 if none
+     */
+    uint32_t GetMin() { return (0u != m_u32Iterations) ? m_u32Min : 0; }
+
+    /**
+     *  @brief GetMax
+     *  @return Longest iteration recorded since Init()
+     */
+    uint32_t GetMax() { return m_u32Max; }
+
+    /**
+     *  @brief GetIterations
+     *  @return Number of iterations recorded since Init()
+     */
+    uint32_t GetIterations() { return m_u32Iterations; }
+
+    /**
+     *  @brief GetHistogram
+     *  Return the number of iterations in a log2 histogram bucket.  Bucket 0
+     *  holds iterations of 0 cycles, and bucket n holds iterations of 2^(n-1)
+     *  to 2^n - 1 cycles; the last bucket also holds all longer iterations.
+     *
+     *  @param u8Bucket_ Bucket index, from 0 to m_uNumBuckets - 1
+     *  @return Number of iterations in the bucket
+     */
+    uint32_t GetHistogram(uint8_t u8Bucket_) { return m_au32Histogram[u8Bucket_]; }
+
+    static constexpr auto m_uNumBuckets = uint8_t { 16 }; //!< Number of log2 histogram buckets
+
 private:
-    uint32_t m_u32StartTicks;       //!< Cumulative tick-count for this timer
-    uint32_t m_u32CurrentIteration; //!< Tick count for current iteration.
-    uint32_t m_u32Cumulative;       //!< Cumulative ticks tracked
-    uint16_t m_u16Iterations;       //!< Number of iterations executed for this profiling timer
-    bool     m_bActive;             //!< Wheter or not the timer is active or stopped
+    uint32_t m_u32StartTicks;                //!< Counter value at the start of the current iteration
+    uint32_t m_u32CurrentIteration;          //!< Cycle count for current iteration.
+    uint64_t m_u64Cumulative;                //!< Cumulative cycles tracked
+    uint32_t m_u32Iterations;                //!< Number of iterations executed for this profiling timer
+    uint32_t m_u32Min;                       //!< Shortest iteration
+    uint32_t m_u32Max;                       //!< Longest iteration
+    uint32_t m_au32Histogram[m_uNumBuckets]; //!< log2 histogram of iteration lengths
+    bool     m_bActive;                      //!< Wheter or not the timer is active or stopped
 };
 } // namespace Mark3
@@ -83,11 +83,22 @@ public:
      */
     static void Cancel();
 
+    /**
+     * @brief Remove
+     * Stop tracking a thread that's being stopped or exited, so that its
+     * quantum can't expire once it's no longer in a ready list.
+     *
+     * @param pclThread_ Thread leaving the scheduler
+     */
+    static void Remove(Thread* pclThread_);
+
 private:
-    static Thread*  m_pclActiveThread;
-    static Thread*  m_pclTimerThread;
-    static uint16_t m_u16TicksRemain;
-    static bool     m_bInTimer;
+    //! Thread whose quantum is being tracked, and its remaining ticks (per core)
+    static KERNEL_INSTANCE_STATE Thread*  m_apclActiveThread[KERNEL_NUM_CORES];
+    static KERNEL_INSTANCE_STATE uint16_t m_au16TicksRemain[KERNEL_NUM_CORES];
+
+    static KERNEL_INSTANCE_STATE Thread*  m_pclTimerThread;
+    static KERNEL_INSTANCE_STATE bool     m_bInTimer;
 };
 } // namespace Mark3
 #endif // #if KERNEL_ROUND_ROBIN
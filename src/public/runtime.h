@@ -0,0 +1,144 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   runtime.h
+
+    @brief  Per-thread CPU time accounting
+
+    When KERNEL_RUN_TIME is enabled, the kernel reads the port's cycle counter
+    (KernelTimer::GetCycleCount()) on every context switch, and adds the
+    cycles elapsed since the previous switch on that core to the run time of
+    the thread being switched out.  Cycles spent in threads at priority 0 are
+    also added to the idle time.
+
+    Run time is accumulated in 64 bits, so it doesn't wrap in practice.  The
+    cycle counter itself is 32 bits, so a thread must not run for longer than
+    one period of the counter without a context switch; the kernel timer
+    thread normally guarantees this.
+
+    @code
+
+    static RunTimeSample astSamples[8];
+
+    // Report the share of the CPU used by each thread since the last call
+    auto u16Count = RunTime::Snapshot(astSamples, 8);
+    for (uint16_t i = 0; i < u16Count; i++) {
+        Report(astSamples[i].pclThread, astSamples[i].u64RunTime);
+    }
+    Report(nullptr, RunTime::GetIdleTime());
+
+    @endcode
+
+    As with ProfileTimer, times are in estimated target cycles instead when
+    KERNEL_COST_MODEL is enabled.
+ */
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#if KERNEL_RUN_TIME
+namespace Mark3
+{
+class Thread;
+
+//---------------------------------------------------------------------------
+/**
+ * Run time of a single thread, as captured by RunTime::Snapshot()
+ */
+struct RunTimeSample {
+    Thread*  pclThread;  //!< Thread sampled
+    uint64_t u64RunTime; //!< Cycles the thread had run for
+};
+
+//---------------------------------------------------------------------------
+/**
+ * @brief The RunTime Class.
+ * Static-class used to account for the CPU time used by each thread.
+ */
+class RunTime
+{
+public:
+    /**
+     * @brief Start
+     * Start timing the first slice on each core.  Called when the kernel is
+     * started.
+     */
+    static void Start();
+
+    /**
+     * @brief Update
+     * Charge the thread running on the current core for the cycles elapsed
+     * since the last update on the core.  Called from the context switch
+     * path, and before reading run times.
+     */
+    static void Update();
+
+    /**
+     * @brief Add
+     * Add a thread to the set reported by Snapshot().  Called when the thread
+     * is initialized.
+     *
+     * @param pclThread_ Thread to add
+     */
+    static void Add(Thread* pclThread_);
+
+    /**
+     * @brief Remove
+     * Remove a thread from the set reported by Snapshot().  Called when the
+     * thread exits.
+     *
+     * @param pclThread_ Thread to remove
+     */
+    static void Remove(Thread* pclThread_);
+
+    /**
+     * @brief GetRunTime
+     * Return the run time of a thread, including the slice in progress if
+     * the thread is running on the current core.  See Thread::GetRunTime().
+     *
+     * @param pclThread_ Thread to read
+     * @return Cycles the thread has run for
+     */
+    static uint64_t GetRunTime(Thread* pclThread_);
+
+    /**
+     * @brief GetIdleTime
+     * @return Cycles spent running threads at priority 0, over all cores
+     */
+    static uint64_t GetIdleTime();
+
+    /**
+     * @brief Snapshot
+     * Capture the run times of all initialized threads at a single instant.
+     *
+     * @param pastSamples_ Array to fill, one entry per thread
+     * @param u16MaxSamples_ Number of entries in the array
+     * @return Number of entries filled in
+     */
+    static uint16_t Snapshot(RunTimeSample* pastSamples_, uint16_t u16MaxSamples_);
+
+private:
+    //! Cycle count at the last update on each core
+    static KERNEL_INSTANCE_STATE uint32_t m_au32LastUpdate[KERNEL_NUM_CORES];
+
+    //! Cycles spent in threads at priority 0, on each core
+    static KERNEL_INSTANCE_STATE uint64_t m_au64IdleTime[KERNEL_NUM_CORES];
+
+    //! Head of the list of initialized threads, linked through Thread::m_pclRunTimeNext
+    static KERNEL_INSTANCE_STATE Thread* m_pclThreads;
+};
+} // namespace Mark3
+#endif // #if KERNEL_RUN_TIME
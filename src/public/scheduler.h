@@ -48,9 +48,19 @@ See license.txt for more information
 #include "thread.h"
 #include "ithreadport.h"
 #include "priomap.h"
+#include "deadlineheap.h"
 
-extern Mark3::Thread* g_pclNext;
-extern Mark3::Thread* g_pclCurrent;
+#if KERNEL_SMP
+extern Mark3::Thread* g_apclNext[KERNEL_NUM_CORES];
+extern Mark3::Thread* g_apclCurrent[KERNEL_NUM_CORES];
+
+//! In SMP mode, the current/next thread are those of the executing core
+#define g_pclNext (g_apclNext[Mark3::ThreadPort::GetCoreId()])
+#define g_pclCurrent (g_apclCurrent[Mark3::ThreadPort::GetCoreId()])
+#else
+extern KERNEL_INSTANCE_STATE Mark3::Thread* g_pclNext;
+extern KERNEL_INSTANCE_STATE Mark3::Thread* g_pclCurrent;
+#endif // #if KERNEL_SMP
 
 namespace Mark3
 {
@@ -79,7 +89,10 @@ public:
 
     /**
      *  @brief Add
-     *  Add a thread to the scheduler at its current priority level.
+     *  Add a thread to the scheduler at its current priority level.  In SMP
+     *  mode, the thread is added to the ready lists of its assigned core; if
+     *  that's another core, and the thread should preempt whatever it's
+     *  running, that core is sent an inter-processor interrupt.
      *
      *  @param pclThread_ Pointer to the thread to add to the scheduler
      */
@@ -95,15 +108,61 @@ public:
     static void Remove(Thread* pclThread_);
 
     /**
-     *  @brief SetScheduler
-     *  Set the active state of the scheduler.  When the scheduler is
-     *  disabled, the *next thread* is never set; the currently
-     *  running thread will run forever until the scheduler is enabled
-     *  again.  Care must be taken to ensure that we don't end up
+     *  @brief WillPreempt
+     *  Determine whether a thread that has just been made ready should
+     *  preempt the current thread - i.e. whether it's worth running the
+     *  scheduler.  A thread preempts the current thread if it has the same
+     *  or higher priority, or, where the current thread has a preemption
+     *  threshold, if it has a higher priority than the threshold.
+     *
+     *  @param pclThread_ Thread that has been made ready
+     *  @return true if the scheduler should be run
+     */
+    static bool WillPreempt(Thread* pclThread_);
+
+    /**
+     *  @brief Lock
+     *  Disable the scheduler, or increase the nesting depth if it's already
+     *  disabled.  While the scheduler is disabled, the *next thread* is never
+     *  set; the currently running thread will run until the scheduler is
+     *  enabled again.  Care must be taken to ensure that we don't end up
      *  trying to block while the scheduler is disabled, otherwise the
      *  system ends up in an unusable state.
      *
+     *  In SMP mode, this applies to the current core only.  As disabling
+     *  the local scheduler doesn't keep the other cores out of the data it
+     *  protects, the kernel lock is also held while the scheduler is disabled.
+     */
+    static void Lock();
+
+    /**
+     *  @brief Unlock
+     *  Undo one call to Lock().  When the outermost lock is released, the
+     *  scheduler is re-enabled, and if any thread switches were requested
+     *  while it was disabled, it's run once.
+     */
+    static void Unlock();
+
+    /**
+     *  @brief SetScheduler
+     *  Set the active state of the scheduler.  Disabling an enabled scheduler
+     *  takes the lock (as Lock()), and has no effect if it's already disabled;
+     *  enabling a disabled scheduler releases the lock however deeply it's
+     *  nested, running any queued thread switch.  As a result, the previous
+     *  state can always be restored by passing back the return value:
+     *
+     *  @code
+     *  auto bEnabled = Scheduler::SetScheduler(false);
+     *  ...
+     *  Scheduler::SetScheduler(bEnabled);
+     *  @endcode
+     *
+     *  Enabling the scheduler cancels every outstanding Lock(), so within a
+     *  Lock()/Unlock() pair (or a SchedulerGuard), only restore the state
+     *  returned by an earlier call.
+     *
      *  @param bEnable_ true to enable, false to disable the scheduler
+     *  @return true if the scheduler was enabled before the call
      */
     static bool SetScheduler(bool bEnable_);
 
@@ -122,16 +181,77 @@ public:
      *  @return Pointer to the next-running thread
      */
     static volatile Thread* GetNextThread() { return g_pclNext; }
+    /**
+     *  @brief GetCurrentCore
+     *  Return the index of the core executing the caller.
+     *
+     *  @return Index of the current core (always 0 unless running in SMP mode)
+     */
+    static uint8_t GetCurrentCore()
+    {
+#if KERNEL_SMP
+        return ThreadPort::GetCoreId();
+#else
+        return 0;
+#endif // #if KERNEL_SMP
+    }
     /**
      *  @brief GetThreadList
      *  Return the pointer to the active list of threads that are at the
      *  given priority level in the scheduler.
      *
      *  @param uXPriority_ Priority level of the threadlist
+     *  @param u8Core_ Core whose ready lists are to be used
+     *  @param u8Partition_ Partition whose ready lists are to be used
+     *
+     *  @return Pointer to the ThreadList for the given priority level
+     */
+    static ThreadList* GetThreadList(PORT_PRIO_TYPE uXPriority_, uint8_t u8Core_, uint8_t u8Partition_)
+    {
+        return &m_aclPriorities[u8Core_][u8Partition_][uXPriority_];
+    }
+    /**
+     *  @brief GetThreadList
+     *  Return the pointer to the active list of threads that are at the
+     *  given priority level on core 0, in the system partition.
+     *
+     *  @param uXPriority_ Priority level of the threadlist
      *
      *  @return Pointer to the ThreadList for the given priority level
      */
-    static ThreadList* GetThreadList(PORT_PRIO_TYPE uXPriority_) { return &m_aclPriorities[uXPriority_]; }
+    static ThreadList* GetThreadList(PORT_PRIO_TYPE uXPriority_) { return GetThreadList(uXPriority_, 0, 0); }
+#if KERNEL_SMP
+    /**
+     *  @brief AssignCore
+     *  Pick the core for a newly-initialized thread, spreading threads that
+     *  aren't explicitly assigned across all cores in turn.  The rotation
+     *  restarts from core 0 each time the scheduler is initialized.
+     *
+     *  @return Index of the core to assign
+     */
+    static uint8_t AssignCore();
+#endif // #if KERNEL_SMP
+#if KERNEL_PARTITIONS
+    /**
+     *  @brief SetActivePartition
+     *  Select the partition whose threads are eligible to run (along with
+     *  those of the system partition, 0).  Called by the PartitionScheduler
+     *  at the start of each window; takes effect the next time the
+     *  scheduler runs on each core.
+     *
+     *  @param u8Partition_ Partition to activate
+     */
+    static void SetActivePartition(uint8_t u8Partition_) { m_u8ActivePartition = u8Partition_; }
+    /**
+     *  @brief GetActivePartition
+     *  Return the partition whose threads are currently eligible to run.
+     *
+     *  @return Index of the active partition
+     */
+    static uint8_t GetActivePartition() { return m_u8ActivePartition; }
+#else
+    static uint8_t GetActivePartition() { return 0; }
+#endif // #if KERNEL_PARTITIONS
     /**
      *  @brief GetStopList
      *  Return the pointer to the list of threads that are in the
@@ -147,30 +267,67 @@ public:
      *
      *  @return true - scheduler enabled, false - disabled
      */
-    static bool IsEnabled() { return m_bEnabled; }
+    static bool IsEnabled() { return 0 == m_au8LockCount[GetCurrentCore()]; }
     /**
      *  @brief QueueScheduler
      *  Tell the kernel to perform a scheduling operation as soon as the
      *  scheduler is re-enabled.
      */
-    static void QueueScheduler() { m_bQueuedSchedule = true; }
+    static void QueueScheduler() { m_abQueuedSchedule[GetCurrentCore()] = true; }
 
 private:
     static constexpr auto m_uNumPriorities = size_t { KERNEL_NUM_PRIORITIES };
+    static constexpr auto m_uNumCores      = size_t { KERNEL_NUM_CORES };
+    static constexpr auto m_uNumPartitions = size_t { KERNEL_NUM_PARTITIONS };
+
+    /**
+     *  @brief IsEligible
+     *  Return whether a thread's partition is currently allowed to run.
+     *
+     *  @param pclThread_ Thread to check
+     *  @return true if the thread is in the system partition or the active partition
+     */
+    static bool IsEligible(Thread* pclThread_);
+
+    //! Scheduler lock nesting depth (per core) - the scheduler is enabled when 0
+    static KERNEL_INSTANCE_STATE uint8_t m_au8LockCount[m_uNumCores];
 
-    //! Scheduler's state - enabled or disabled
-    static bool m_bEnabled;
+    //! Variable representing whether or not there's a queued scheduler operation (per core)
+    static KERNEL_INSTANCE_STATE bool m_abQueuedSchedule[m_uNumCores];
 
-    //! Variable representing whether or not there's a queued scheduler operation
-    static bool m_bQueuedSchedule;
+#if KERNEL_SMP
+    //! Whether disabling the scheduler took the kernel lock (per core)
+    static bool m_abLockHeld[m_uNumCores];
+
+    //! Core to be assigned to the next thread initialized
+    static KERNEL_INSTANCE_STATE uint8_t m_u8NextCore;
+#endif // #if KERNEL_SMP
 
     //! ThreadList for all stopped threads
-    static ThreadList m_clStopList;
+    static KERNEL_INSTANCE_STATE ThreadList m_clStopList;
+
+    //! ThreadLists for all threads at all priorities, for each core and partition
+    static KERNEL_INSTANCE_STATE ThreadList m_aclPriorities[m_uNumCores][m_uNumPartitions][m_uNumPriorities];
+
+    //! Priority bitmap lookup structures, 1-bit per thread priority, for each core and partition
+    static KERNEL_INSTANCE_STATE PriorityMap m_aclPrioMap[m_uNumCores][m_uNumPartitions];
+
+#if KERNEL_PARTITIONS
+    //! Partition whose threads are eligible to run, in addition to the system partition
+    static KERNEL_INSTANCE_STATE uint8_t m_u8ActivePartition;
+#endif // #if KERNEL_PARTITIONS
+
+#if KERNEL_EDF
+    static_assert(KERNEL_EDF_PRIORITY < KERNEL_NUM_PRIORITIES, "KERNEL_EDF_PRIORITY must be a valid priority");
 
-    //! ThreadLists for all threads at all priorities
-    static ThreadList m_aclPriorities[m_uNumPriorities];
+    //! Ready threads at KERNEL_EDF_PRIORITY, ordered by deadline, for each core and partition
+    static KERNEL_INSTANCE_STATE DeadlineHeap m_aclDeadlines[m_uNumCores][m_uNumPartitions];
+#endif // #if KERNEL_EDF
 
-    //! Priority bitmap lookup structure, 1-bit per thread priority.
-    static PriorityMap m_clPrioMap;
+#if KERNEL_PREEMPT_THRESHOLD
+    //! Most recently scheduled thread with a preemption threshold, for each
+    //! core.  Threads it preempted are chained through Thread::m_pclPreempted.
+    static KERNEL_INSTANCE_STATE Thread* m_apclProtected[m_uNumCores];
+#endif // #if KERNEL_PREEMPT_THRESHOLD
 };
 } // namespace Mark3
@@ -27,9 +27,10 @@ namespace Mark3 {
 /**
  * @brief The SchedulerGuard class
  * This class implements RAII-based control of the scheduler's
- * global state.  Upon object construction, the scheduler's state is
- * cached locally and the scheduler is disabled (if not already disabled).
- * Upon object destruction, the scheduler's previous state is restored.
+ * global state.  Upon object construction, the scheduler lock is taken
+ * (see Scheduler::Lock()); upon object destruction, it's released.  Guards
+ * may be nested - the scheduler is only re-enabled, and any thread switch
+ * requested in the meantime performed, when the outermost guard is destroyed.
  * This object is interrupt-safe, although it has no effect when called from
  * an interrupt given that interrupts are inherently higher-priority than
  * threads.
@@ -38,16 +39,13 @@ class SchedulerGuard {
 public:
     SchedulerGuard()
     {
-        m_bSchedState = Scheduler::SetScheduler(false);
+        Scheduler::Lock();
     }
 
     ~SchedulerGuard()
     {
-        Scheduler::SetScheduler(m_bSchedState);
+        Scheduler::Unlock();
     }
-
-private:
-    bool m_bSchedState;
 };
 
 } // namespace Mark3
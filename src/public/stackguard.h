@@ -0,0 +1,115 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   stackguard.h
+
+    @brief  Stack overflow detection
+
+    When KERNEL_STACK_CHECK is enabled, thread stacks are checked for
+    overflow at each context switch, using the method selected by
+    KERNEL_STACK_GUARD:
+
+    - KERNEL_STACK_GUARD_SLACK: measure the outgoing thread's stack slack by
+      searching the painted stack, and panic if it's at or below the guard
+      threshold (Kernel::SetStackGuardThreshold()).  Catches near-overflows
+      during development, but the search costs O(log n) on every switch.
+    - KERNEL_STACK_GUARD_CANARY: check a canary word at the limit of the
+      outgoing and incoming threads' stacks, and that the incoming thread's
+      saved stack pointer leaves at least the guard threshold free.  Constant
+      time per switch.
+    - KERNEL_STACK_GUARD_MPU: on ports with a memory protection unit, place a
+      no-access MPU region at the limit of the incoming thread's stack, so
+      that an overflow faults at the offending instruction.  The saved stack
+      pointer is also checked as for KERNEL_STACK_GUARD_CANARY.
+
+    Either way, Kernel::Panic() is called with PANIC_STACK_SLACK_VIOLATED
+    when an overflow is detected.  Full slack measurement is still available
+    on demand with Thread::GetStackSlack() - for instance, from a
+    low-priority thread periodically scanning each thread's stack - as long
+    as stacks are painted at initialization (KERNEL_STACK_PAINT).
+ */
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#if KERNEL_STACK_CHECK
+namespace Mark3
+{
+class Thread;
+
+//---------------------------------------------------------------------------
+/**
+ * @brief The StackGuard Class.
+ * Static-class used to detect thread stack overflows at context switches.
+ */
+class StackGuard
+{
+public:
+    /**
+     * @brief Init
+     * Set up overflow detection for a thread whose stack has just been
+     * initialized.
+     *
+     * @param pclThread_ Thread to set up
+     */
+    static void Init(Thread* pclThread_);
+
+    /**
+     * @brief Check
+     * Check for stack overflow in the threads being switched between, and
+     * move the MPU guard region (if used) to the incoming thread's stack.
+     * Called from the context switch path.
+     *
+     * @param pclCurrent_ Thread being switched out (may be nullptr)
+     * @param pclNext_ Thread being switched in
+     */
+    static void Check(Thread* pclCurrent_, Thread* pclNext_);
+
+private:
+    /**
+     * @brief GetLimit
+     * @param pclThread_ Thread to query
+     * @return Pointer to the word at the limit of the thread's stack - the
+     *         last word available before it overflows
+     */
+    static K_WORD* GetLimit(Thread* pclThread_);
+
+    /**
+     * @brief CheckStackTop
+     * Panic if a thread's saved stack pointer leaves less than the guard
+     * threshold free on its stack.
+     *
+     * @param pclThread_ Thread to check
+     */
+    static void CheckStackTop(Thread* pclThread_);
+
+#if (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_CANARY)
+    /**
+     * @brief IsCanaryIntact
+     * @param pclThread_ Thread to check
+     * @return true if the canary at the limit of the thread's stack is intact
+     */
+    static bool IsCanaryIntact(Thread* pclThread_);
+
+    //! Number of words making up the canary, so that it's at least 32 bits
+    static constexpr auto m_uCanaryWords = size_t { (sizeof(uint32_t) + sizeof(K_WORD) - 1) / sizeof(K_WORD) };
+
+    //! Value written to each word of the canary
+    static constexpr auto m_wCanary = static_cast<K_WORD>(0xC33CA55AC33CA55AULL);
+#endif // #if (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_CANARY)
+};
+} // namespace Mark3
+#endif // #if KERNEL_STACK_CHECK
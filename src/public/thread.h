@@ -41,6 +41,8 @@ See license.txt for more information
 #include "scheduler.h"
 #include "ithreadport.h"
 #include "quantum.h"
+#include "budget.h"
+#include "runtime.h"
 #include "autoalloc.h"
 #include "priomap.h"
 
@@ -83,7 +85,7 @@ public:
      *  thread's start method has been invoked first.
      *
      *  @param pwStack_    Pointer to the stack to use for the thread
-     *  @param u16StackSize_  Size of the stack (in bytes)
+     *  @param uStackSize_  Size of the stack (in bytes)
      *  @param uXPriority_   Priority of the thread (0 = idle, 7 = max)
      *  @param pfEntryPoint_ This is the function that gets called when the
      *                       thread is started
@@ -91,7 +93,7 @@ public:
      *                       entrypoint function.
      */
     void Init(K_WORD*         pwStack_,
-              uint16_t        u16StackSize_,
+              K_ADDR          uStackSize_,
               PORT_PRIO_TYPE  uXPriority_,
               ThreadEntryFunc pfEntryPoint_,
               void*           pvArg_);
@@ -104,7 +106,7 @@ public:
      * the memory used to create this thread cannot be reclaimed, and so this API
      * is only suitable for threads that exist for the duration of runtime.
      *
-     * @param u16StackSize_  Size of the stack (in bytes)
+     * @param uStackSize_   Size of the stack (in bytes)
      * @param uXPriority_    Priority of the thread (0 = idle, 7 = max)
      * @param pfEntryPoint_  This is the function that gets called when the
      *                       thread is started
@@ -114,7 +116,7 @@ public:
      * @return Pointer to a newly-created thread.
      */
     static Thread*
-    Init(uint16_t u16StackSize_, PORT_PRIO_TYPE uXPriority_, ThreadEntryFunc pfEntryPoint_, void* pvArg_);
+    Init(K_ADDR uStackSize_, PORT_PRIO_TYPE uXPriority_, ThreadEntryFunc pfEntryPoint_, void* pvArg_);
 
     /**
      *  @brief Start
@@ -197,6 +199,136 @@ public:
     uint16_t GetQuantum(void) { return m_u16Quantum; }
 #endif // #if KERNEL_ROUND_ROBIN
 
+#if KERNEL_SMP
+    /**
+     *  @brief SetCore
+     *  Assign the thread to a specific core.  The thread will only ever be
+     *  scheduled on that core until reassigned.  A thread can move itself to
+     *  another core (taking effect immediately), but a thread currently
+     *  running on another core cannot be moved.
+     *
+     *  @param u8Core_ Index of the core to run the thread on
+     */
+    void SetCore(uint8_t u8Core_);
+    /**
+     *  @brief GetCore
+     *  Return the core the thread is assigned to.
+     *
+     *  @return Index of the thread's core
+     */
+    uint8_t GetCore(void) { return m_u8Core; }
+#else
+    uint8_t GetCore(void) { return 0; }
+#endif // #if KERNEL_SMP
+
+#if KERNEL_PARTITIONS
+    /**
+     *  @brief SetPartition
+     *  Assign the thread to a time partition.  The thread is only eligible
+     *  to run during its partition's windows (see PartitionScheduler), except
+     *  for partition 0 - the system partition - whose threads may run at any
+     *  time.  Threads are in the system partition by default.
+     *
+     *  An index outside of KERNEL_NUM_PARTITIONS raises
+     *  PANIC_PARTITION_INVALID, and leaves the thread where it was.
+     *
+     *  @param u8Partition_ Index of the partition to run the thread in
+     */
+    void SetPartition(uint8_t u8Partition_);
+    /**
+     *  @brief GetPartition
+     *  Return the time partition the thread is assigned to.
+     *
+     *  @return Index of the thread's partition
+     */
+    uint8_t GetPartition(void) { return m_u8Partition; }
+#else
+    uint8_t GetPartition(void) { return 0; }
+#endif // #if KERNEL_PARTITIONS
+
+#if KERNEL_PREEMPT_THRESHOLD
+    /**
+     *  @brief SetPreemptThreshold
+     *  Set the thread's preemption threshold.  While running, the thread can
+     *  only be preempted by threads with a priority above this threshold.  A
+     *  threshold at or below the thread's priority has no effect (the
+     *  default).  Takes effect the next time the thread is scheduled.
+     *
+     *  @param uXThreshold_ Preemption threshold
+     */
+    void SetPreemptThreshold(PORT_PRIO_TYPE uXThreshold_) { m_uXPreemptThreshold = uXThreshold_; }
+    /**
+     *  @brief GetPreemptThreshold
+     *  Return the thread's preemption threshold
+     *
+     *  @return The thread's preemption threshold
+     */
+    PORT_PRIO_TYPE GetPreemptThreshold(void) { return m_uXPreemptThreshold; }
+#endif // #if KERNEL_PREEMPT_THRESHOLD
+
+#if KERNEL_BUDGET
+    /**
+     *  @brief SetBudget
+     *  Limit the CPU time the thread may use.  In each period, the thread may
+     *  run for up to u32BudgetMs_ ticks at its normal priority; once that's
+     *  used up, it runs at uXExhaustedPriority_ until the start of the next
+     *  period.  The first period starts immediately.
+     *
+     *  @param u32BudgetMs_ Ticks the thread may run for per period, or 0 to
+     *         remove the thread's budget
+     *  @param u32PeriodMs_ Replenishment period, in ticks
+     *  @param uXExhaustedPriority_ Priority to run at while out of budget
+     */
+    void SetBudget(uint32_t u32BudgetMs_, uint32_t u32PeriodMs_, PORT_PRIO_TYPE uXExhaustedPriority_)
+    {
+        Budget::Configure(this, u32BudgetMs_, u32PeriodMs_, uXExhaustedPriority_);
+    }
+    /**
+     *  @brief GetBudgetRemaining
+     *  Return the number of ticks left of the thread's budget in the current
+     *  period.
+     *
+     *  @return Remaining budget, in ticks
+     */
+    uint32_t GetBudgetRemaining(void) { return m_u32BudgetRemain; }
+    /**
+     *  @brief IsBudgetExhausted
+     *  Return whether the thread has used up its budget for the current
+     *  period, and is running at its exhausted priority.
+     *
+     *  @return true if the thread's budget is exhausted
+     */
+    bool IsBudgetExhausted(void) { return m_bBudgetExhausted; }
+#endif // #if KERNEL_BUDGET
+
+#if KERNEL_EDF
+    /**
+     *  @brief SetDeadline
+     *  Set the thread's relative deadline, used when the thread runs at
+     *  KERNEL_EDF_PRIORITY.  Each time the thread becomes ready, its absolute
+     *  deadline is set to the current tick count plus this value.  Takes
+     *  effect the next time the thread becomes ready.
+     *
+     *  @param u32Deadline_ Relative deadline, in kernel ticks
+     */
+    void SetDeadline(uint32_t u32Deadline_) { m_u32Deadline = u32Deadline_; }
+    /**
+     *  @brief GetDeadline
+     *  Return the thread's relative deadline
+     *
+     *  @return Relative deadline, in kernel ticks
+     */
+    uint32_t GetDeadline(void) { return m_u32Deadline; }
+    /**
+     *  @brief GetAbsoluteDeadline
+     *  Return the absolute deadline assigned when the thread last became ready
+     *  at KERNEL_EDF_PRIORITY.
+     *
+     *  @return Absolute deadline, in kernel ticks
+     */
+    uint32_t GetAbsoluteDeadline(void) { return m_u32AbsDeadline; }
+#endif // #if KERNEL_EDF
+
     /**
      *  @brief SetCurrent.
      *  Set the thread's current to the specified thread list
@@ -255,6 +387,64 @@ public:
      */
     static void Sleep(uint32_t u32TimeMs_);
 
+    /**
+     *  @brief SleepUntil
+     *  Put the thread to sleep until the kernel tick count (see
+     *  Kernel::GetTicks()) reaches the given value.  Returns immediately if
+     *  that tick has already been reached - ticks are compared modulo 2^32,
+     *  so the tick must be within 2^31 ticks of the current count.
+     *
+     *  Unlike Sleep(), the wake-up time doesn't depend on when the call is
+     *  made, so a loop that advances its wake-up tick by a fixed amount each
+     *  time around doesn't drift.
+     *
+     *  @param u32Tick_ Tick count at which to wake
+     */
+    static void SleepUntil(uint32_t u32Tick_);
+
+#if KERNEL_PERIODIC_THREADS
+    /**
+     *  @brief SetPeriod
+     *  Make the thread periodic, with its first release at the current tick
+     *  count.  The thread calls WaitForPeriod() at the end of each
+     *  activation, to sleep until the next release.
+     *
+     *  @param u32Period_ Period, in ticks (must be non-zero)
+     */
+    void SetPeriod(uint32_t u32Period_);
+    /**
+     *  @brief GetPeriod
+     *  Return the thread's period
+     *
+     *  @return Period, in ticks, or 0 if the thread isn't periodic
+     */
+    uint32_t GetPeriod(void) { return m_u32Period; }
+    /**
+     *  @brief GetRelease
+     *  Return the tick count of the thread's current release (the time its
+     *  current activation was due to start).
+     *
+     *  @return Release time, in kernel ticks
+     */
+    uint32_t GetRelease(void) { return m_u32Release; }
+
+    /**
+     *  @brief WaitForPeriod
+     *  Sleep until the calling thread's next release, one period after its
+     *  previous one.
+     *
+     *  If the thread has overrun, and the next release has already passed,
+     *  it returns immediately, and any further releases that have also
+     *  passed are skipped: the new release is the latest one due, and the
+     *  thread stays in phase with its original schedule rather than running
+     *  a burst of late activations to catch up.
+     *
+     *  @return Number of releases skipped (0 unless the thread overran by a
+     *          whole period or more)
+     */
+    static uint32_t WaitForPeriod(void);
+#endif // #if KERNEL_PERIODIC_THREADS
+
     /**
      *  @brief Yield
      *  Yield the thread - this forces the system to call the scheduler and
@@ -291,7 +481,7 @@ public:
      */
     uint8_t GetID() { return m_u8ThreadID; }
 
-#if KERNEL_STACK_CHECK
+#if KERNEL_STACK_PAINT
     /**
      *  @brief GetStackSlack
      *  Performs a (somewhat lengthy) check on the thread stack to check the
@@ -299,12 +489,13 @@ public:
      *  having problems with blowing your stack, you can run this function
      *  at points in your code during development to see what operations
      *  cause problems.  Also useful during development as a tool to optimally
-     *  size thread stacks.
+     *  size thread stacks, or from a low-priority background thread as a
+     *  high-water-mark monitor.
      *
      *  @return The amount of slack (unused bytes) on the stack
      */
-    uint16_t GetStackSlack();
-#endif // #if KERNEL_STACK_CHECK
+    K_ADDR GetStackSlack();
+#endif // #if KERNEL_STACK_PAINT
 
 #if KERNEL_EVENT_FLAGS
     /**
@@ -380,6 +571,29 @@ public:
     void SetExtendedContext(void* pvData_) { m_pvExtendedContext = pvData_; }
 #endif // #if KERNEL_EXTENDED_CONTEXT
 
+#if KERNEL_COST_MODEL
+    /**
+     * @brief GetEstimatedCycles
+     * Return the estimated number of target CPU cycles charged to this thread
+     * by kernel primitives since it was initialized (see CostModel).
+     *
+     * @return Estimated target cycles spent in the kernel on this thread's behalf
+     */
+    uint64_t GetEstimatedCycles() { return m_u64EstCycles; }
+#endif // #if KERNEL_COST_MODEL
+
+#if KERNEL_RUN_TIME
+    /**
+     * @brief GetRunTime
+     * Return the number of cycles this thread has run for since it was
+     * initialized, including its current slice if it's running on the calling
+     * core (see RunTime).
+     *
+     * @return Cycles the thread has run for
+     */
+    uint64_t GetRunTime() { return RunTime::GetRunTime(this); }
+#endif // #if KERNEL_RUN_TIME
+
     /**
      * @brief GetState Returns the current state of the thread to the
      *        caller.  Can be used to determine whether or not a thread
@@ -415,7 +629,7 @@ public:
      * @brief GetStackSize
      * @return Size of the thread's stack in bytes
      */
-    uint16_t GetStackSize() { return m_u16StackSize; }
+    K_ADDR GetStackSize() { return m_uStackSize; }
 
     /**
      * @brief ErrnoStorage
@@ -424,6 +638,24 @@ public:
     int* ErrnoStorage() { return &m_iErrno; }
 
     friend class ThreadPort;
+#if KERNEL_COST_MODEL
+    friend class CostModel;
+#endif // #if KERNEL_COST_MODEL
+#if KERNEL_EDF
+    friend class DeadlineHeap;
+#endif // #if KERNEL_EDF
+#if KERNEL_BUDGET
+    friend class Budget;
+#endif // #if KERNEL_BUDGET
+#if KERNEL_RUN_TIME
+    friend class RunTime;
+#endif // #if KERNEL_RUN_TIME
+#if KERNEL_STACK_CHECK
+    friend class StackGuard;
+#endif // #if KERNEL_STACK_CHECK
+#if KERNEL_PREEMPT_THRESHOLD
+    friend class Scheduler;
+#endif // #if KERNEL_PREEMPT_THRESHOLD
 
 private:
     /**
@@ -441,18 +673,43 @@ private:
      */
     void SetPriorityBase(PORT_PRIO_TYPE uXPriority_);
 
-    //!!! NOTE !!! ORDER IS IMPORTANT - DO NOT MOVE THESE MEMBER VARIABLE DECLARATIONS
-    //!!! UNLESS YOU REALLY KNOW WHAT YOU'RE DOING!  IF YOU MUST ADD NEW MEMBERS, ENSURE
-    //!!! TO ADD THEM AT THE *BOTTOM*
+    // Members are grouped by how often they're accessed.  The first group is
+    // touched by the scheduler and blocking objects on every context switch
+    // or change of thread state, and is packed at the start of the object,
+    // sharing a cache line with the list links on targets with data caches.
+    // The second group is only used when a thread is initialized, started,
+    // named, or blocked with a timeout, or by optional features.
+    //
+    // m_pwStackTop must remain the first member: the ports' context switch
+    // code accesses it at PORT_THREAD_STACK_TOP_OFFSET, which is checked
+    // against this layout at compile time (see Thread::Init()).
 
     //! Pointer to the top of the thread's stack
     K_WORD* m_pwStackTop;
 
-    //! Pointer to the thread's stack
-    K_WORD* m_pwStack;
+    //! Pointer to the thread-list where the thread currently resides
+    ThreadList* m_pclCurrent;
 
-    //! Thread ID
-    uint8_t m_u8ThreadID;
+    //! Pointer to the thread-list where the thread resides when active
+    ThreadList* m_pclOwner;
+
+#if KERNEL_PREEMPT_THRESHOLD
+    //! Protected thread this thread preempted, if any (see Scheduler::Schedule())
+    Thread* m_pclPreempted;
+#endif // #if KERNEL_PREEMPT_THRESHOLD
+
+#if KERNEL_EDF
+    //! Absolute deadline, while ready at KERNEL_EDF_PRIORITY
+    uint32_t m_u32AbsDeadline;
+
+    //! Index of the thread in its core's deadline heap
+    uint16_t m_u16HeapIndex;
+#endif // #if KERNEL_EDF
+
+#if KERNEL_ROUND_ROBIN
+    //! Thread quantum (in milliseconds)
+    uint16_t m_u16Quantum;
+#endif // #if KERNEL_ROUND_ROBIN
 
     //! Default priority of the thread
     PORT_PRIO_TYPE m_uXPriority;
@@ -460,9 +717,36 @@ private:
     //! Current priority of the thread (priority inheritence)
     PORT_PRIO_TYPE m_uXCurPriority;
 
+#if KERNEL_PREEMPT_THRESHOLD
+    //! Priority a thread must exceed to preempt this thread while it runs
+    PORT_PRIO_TYPE m_uXPreemptThreshold;
+#endif // #if KERNEL_PREEMPT_THRESHOLD
+
     //! Enum indicating the thread's current state
     ThreadState m_eState;
 
+    //! Indicate whether or not a blocking-object timeout has occurred
+    bool m_bExpired;
+
+#if KERNEL_SMP
+    //! Index of the core the thread is scheduled on
+    uint8_t m_u8Core;
+#endif // #if KERNEL_SMP
+
+#if KERNEL_PARTITIONS
+    //! Index of the time partition the thread runs in
+    uint8_t m_u8Partition;
+#endif // #if KERNEL_PARTITIONS
+
+    //! Pointer to the thread's stack
+    K_WORD* m_pwStack;
+
+    //! The entry-point function called when the thread starts
+    ThreadEntryFunc m_pfEntryPoint;
+
+    //! Pointer to the argument passed into the thread's entrypoint
+    void* m_pvArg;
+
 #if KERNEL_EXTENDED_CONTEXT
     //! Pointer provided to a Thread to implement thread-local storage
     void* m_pvExtendedContext;
@@ -474,41 +758,70 @@ private:
 #endif // #if KERNEL_NAMED_THREADS
 
     //! Size of the stack (in bytes)
-    uint16_t m_u16StackSize;
-
-    //! Pointer to the thread-list where the thread currently resides
-    ThreadList* m_pclCurrent;
-
-    //! Pointer to the thread-list where the thread resides when active
-    ThreadList* m_pclOwner;
-
-    //! The entry-point function called when the thread starts
-    ThreadEntryFunc m_pfEntryPoint;
-
-    //! Pointer to the argument passed into the thread's entrypoint
-    void* m_pvArg;
+    K_ADDR m_uStackSize;
 
-#if KERNEL_ROUND_ROBIN
-    //! Thread quantum (in milliseconds)
-    uint16_t m_u16Quantum;
-#endif // #if KERNEL_ROUND_ROBIN
+    //! Thread ID
+    uint8_t m_u8ThreadID;
 
 #if KERNEL_EVENT_FLAGS
+    //! Event-flag operation
+    EventFlagOperation m_eFlagMode;
+
     //! Event-flag mask
     uint16_t m_u16FlagMask;
-
-    //! Event-flag mode
-    EventFlagOperation m_eFlagMode;
 #endif // #if KERNEL_EVENT_FLAGS
 
-    //! Indicate whether or not a blocking-object timeout has occurred
-    bool m_bExpired;
-
     //! Storage used to hold a thread-safe errno value
     int m_iErrno;
 
     //! Timer used for blocking-object timeouts
     Timer m_clTimer;
+
+#if KERNEL_COST_MODEL
+    //! Estimated target cycles charged to this thread
+    uint64_t m_u64EstCycles;
+#endif // #if KERNEL_COST_MODEL
+
+#if KERNEL_RUN_TIME
+    //! Cycles the thread has run for
+    uint64_t m_u64RunTime;
+
+    //! Next thread in the list of initialized threads (see RunTime::Snapshot())
+    Thread* m_pclRunTimeNext;
+#endif // #if KERNEL_RUN_TIME
+
+#if KERNEL_EDF
+    //! Relative deadline, applied each time the thread becomes ready
+    uint32_t m_u32Deadline;
+#endif // #if KERNEL_EDF
+
+#if KERNEL_BUDGET
+    //! Ticks the thread may run for per period (0 = unlimited)
+    uint32_t m_u32Budget;
+
+    //! Ticks of budget left in the current period
+    uint32_t m_u32BudgetRemain;
+
+    //! Priority to run at once the budget is used up
+    PORT_PRIO_TYPE m_uXExhaustedPriority;
+
+    //! Priority to restore when the budget is replenished
+    PORT_PRIO_TYPE m_uXBudgetPriority;
+
+    //! Whether the thread has been demoted for exceeding its budget
+    bool m_bBudgetExhausted;
+
+    //! Timer used to replenish the budget at the start of each period
+    Timer m_clBudgetTimer;
+#endif // #if KERNEL_BUDGET
+
+#if KERNEL_PERIODIC_THREADS
+    //! Release period, in ticks (0 = not periodic)
+    uint32_t m_u32Period;
+
+    //! Tick count of the current release
+    uint32_t m_u32Release;
+#endif // #if KERNEL_PERIODIC_THREADS
 };
 
 } // namespace Mark3
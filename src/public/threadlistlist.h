@@ -65,6 +65,6 @@ public:
     }
 
 private:
-    static TypedDoubleLinkList<ThreadList> m_clThreadListList;
+    static KERNEL_INSTANCE_STATE TypedDoubleLinkList<ThreadList> m_clThreadListList;
 };
 } // namespace Mark3
@@ -0,0 +1,75 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   tickless.h
+
+    @brief  Tick suppression while the system is idle
+
+    When KERNEL_TICKLESS is enabled, the kernel tick keeps running at its
+    fixed rate while threads are busy, but is suppressed whenever the idle
+    thread has the CPU.  The idle thread calls Tickless::Idle() in its loop,
+    in place of its usual sleep instruction:
+
+    @code
+
+    void IdleEntry(void* unused)
+    {
+        while (1) {
+            Tickless::Idle();
+        }
+    }
+
+    @endcode
+
+    Tickless::Idle() finds the number of ticks until the next timer expires
+    (or the current partition window ends), reprograms the kernel timer to
+    interrupt once at that tick boundary, and puts the CPU to sleep.  When
+    the CPU wakes - on that interrupt, or any other - the periodic tick is
+    restarted in phase with the old one, and the kernel tick count advanced
+    by the number of ticks slept through.  Timers then expire on the same
+    tick as they would have with the tick running throughout.
+
+    Only the idle thread may call Tickless::Idle(): the timer state is read
+    on the assumption that no other thread is ready to run.
+ */
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#if KERNEL_TICKLESS
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+/**
+ * @brief The Tickless Class.
+ * Static-class used to suppress the kernel tick while the system is idle.
+ */
+class Tickless
+{
+public:
+    /**
+     * @brief Idle
+     * Sleep until the next kernel event, with the periodic tick suppressed.
+     * Returns after the CPU is woken by any interrupt, once that interrupt
+     * has been serviced.  Must only be called from the idle thread.
+     */
+    static void Idle();
+
+private:
+    static_assert(KERNEL_TICKLESS_MIN_TICKS >= 2, "KERNEL_TICKLESS_MIN_TICKS must be at least 2");
+};
+} // namespace Mark3
+#endif // #if KERNEL_TICKLESS
@@ -35,6 +35,10 @@ static constexpr auto uTimerFlagOneShot  = uint8_t { 0x01 }; //!< Timer is one-s
 static constexpr auto uTimerFlagActive   = uint8_t { 0x02 }; //!< Timer is currently active
 static constexpr auto uTimerFlagCallback = uint8_t { 0x04 }; //!< Timer is pending a callback
 static constexpr auto uTimerFlagExpired  = uint8_t { 0x08 }; //!< Timer is actually expired.
+static constexpr auto uTimerFlagAbsolute = uint8_t { 0x10 }; //!< Timer's interval is an absolute tick count
+#if KERNEL_TIMER_WHEEL
+static constexpr auto uTimerSlotNone = uint8_t { 0xFF }; //!< Timer isn't filed in the timer wheel
+#endif // #if KERNEL_TIMER_WHEEL
 
 //---------------------------------------------------------------------------
 /**
@@ -96,6 +100,24 @@ public:
      */
     void Start(bool bRepeat_, uint32_t u32IntervalMs_, TimerCallback pfCallback_, void* pvData_);
 
+    /**
+     *  @brief StartAt
+     *  Start a one-shot timer that expires when the kernel tick count (see
+     *  Kernel::GetTicks()) reaches the given value.  The tick count is read
+     *  with the timer scheduler locked, so a tick arriving while the timer is
+     *  started can't delay its expiry.
+     *
+     *  Ticks are compared modulo 2^32, so the tick must be within 2^31 ticks
+     *  of the current count.
+     *
+     *  @param u32Tick_ - Tick count at which the timer expires
+     *  @param pfCallback_ - Function to call on timer expiry
+     *  @param pvData_ - Data to pass into the callback function
+     *  @return true if the timer was started, false if the tick count has
+     *          already been reached - in which case the callback isn't called
+     */
+    bool StartAt(uint32_t u32Tick_, TimerCallback pfCallback_, void* pvData_);
+
     /**
      * @brief Start
      * Start or restart a timer using parameters previously configured via
@@ -114,6 +136,7 @@ public:
 
 private:
     friend class TimerList;
+    friend class TimerWheel;
 
     /**
      * @brief SetInitialized
@@ -145,8 +168,16 @@ private:
     //! Interval of the timer in timer ticks
     uint32_t m_u32Interval;
 
+#if KERNEL_TIMER_WHEEL
+    //! Tick count at which the timer expires
+    uint32_t m_u32Expiry;
+
+    //! Index of the timer wheel slot holding the timer
+    uint8_t m_u8Slot;
+#else
     //! Time remaining on the timer
     uint32_t m_u32TimeLeft;
+#endif // #if KERNEL_TIMER_WHEEL
 
     //! Pointer to the owner thread
     Thread* m_pclOwner;
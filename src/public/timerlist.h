@@ -64,11 +64,27 @@ public:
     void Remove(Timer* pclLinkListNode_);
 
     /**
-     *  @brief Process     
+     *  @brief Process
      *  Process all timers in the timerlist as a result of the timer expiring.
      *  This will select a new timer epoch based on the next timer to expire.
+     *
+     *  @param u32Ticks_ Number of ticks elapsed since the list was last processed.
+     *                   Timers whose remaining time is covered by the elapsed
+     *                   interval are expired.
+     */
+    void Process(uint32_t u32Ticks_);
+
+    /**
+     *  @brief GetNextExpiry
+     *  Return the number of ticks remaining until the earliest active timer in
+     *  the list expires.  Safe to call from interrupt context: if a thread is
+     *  part-way through modifying the list, the list isn't walked, and the
+     *  next tick is reported instead.
+     *
+     *  @return Ticks until the next expiry, or uTimerTicksInvalid if no timers
+     *          are active.
      */
-    void Process();
+    uint32_t GetNextExpiry();
 
 private:
     //! The time (in system clock ticks) of the next wakeup event
@@ -26,6 +26,9 @@ See license.txt for more information
 #include "ll.h"
 #include "timer.h"
 #include "timerlist.h"
+#include "timerwheel.h"
+#include "budget.h"
+#include "partitionscheduler.h"
 
 namespace Mark3
 {
@@ -33,7 +36,8 @@ namespace Mark3
 /**
  * @brief The TimerScheduler Class.
  * This implements a "Static" class used to manage a global list of timers used
- * throughout the system.
+ * throughout the system.  Active timers are kept in a hierarchical timing
+ * wheel when KERNEL_TIMER_WHEEL is enabled, or in a single list otherwise.
  */
 class TimerScheduler
 {
@@ -43,7 +47,7 @@ public:
      *  Initialize the timer scheduler.  Must be called before any timer, or
      *  timer-derived functions are used.
      */
-    static void Init() { m_clTimerList.Init(); }
+    static void Init() { m_clTimers.Init(); }
     /**
      *  @brief Add
      *  Add a timer to the timer scheduler.  Adding a timer implicitly starts
@@ -51,7 +55,7 @@ public:
      *
      *  @param pclListNode_ Pointer to the timer list node to add
      */
-    static void Add(Timer* pclListNode_) { m_clTimerList.Add(pclListNode_); }
+    static void Add(Timer* pclListNode_) { m_clTimers.Add(pclListNode_); }
     /**
      *  @brief Remove
      *  Remove a timer from the timer scheduler.  May implicitly stop the
@@ -59,7 +63,7 @@ public:
      *
      *  @param pclListNode_ Pointer to the timer list node to remove
      */
-    static void Remove(Timer* pclListNode_) { m_clTimerList.Remove(pclListNode_); }
+    static void Remove(Timer* pclListNode_) { m_clTimers.Remove(pclListNode_); }
     /**
      *  @brief Process
      *  This function must be called on timer expiry (from the timer's ISR
@@ -67,10 +71,40 @@ public:
      *  the epoch that just elapsed.  The next timer epoch is set based on the
      *  next Timer object to expire.
      */
-    static void Process() { m_clTimerList.Process(); }
+    static void Process() { Process(1); }
+    /**
+     *  @brief Process
+     *  Update all timers based on an epoch of multiple elapsed ticks, as used
+     *  when kernel time advances in steps larger than a single tick.
+     *
+     *  @param u32Ticks_ Number of ticks elapsed since the last call to Process()
+     */
+    static void Process(uint32_t u32Ticks_)
+    {
+#if KERNEL_BUDGET
+        Budget::Charge(u32Ticks_);
+#endif // #if KERNEL_BUDGET
+#if KERNEL_PARTITIONS
+        PartitionScheduler::Process(u32Ticks_);
+#endif // #if KERNEL_PARTITIONS
+        m_clTimers.Process(u32Ticks_);
+    }
+    /**
+     *  @brief GetNextExpiry
+     *  Return the number of ticks until the next active timer expires.
+     *
+     *  @return Ticks until next expiry, or uTimerTicksInvalid if no timers are active
+     */
+    static uint32_t GetNextExpiry() { return m_clTimers.GetNextExpiry(); }
 
 private:
-    //! TimerList object manipu32ated by the Timer Scheduler
-    static TimerList m_clTimerList;
+#if KERNEL_TIMER_WHEEL
+    using TimerBackend = TimerWheel;
+#else
+    using TimerBackend = TimerList;
+#endif // #if KERNEL_TIMER_WHEEL
+
+    //! Active timers managed by the Timer Scheduler
+    static KERNEL_INSTANCE_STATE TimerBackend m_clTimers;
 };
 } // namespace Mark3
@@ -0,0 +1,180 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   timerwheel.h
+
+    @brief  Hierarchical timing wheel, used to manage active timers
+
+    When KERNEL_TIMER_WHEEL is enabled, active timers are kept in a
+    hierarchical timing wheel rather than a single list.  The wheel is a set
+    of levels, each with 2^KERNEL_TIMER_WHEEL_BITS slots.  Each slot is a
+    list of timers; a slot at level L covers 2^(bits * L) ticks.
+
+    A timer is filed by its absolute expiry tick, into the lowest level whose
+    span covers the time remaining, so starting or stopping a timer is O(1).
+    Each tick, the timers in one level-0 slot expire.  Whenever the level-0
+    index wraps around, the timers in the next slot of the level above are
+    "cascaded" down, and re-filed at a lower level now that they're closer
+    to expiry (and so on up the levels).  A timer is cascaded at most once
+    per level, so the cost of a timer is O(levels) over its whole lifetime,
+    independent of the number of other active timers.
+
+    Processing several elapsed ticks at once steps through them in order,
+    skipping runs of empty slots using a per-level occupancy bitmap, so each
+    timer expires (and periodic timers reload) on exactly the tick it would
+    have with single-tick processing.  The order in which timers due on the
+    same tick expire is unspecified.
+ */
+#pragma once
+
+#include "kerneltypes.h"
+#include "mark3cfg.h"
+
+#include "ll.h"
+#include "mutex.h"
+
+#if KERNEL_TIMER_WHEEL
+namespace Mark3
+{
+class Timer;
+
+//---------------------------------------------------------------------------
+/**
+ * @brief The TimerWheel class.
+ * Hierarchical timing wheel of timer objects, with the same interface as
+ * the TimerList class.
+ */
+class TimerWheel
+{
+public:
+    /**
+     *  @brief Init
+     *  Initialize the TimerWheel object.  Must be called before
+     *  using the object.
+     */
+    void Init();
+
+    /**
+     *  @brief Add
+     *  Add a timer to the wheel, starting it from the current tick.
+     *
+     *  @param pclTimer_ Pointer to the Timer to Add
+     */
+    void Add(Timer* pclTimer_);
+
+    /**
+     *  @brief Remove
+     *  Remove a timer from the wheel, cancelling its expiry.
+     *
+     *  @param pclTimer_ Pointer to the Timer to remove
+     */
+    void Remove(Timer* pclTimer_);
+
+    /**
+     *  @brief Process
+     *  Advance the wheel by the given number of ticks, expiring timers as
+     *  their ticks are reached.
+     *
+     *  @param u32Ticks_ Number of ticks elapsed since the wheel was last processed.
+     */
+    void Process(uint32_t u32Ticks_);
+
+    /**
+     *  @brief GetNextExpiry
+     *  Return the number of ticks remaining until the earliest active timer
+     *  expires.  Safe to call from interrupt context: if a thread is
+     *  part-way through modifying the wheel, it isn't read, and the next tick
+     *  is reported instead.
+     *
+     *  @return Ticks until the next expiry, or uTimerTicksInvalid if no timers
+     *          are active.
+     */
+    uint32_t GetNextExpiry();
+
+private:
+    static_assert((KERNEL_TIMER_WHEEL_BITS >= 2) && (KERNEL_TIMER_WHEEL_BITS <= 5),
+                  "KERNEL_TIMER_WHEEL_BITS must be between 2 and 5");
+
+    static constexpr auto m_uSlotBits = uint8_t { KERNEL_TIMER_WHEEL_BITS };
+    static constexpr auto m_uSlots    = uint8_t { 1 << m_uSlotBits };
+    static constexpr auto m_uSlotMask = uint32_t { m_uSlots - 1 };
+    static constexpr auto m_uLevels   = uint8_t { (32 + m_uSlotBits - 1) / m_uSlotBits };
+
+    /**
+     *  @brief File
+     *  Place an active timer in the slot matching its expiry tick.
+     *
+     *  @param pclTimer_ Timer to file
+     */
+    void File(Timer* pclTimer_);
+
+    /**
+     *  @brief Unfile
+     *  Take a timer out of its slot.
+     *
+     *  @param pclTimer_ Timer to unfile
+     */
+    void Unfile(Timer* pclTimer_);
+
+    /**
+     *  @brief Cascade
+     *  Re-file the timers in the current slot of each level whose lower
+     *  levels have just wrapped around.
+     *
+     *  @return Number of timers re-filed
+     */
+    uint16_t Cascade();
+
+    /**
+     *  @brief Expire
+     *  Expire the timers in the current level-0 slot, running their
+     *  callbacks, and restarting periodic timers.
+     *
+     *  @return Number of timers expired
+     */
+    uint16_t Expire();
+
+    /**
+     *  @brief TicksToNextSlot
+     *  @return Number of ticks until the wheel next reaches either an
+     *          occupied level-0 slot, or the end of the level-0 rotation
+     */
+    uint32_t TicksToNextSlot();
+
+    /**
+     *  @brief LevelIndex
+     *  @param u32Tick_ Tick count
+     *  @param u8Level_ Level of the wheel
+     *  @return Index of the slot covering the given tick, within the level
+     */
+    static uint8_t LevelIndex(uint32_t u32Tick_, uint8_t u8Level_)
+    {
+        return static_cast<uint8_t>((u32Tick_ >> (u8Level_ * m_uSlotBits)) & m_uSlotMask);
+    }
+
+    //! Lists of timers, indexed by (level * m_uSlots) + index
+    TypedDoubleLinkList<Timer> m_aclSlots[m_uLevels * m_uSlots];
+
+    //! Bitmap of non-empty slots, for each level
+    uint32_t m_au32Occupied[m_uLevels];
+
+    //! Number of ticks processed since the wheel was initialized
+    uint32_t m_u32Now;
+
+    //! Guards against concurrent access to the wheel - Only needed when running threaded.
+    Mutex m_clMutex;
+};
+} // namespace Mark3
+#endif // #if KERNEL_TIMER_WHEEL
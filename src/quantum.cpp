@@ -25,10 +25,10 @@ See license.txt for more information
 namespace Mark3
 {
 //---------------------------------------------------------------------------
-uint16_t Quantum::m_u16TicksRemain;
-Thread*  Quantum::m_pclActiveThread;
-Thread*  Quantum::m_pclTimerThread;
-bool     Quantum::m_bInTimer;
+KERNEL_INSTANCE_STATE uint16_t Quantum::m_au16TicksRemain[KERNEL_NUM_CORES];
+KERNEL_INSTANCE_STATE Thread*  Quantum::m_apclActiveThread[KERNEL_NUM_CORES];
+KERNEL_INSTANCE_STATE Thread*  Quantum::m_pclTimerThread;
+KERNEL_INSTANCE_STATE bool     Quantum::m_bInTimer;
 
 //---------------------------------------------------------------------------
 void Quantum::SetInTimer()
@@ -37,8 +37,10 @@ void Quantum::SetInTimer()
     m_bInTimer = true;
 
     // Timer is active
-    if (m_u16TicksRemain) {
-        m_u16TicksRemain--;
+    for (auto u8Core = uint8_t { 0 }; u8Core < KERNEL_NUM_CORES; u8Core++) {
+        if (m_au16TicksRemain[u8Core]) {
+            m_au16TicksRemain[u8Core]--;
+        }
     }
 }
 
@@ -49,13 +51,23 @@ void Quantum::ClearInTimer()
     m_bInTimer = false;
 
     // Timer expired - Pivot the thread list.
-    if (m_pclActiveThread && (!m_u16TicksRemain)) {
-        auto* pclThreadList = m_pclActiveThread->GetCurrent();
-        if (pclThreadList->GetHead() != pclThreadList->GetTail()) {
-            pclThreadList->PivotForward();
+    for (auto u8Core = uint8_t { 0 }; u8Core < KERNEL_NUM_CORES; u8Core++) {
+        auto* pclActive = m_apclActiveThread[u8Core];
+        if (pclActive && (!m_au16TicksRemain[u8Core])) {
+            auto* pclThreadList = pclActive->GetCurrent();
+            if (pclThreadList->GetHead() != pclThreadList->GetTail()) {
+                pclThreadList->PivotForward();
+#if KERNEL_SMP
+                // The timer thread only runs on one core; others must be told
+                // to pick up the new head of their list.
+                if (u8Core != Scheduler::GetCurrentCore()) {
+                    ThreadPort::SendIpi(u8Core);
+                }
+#endif // #if KERNEL_SMP
+            }
+            m_apclActiveThread[u8Core] = nullptr;
         }
-        m_pclActiveThread = nullptr;
-    }    
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -65,21 +77,40 @@ void Quantum::Update(Thread* pclTargetThread_)
     // the timer thread, or are in the middle of running the timer thread.
     // OR if the thread list only has one thread
     auto* pclThreadList = pclTargetThread_->GetCurrent();
+    auto  u8Core        = pclTargetThread_->GetCore();
     if ((pclThreadList->GetHead() == pclThreadList->GetTail()) || (pclTargetThread_ == m_pclTimerThread)
-        || (pclTargetThread_ == m_pclActiveThread) || m_bInTimer) {
+        || (pclTargetThread_ == m_apclActiveThread[u8Core]) || m_bInTimer) {
         return;
     }
+#if KERNEL_EDF
+    // Threads in the EDF band aren't time-sliced
+    if (KERNEL_EDF_PRIORITY == pclTargetThread_->GetPriority()) {
+        return;
+    }
+#endif // #if KERNEL_EDF
 
     // Update with a new thread and timeout.
-    m_pclActiveThread = pclTargetThread_;
-    m_u16TicksRemain  = pclTargetThread_->GetQuantum();
+    m_apclActiveThread[u8Core] = pclTargetThread_;
+    m_au16TicksRemain[u8Core]  = pclTargetThread_->GetQuantum();
 }
 
 //---------------------------------------------------------------------------
 void Quantum::Cancel()
 {
-    m_pclActiveThread = nullptr;
-    m_u16TicksRemain  = 0;
+    auto u8Core                = Scheduler::GetCurrentCore();
+    m_apclActiveThread[u8Core] = nullptr;
+    m_au16TicksRemain[u8Core]  = 0;
+}
+
+//---------------------------------------------------------------------------
+void Quantum::Remove(Thread* pclThread_)
+{
+    for (auto u8Core = uint8_t { 0 }; u8Core < KERNEL_NUM_CORES; u8Core++) {
+        if (pclThread_ == m_apclActiveThread[u8Core]) {
+            m_apclActiveThread[u8Core] = nullptr;
+            m_au16TicksRemain[u8Core]  = 0;
+        }
+    }
 }
 } // namespace Mark3
 #endif // #if KERNEL_ROUND_ROBIN
@@ -0,0 +1,131 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   runtime.cpp
+
+    @brief  Per-thread CPU time accounting
+*/
+
+#include "mark3.h"
+
+#if KERNEL_RUN_TIME
+namespace Mark3
+{
+namespace
+{
+    //---------------------------------------------------------------------------
+    // Time source for accounting - estimated target cycles when the cost model
+    // is enabled, the port's free-running cycle counter otherwise.
+    uint32_t RunTime_Now()
+    {
+#if KERNEL_COST_MODEL
+        return static_cast<uint32_t>(CostModel::GetCycles());
+#else
+        return KernelTimer::GetCycleCount();
+#endif // #if KERNEL_COST_MODEL
+    }
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+KERNEL_INSTANCE_STATE uint32_t RunTime::m_au32LastUpdate[KERNEL_NUM_CORES];
+KERNEL_INSTANCE_STATE uint64_t RunTime::m_au64IdleTime[KERNEL_NUM_CORES];
+KERNEL_INSTANCE_STATE Thread*  RunTime::m_pclThreads;
+
+//---------------------------------------------------------------------------
+void RunTime::Start()
+{
+    auto u32Now = RunTime_Now();
+    for (auto& u32LastUpdate : m_au32LastUpdate) { u32LastUpdate = u32Now; }
+}
+
+//---------------------------------------------------------------------------
+void RunTime::Update()
+{
+    auto  u8Core    = Scheduler::GetCurrentCore();
+    auto  u32Now    = RunTime_Now();
+    auto  u32Delta  = u32Now - m_au32LastUpdate[u8Core];
+    auto* pclThread = g_pclCurrent;
+
+    m_au32LastUpdate[u8Core] = u32Now;
+    if (nullptr == pclThread) {
+        return;
+    }
+
+    pclThread->m_u64RunTime += u32Delta;
+    if ((0 == pclThread->m_uXPriority) && (ThreadState::Exit != pclThread->m_eState)) {
+        m_au64IdleTime[u8Core] += u32Delta;
+    }
+}
+
+//---------------------------------------------------------------------------
+void RunTime::Add(Thread* pclThread_)
+{
+    const auto cs = CriticalGuard{};
+    pclThread_->m_u64RunTime     = 0;
+    pclThread_->m_pclRunTimeNext = m_pclThreads;
+    m_pclThreads                 = pclThread_;
+}
+
+//---------------------------------------------------------------------------
+void RunTime::Remove(Thread* pclThread_)
+{
+    const auto cs = CriticalGuard{};
+    for (auto** ppclLink = &m_pclThreads; nullptr != *ppclLink; ppclLink = &(*ppclLink)->m_pclRunTimeNext) {
+        if (*ppclLink == pclThread_) {
+            *ppclLink = pclThread_->m_pclRunTimeNext;
+            break;
+        }
+    }
+    pclThread_->m_pclRunTimeNext = nullptr;
+}
+
+//---------------------------------------------------------------------------
+uint64_t RunTime::GetRunTime(Thread* pclThread_)
+{
+    const auto cs = CriticalGuard{};
+    Update();
+    return pclThread_->m_u64RunTime;
+}
+
+//---------------------------------------------------------------------------
+uint64_t RunTime::GetIdleTime()
+{
+    const auto cs = CriticalGuard{};
+    Update();
+
+    auto u64IdleTime = uint64_t { 0 };
+    for (auto u64CoreIdle : m_au64IdleTime) { u64IdleTime += u64CoreIdle; }
+    return u64IdleTime;
+}
+
+//---------------------------------------------------------------------------
+uint16_t RunTime::Snapshot(RunTimeSample* pastSamples_, uint16_t u16MaxSamples_)
+{
+    KERNEL_ASSERT((nullptr != pastSamples_) || (0 == u16MaxSamples_));
+
+    const auto cs = CriticalGuard{};
+    Update();
+
+    auto u16Count = uint16_t { 0 };
+    for (auto* pclThread = m_pclThreads; (nullptr != pclThread) && (u16Count < u16MaxSamples_);
+         pclThread       = pclThread->m_pclRunTimeNext) {
+        pastSamples_[u16Count].pclThread  = pclThread;
+        pastSamples_[u16Count].u64RunTime = pclThread->m_u64RunTime;
+        u16Count++;
+    }
+    return u16Count;
+}
+} // namespace Mark3
+#endif // #if KERNEL_RUN_TIME
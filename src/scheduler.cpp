@@ -21,38 +21,139 @@ See license.txt for more information
 
 #include "mark3.h"
 
-Mark3::Thread* g_pclNext;
-Mark3::Thread* g_pclCurrent;
+#if KERNEL_SMP
+Mark3::Thread* g_apclNext[KERNEL_NUM_CORES];
+Mark3::Thread* g_apclCurrent[KERNEL_NUM_CORES];
+#else
+KERNEL_INSTANCE_STATE Mark3::Thread* g_pclNext;
+KERNEL_INSTANCE_STATE Mark3::Thread* g_pclCurrent;
+#endif // #if KERNEL_SMP
 
 namespace Mark3
 {
-bool        Scheduler::m_bEnabled;
-bool        Scheduler::m_bQueuedSchedule;
-ThreadList  Scheduler::m_clStopList;
-ThreadList  Scheduler::m_aclPriorities[KERNEL_NUM_PRIORITIES];
-PriorityMap Scheduler::m_clPrioMap;
+KERNEL_INSTANCE_STATE uint8_t     Scheduler::m_au8LockCount[KERNEL_NUM_CORES];
+KERNEL_INSTANCE_STATE bool        Scheduler::m_abQueuedSchedule[KERNEL_NUM_CORES];
+#if KERNEL_SMP
+bool                              Scheduler::m_abLockHeld[KERNEL_NUM_CORES];
+KERNEL_INSTANCE_STATE uint8_t     Scheduler::m_u8NextCore;
+#endif // #if KERNEL_SMP
+KERNEL_INSTANCE_STATE ThreadList  Scheduler::m_clStopList;
+KERNEL_INSTANCE_STATE ThreadList  Scheduler::m_aclPriorities[KERNEL_NUM_CORES][KERNEL_NUM_PARTITIONS][KERNEL_NUM_PRIORITIES];
+KERNEL_INSTANCE_STATE PriorityMap Scheduler::m_aclPrioMap[KERNEL_NUM_CORES][KERNEL_NUM_PARTITIONS];
+#if KERNEL_PARTITIONS
+KERNEL_INSTANCE_STATE uint8_t     Scheduler::m_u8ActivePartition;
+#endif // #if KERNEL_PARTITIONS
+#if KERNEL_EDF
+KERNEL_INSTANCE_STATE DeadlineHeap Scheduler::m_aclDeadlines[KERNEL_NUM_CORES][KERNEL_NUM_PARTITIONS];
+#endif // #if KERNEL_EDF
+#if KERNEL_PREEMPT_THRESHOLD
+KERNEL_INSTANCE_STATE Thread* Scheduler::m_apclProtected[KERNEL_NUM_CORES];
+#endif // #if KERNEL_PREEMPT_THRESHOLD
 
 //---------------------------------------------------------------------------
 void Scheduler::Init()
 {
-    for (size_t i = 0; i < m_uNumPriorities; i++) {
-        m_aclPriorities[i].SetPriority(i);
-        m_aclPriorities[i].SetMapPointer(&m_clPrioMap);
+    for (size_t u = 0; u < m_uNumCores; u++) {
+        // Scheduling stays disabled until the port starts the threads
+        m_au8LockCount[u] = 1;
+        for (size_t p = 0; p < m_uNumPartitions; p++) {
+            for (size_t i = 0; i < m_uNumPriorities; i++) {
+                m_aclPriorities[u][p][i].SetPriority(i);
+                m_aclPriorities[u][p][i].SetMapPointer(&m_aclPrioMap[u][p]);
+            }
+#if KERNEL_EDF
+            m_aclDeadlines[u][p].Init();
+#endif // #if KERNEL_EDF
+        }
+#if KERNEL_PREEMPT_THRESHOLD
+        m_apclProtected[u] = nullptr;
+#endif // #if KERNEL_PREEMPT_THRESHOLD
     }
+#if KERNEL_PARTITIONS
+    m_u8ActivePartition = 0;
+#endif // #if KERNEL_PARTITIONS
+#if KERNEL_SMP
+    m_u8NextCore = 0;
+#endif // #if KERNEL_SMP
 }
 
 //---------------------------------------------------------------------------
 void Scheduler::Schedule()
 {
-    auto uXPrio = m_clPrioMap.HighestPriority();
+#if KERNEL_COST_MODEL
+    CostModel::Charge(CostEvent::Schedule);
+#endif // #if KERNEL_COST_MODEL
+    auto u8Core      = GetCurrentCore();
+    auto u8Partition = GetActivePartition();
+    auto uXPrio      = m_aclPrioMap[u8Core][u8Partition].HighestPriority();
+#if KERNEL_PARTITIONS
+    // Threads in the system partition are eligible in every window
+    auto uXSystemPrio = m_aclPrioMap[u8Core][0].HighestPriority();
+    if (uXSystemPrio > uXPrio) {
+        uXPrio      = uXSystemPrio;
+        u8Partition = 0;
+    }
+#endif // #if KERNEL_PARTITIONS
     if (0 == uXPrio) {
+        // The panic handler may return; leave the next thread unchanged.
         Kernel::Panic(PANIC_NO_READY_THREADS);
+        return;
     }
     // Priorities are one-indexed
     uXPrio--;
 
+#if KERNEL_PREEMPT_THRESHOLD
+    // Once scheduled, a thread with a preemption threshold keeps running
+    // until a thread above its threshold is ready - and resumes ahead of
+    // threads below its threshold if it was preempted.  Threads which have
+    // since blocked, stopped, moved core, or whose partition's window has
+    // ended lose that protection.
+    auto* pclProtected = m_apclProtected[u8Core];
+    while ((nullptr != pclProtected)
+           && ((ThreadState::Ready != pclProtected->GetState()) || (u8Core != pclProtected->GetCore())
+               || !IsEligible(pclProtected))) {
+        pclProtected = pclProtected->m_pclPreempted;
+    }
+    m_apclProtected[u8Core] = pclProtected;
+    if ((nullptr != pclProtected) && (uXPrio <= pclProtected->m_uXPreemptThreshold)) {
+        g_pclNext = pclProtected;
+        return;
+    }
+#endif // #if KERNEL_PREEMPT_THRESHOLD
+
     // Get the thread node at this priority.
-    g_pclNext = m_aclPriorities[uXPrio].GetHead();
+    auto* pclNext = m_aclPriorities[u8Core][u8Partition][uXPrio].GetHead();
+#if KERNEL_EDF
+    // Within the EDF band, run the thread with the earliest deadline
+    if (KERNEL_EDF_PRIORITY == uXPrio) {
+        pclNext = m_aclDeadlines[u8Core][u8Partition].GetHead();
+    }
+#endif // #if KERNEL_EDF
+
+#if KERNEL_PREEMPT_THRESHOLD
+    if (pclNext->m_uXPreemptThreshold > pclNext->GetCurPriority()) {
+        pclNext->m_pclPreempted = pclProtected;
+        m_apclProtected[u8Core] = pclNext;
+    }
+#endif // #if KERNEL_PREEMPT_THRESHOLD
+    g_pclNext = pclNext;
+}
+
+//---------------------------------------------------------------------------
+bool Scheduler::WillPreempt(Thread* pclThread_)
+{
+#if KERNEL_PARTITIONS
+    if (!IsEligible(pclThread_)) {
+        return false;
+    }
+#endif // #if KERNEL_PARTITIONS
+    auto* pclCurrent = GetCurrentThread();
+#if KERNEL_PREEMPT_THRESHOLD
+    if (pclCurrent->m_uXPreemptThreshold > pclCurrent->GetCurPriority()) {
+        return (pclThread_->GetCurPriority() > pclCurrent->m_uXPreemptThreshold);
+    }
+#endif // #if KERNEL_PREEMPT_THRESHOLD
+    return (pclThread_->GetCurPriority() >= pclCurrent->GetCurPriority());
 }
 
 //---------------------------------------------------------------------------
@@ -60,7 +161,31 @@ void Scheduler::Add(Thread* pclThread_)
 {
     KERNEL_ASSERT(pclThread_ != nullptr);
 
-    m_aclPriorities[pclThread_->GetPriority()].Add(pclThread_);
+    auto u8Core      = pclThread_->GetCore();
+    auto u8Partition = pclThread_->GetPartition();
+    m_aclPriorities[u8Core][u8Partition][pclThread_->GetPriority()].Add(pclThread_);
+#if KERNEL_EDF
+    // Each time a thread in the EDF band becomes ready, its deadline is
+    // relative to that moment.
+    if (KERNEL_EDF_PRIORITY == pclThread_->GetPriority()) {
+        m_aclDeadlines[u8Core][u8Partition].Add(pclThread_, Kernel::GetTicks() + pclThread_->GetDeadline());
+    }
+#endif // #if KERNEL_EDF
+#if KERNEL_TRACE
+    KernelTrace::Record(TraceEvent::ThreadReady, pclThread_, nullptr, static_cast<uint16_t>(pclThread_->GetPriority()));
+#endif // #if KERNEL_TRACE
+
+#if KERNEL_SMP
+    // A core only reschedules in response to its own events - if this thread
+    // should preempt whatever another core is running, interrupt that core.
+    if (u8Core != GetCurrentCore()) {
+        auto* pclRemote = g_apclCurrent[u8Core];
+        if ((nullptr != pclRemote) && IsEligible(pclThread_)
+            && (pclThread_->GetCurPriority() >= pclRemote->GetCurPriority())) {
+            ThreadPort::SendIpi(u8Core);
+        }
+    }
+#endif // #if KERNEL_SMP
 }
 
 //---------------------------------------------------------------------------
@@ -68,21 +193,89 @@ void Scheduler::Remove(Thread* pclThread_)
 {
     KERNEL_ASSERT(pclThread_ != nullptr);
 
-    m_aclPriorities[pclThread_->GetPriority()].Remove(pclThread_);
+    auto u8Core      = pclThread_->GetCore();
+    auto u8Partition = pclThread_->GetPartition();
+    m_aclPriorities[u8Core][u8Partition][pclThread_->GetPriority()].Remove(pclThread_);
+#if KERNEL_EDF
+    if (KERNEL_EDF_PRIORITY == pclThread_->GetPriority()) {
+        m_aclDeadlines[u8Core][u8Partition].Remove(pclThread_);
+    }
+#endif // #if KERNEL_EDF
 }
 
+#if KERNEL_SMP
 //---------------------------------------------------------------------------
-bool Scheduler::SetScheduler(bool bEnable_)
+uint8_t Scheduler::AssignCore()
+{
+    const auto cs = CriticalGuard {};
+
+    auto u8Core  = m_u8NextCore;
+    m_u8NextCore = static_cast<uint8_t>((u8Core + 1) % m_uNumCores);
+    return u8Core;
+}
+#endif // #if KERNEL_SMP
+
+//---------------------------------------------------------------------------
+bool Scheduler::IsEligible(Thread* pclThread_)
+{
+    auto u8Partition = pclThread_->GetPartition();
+    return (0 == u8Partition) || (GetActivePartition() == u8Partition);
+}
+
+//---------------------------------------------------------------------------
+void Scheduler::Lock()
 {
     const auto cs = CriticalGuard{};
-    auto bRet       = m_bEnabled;
-    m_bEnabled = bEnable_;
-    // If there was a queued scheduler evevent, dequeue and trigger an
+    auto u8Core = GetCurrentCore();
+    KERNEL_ASSERT(m_au8LockCount[u8Core] < 255);
+#if KERNEL_SMP
+    // Hold the kernel lock from the point the scheduler is disabled until
+    // it's re-enabled, keeping the other cores out of the same data.
+    if (0 == m_au8LockCount[u8Core]) {
+        PORT_CS_ENTER();
+        m_abLockHeld[u8Core] = true;
+    }
+#endif // #if KERNEL_SMP
+    m_au8LockCount[u8Core]++;
+}
+
+//---------------------------------------------------------------------------
+void Scheduler::Unlock()
+{
+    const auto cs = CriticalGuard{};
+    auto u8Core = GetCurrentCore();
+    KERNEL_ASSERT(0 != m_au8LockCount[u8Core]);
+    if (0 != --m_au8LockCount[u8Core]) {
+        return;
+    }
+#if KERNEL_SMP
+    if (m_abLockHeld[u8Core]) {
+        m_abLockHeld[u8Core] = false;
+        PORT_CS_EXIT();
+    }
+#endif // #if KERNEL_SMP
+    // If there was a queued scheduler event, dequeue and trigger an
     // immediate Yield
-    if (m_bEnabled && m_bQueuedSchedule) {
-        m_bQueuedSchedule = false;
+    if (m_abQueuedSchedule[u8Core]) {
+        m_abQueuedSchedule[u8Core] = false;
         Thread::Yield();
     }
+}
+
+//---------------------------------------------------------------------------
+bool Scheduler::SetScheduler(bool bEnable_)
+{
+    const auto cs = CriticalGuard{};
+    auto bRet = IsEnabled();
+    if (!bEnable_) {
+        if (bRet) {
+            Lock();
+        }
+    } else if (!bRet) {
+        // Unwind any nested locks, so that the last unlock re-enables
+        m_au8LockCount[GetCurrentCore()] = 1;
+        Unlock();
+    }
     return bRet;
 }
 } // namespace Mark3
@@ -0,0 +1,111 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   stackguard.cpp
+
+    @brief  Stack overflow detection
+*/
+
+#include "mark3.h"
+
+#if KERNEL_STACK_CHECK
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+void StackGuard::Init(Thread* pclThread_)
+{
+#if (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_CANARY)
+    // The canary occupies the words at the limit of the stack, furthest from
+    // the initial stack pointer.
+#if PORT_STACK_GROWS_DOWN
+    auto* pwCanary = GetLimit(pclThread_);
+#else
+    auto* pwCanary = GetLimit(pclThread_) - (m_uCanaryWords - 1);
+#endif
+    for (size_t i = 0; i < m_uCanaryWords; i++) { pwCanary[i] = m_wCanary; }
+#else
+    (void)pclThread_;
+#endif // #if (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_CANARY)
+}
+
+//---------------------------------------------------------------------------
+void StackGuard::Check(Thread* pclCurrent_, Thread* pclNext_)
+{
+#if (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_SLACK)
+    (void)pclNext_;
+    if ((nullptr != pclCurrent_) && (pclCurrent_->GetStackSlack() <= Kernel::GetStackGuardThreshold())) {
+        Kernel::Panic(PANIC_STACK_SLACK_VIOLATED);
+    }
+#else
+#if (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_CANARY)
+    // An overflow in the outgoing thread's current run - including any
+    // interrupt frames stacked on it - overwrites its canary.
+    if ((nullptr != pclCurrent_) && !IsCanaryIntact(pclCurrent_)) {
+        Kernel::Panic(PANIC_STACK_SLACK_VIOLATED);
+    }
+    if (!IsCanaryIntact(pclNext_)) {
+        Kernel::Panic(PANIC_STACK_SLACK_VIOLATED);
+    }
+#else
+    (void)pclCurrent_;
+    ThreadPort::SetStackGuard(pclNext_);
+#endif // #if (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_CANARY)
+    CheckStackTop(pclNext_);
+#endif // #if (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_SLACK)
+}
+
+//---------------------------------------------------------------------------
+K_WORD* StackGuard::GetLimit(Thread* pclThread_)
+{
+#if PORT_STACK_GROWS_DOWN
+    return pclThread_->m_pwStack;
+#else
+    return pclThread_->m_pwStack + ((pclThread_->m_uStackSize / sizeof(K_WORD)) - 1);
+#endif
+}
+
+#if (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_CANARY)
+//---------------------------------------------------------------------------
+bool StackGuard::IsCanaryIntact(Thread* pclThread_)
+{
+    // Only the innermost word of the canary is checked - it's the first to
+    // be overwritten.
+#if PORT_STACK_GROWS_DOWN
+    return GetLimit(pclThread_)[m_uCanaryWords - 1] == m_wCanary;
+#else
+    return *(GetLimit(pclThread_) - (m_uCanaryWords - 1)) == m_wCanary;
+#endif
+}
+#endif // #if (KERNEL_STACK_GUARD == KERNEL_STACK_GUARD_CANARY)
+
+//---------------------------------------------------------------------------
+void StackGuard::CheckStackTop(Thread* pclThread_)
+{
+    auto uBase = reinterpret_cast<K_ADDR>(pclThread_->m_pwStack);
+    auto uTop  = reinterpret_cast<K_ADDR>(pclThread_->m_pwStackTop);
+    auto uSize = pclThread_->m_uStackSize;
+
+    // Bytes left between the saved stack pointer and the limit of the stack
+#if PORT_STACK_GROWS_DOWN
+    auto uSlack = uTop - uBase;
+#else
+    auto uSlack = (uBase + uSize) - uTop;
+#endif
+    if ((uTop < uBase) || (uTop > (uBase + uSize)) || (uSlack <= Kernel::GetStackGuardThreshold())) {
+        Kernel::Panic(PANIC_STACK_SLACK_VIOLATED);
+    }
+}
+} // namespace Mark3
+#endif // #if KERNEL_STACK_CHECK
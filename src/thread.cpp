@@ -40,6 +40,9 @@ Thread::~Thread()
         m_pclCurrent = nullptr;
         m_pclOwner   = nullptr;
         m_eState     = ThreadState::Exit;        
+#if KERNEL_RUN_TIME
+        RunTime::Remove(this);
+#endif // #if KERNEL_RUN_TIME
     } else if (ThreadState::Exit != m_eState) {
         Kernel::Panic(PANIC_RUNNING_THREAD_DESCOPED);
     }
@@ -47,9 +50,18 @@ Thread::~Thread()
 
 //---------------------------------------------------------------------------
 void Thread::Init(
-    K_WORD* pwStack_, uint16_t u16StackSize_, PORT_PRIO_TYPE uXPriority_, ThreadEntryFunc pfEntryPoint_, void* pvArg_)
+    K_WORD* pwStack_, K_ADDR uStackSize_, PORT_PRIO_TYPE uXPriority_, ThreadEntryFunc pfEntryPoint_, void* pvArg_)
 {
-    static auto u8ThreadID = uint8_t { 0 };
+    static KERNEL_INSTANCE_STATE auto u8ThreadID = uint8_t { 0 };
+
+    // The ports' context switch code finds the stack-top pointer at a fixed
+    // offset.  Thread isn't a standard-layout type (it inherits its list
+    // links), but GCC lays it out predictably, so offsetof() is safe here.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+    static_assert(offsetof(Thread, m_pwStackTop) == PORT_THREAD_STACK_TOP_OFFSET,
+                  "PORT_THREAD_STACK_TOP_OFFSET doesn't match the Thread layout");
+#pragma GCC diagnostic pop
 
     KERNEL_ASSERT(pwStack_);
     KERNEL_ASSERT(pfEntryPoint_);
@@ -60,9 +72,9 @@ void Thread::Init(
 
     // Initialize the thread parameters to their initial values.
     m_pwStack    = pwStack_;
-    m_pwStackTop = PORT_TOP_OF_STACK(pwStack_, u16StackSize_);
+    m_pwStackTop = PORT_TOP_OF_STACK(pwStack_, uStackSize_);
 
-    m_u16StackSize  = u16StackSize_;
+    m_uStackSize    = uStackSize_;
     m_uXPriority    = uXPriority_;
     m_uXCurPriority = m_uXPriority;
     m_pfEntryPoint  = pfEntryPoint_;
@@ -74,16 +86,52 @@ void Thread::Init(
 #if KERNEL_ROUND_ROBIN
     m_u16Quantum = THREAD_QUANTUM_DEFAULT;
 #endif
+#if KERNEL_COST_MODEL
+    m_u64EstCycles = 0;
+#endif // #if KERNEL_COST_MODEL
+#if KERNEL_RUN_TIME
+    RunTime::Add(this);
+#endif // #if KERNEL_RUN_TIME
+#if KERNEL_EDF
+    m_u32Deadline    = 0;
+    m_u32AbsDeadline = 0;
+    m_u16HeapIndex   = 0;
+#endif // #if KERNEL_EDF
+#if KERNEL_BUDGET
+    m_u32Budget           = 0;
+    m_u32BudgetRemain     = 0;
+    m_uXExhaustedPriority = 0;
+    m_uXBudgetPriority    = 0;
+    m_bBudgetExhausted    = false;
+    m_clBudgetTimer.Init();
+#endif // #if KERNEL_BUDGET
+#if KERNEL_PERIODIC_THREADS
+    m_u32Period  = 0;
+    m_u32Release = 0;
+#endif // #if KERNEL_PERIODIC_THREADS
+#if KERNEL_PREEMPT_THRESHOLD
+    m_uXPreemptThreshold = uXPriority_;
+    m_pclPreempted       = nullptr;
+#endif // #if KERNEL_PREEMPT_THRESHOLD
+#if KERNEL_PARTITIONS
+    m_u8Partition = 0;
+#endif // #if KERNEL_PARTITIONS
+#if KERNEL_SMP
+    m_u8Core = Scheduler::AssignCore();
+#endif // #if KERNEL_SMP
 
     m_clTimer.Init();
 
     // Call CPU-specific stack initialization
     ThreadPort::InitStack(this);
+#if KERNEL_STACK_CHECK
+    StackGuard::Init(this);
+#endif // #if KERNEL_STACK_CHECK
 
     // Add to the global "stop" list.
     { // Begin critical section
         const auto cs = CriticalGuard{};
-        m_pclOwner   = Scheduler::GetThreadList(m_uXPriority);
+        m_pclOwner   = Scheduler::GetThreadList(m_uXPriority, GetCore(), GetPartition());
         m_pclCurrent = Scheduler::GetStopList();
         m_eState     = ThreadState::Stop;
         m_pclCurrent->Add(this);
@@ -98,11 +146,11 @@ void Thread::Init(
 }
 
 //---------------------------------------------------------------------------
-Thread* Thread::Init(uint16_t u16StackSize_, PORT_PRIO_TYPE uXPriority_, ThreadEntryFunc pfEntryPoint_, void* pvArg_)
+Thread* Thread::Init(K_ADDR uStackSize_, PORT_PRIO_TYPE uXPriority_, ThreadEntryFunc pfEntryPoint_, void* pvArg_)
 {
     auto* pclNew  = AutoAlloc::NewObject<Thread, AutoAllocType::Thread>();
-    auto* pwStack = static_cast<K_WORD*>(AutoAlloc::NewRawData(u16StackSize_));
-    pclNew->Init(pwStack, u16StackSize_, uXPriority_, pfEntryPoint_, pvArg_);
+    auto* pwStack = static_cast<K_WORD*>(AutoAlloc::NewRawData(uStackSize_));
+    pclNew->Init(pwStack, uStackSize_, uXPriority_, pfEntryPoint_, pvArg_);
     return pclNew;
 }
 
@@ -115,15 +163,21 @@ void Thread::Start(void)
     // to the scheduler's ready list at the proper priority.
 
     const auto cs = CriticalGuard{};
+#if KERNEL_TRACE
+    KernelTrace::Record(TraceEvent::ThreadStart,
+                        this,
+                        nullptr,
+                        static_cast<uint16_t>((m_u8ThreadID << 8) | static_cast<uint8_t>(m_uXPriority)));
+#endif // #if KERNEL_TRACE
     Scheduler::GetStopList()->Remove(this);
     Scheduler::Add(this);
-    m_pclOwner   = Scheduler::GetThreadList(m_uXPriority);
+    m_pclOwner   = Scheduler::GetThreadList(m_uXPriority, GetCore(), GetPartition());
     m_pclCurrent = m_pclOwner;
     m_eState     = ThreadState::Ready;
 
 #if KERNEL_ROUND_ROBIN
     if (Kernel::IsStarted()) {
-        if (GetCurPriority() >= Scheduler::GetCurrentThread()->GetCurPriority()) {
+        if (Scheduler::WillPreempt(this)) {
             // Deal with the thread Quantum
             Quantum::Update(this);
         }
@@ -131,7 +185,7 @@ void Thread::Start(void)
 #endif
 
     if (Kernel::IsStarted()) {
-        if (GetCurPriority() >= Scheduler::GetCurrentThread()->GetCurPriority()) {
+        if (Scheduler::WillPreempt(this)) {
             Thread::Yield();
         }
     }    
@@ -158,6 +212,10 @@ void Thread::Stop()
             Quantum::Cancel();
 #endif
         }
+#if KERNEL_ROUND_ROBIN
+        // The thread may be stopped by another while its quantum is running
+        Quantum::Remove(this);
+#endif
 
         // Add this thread to the stop-list (removing it from active scheduling)
         // Remove the thread from scheduling
@@ -196,6 +254,9 @@ void Thread::Exit()
 
     { // Begin critical section
         const auto cs = CriticalGuard{};
+#if KERNEL_TRACE
+        KernelTrace::Record(TraceEvent::ThreadExit, this, nullptr);
+#endif // #if KERNEL_TRACE
 
         // If this thread is the actively-running thread, make sure we run the
         // scheduler again.
@@ -206,6 +267,10 @@ void Thread::Exit()
             Quantum::Cancel();
 #endif
         }
+#if KERNEL_ROUND_ROBIN
+        // The thread may be exited by another while its quantum is running
+        Quantum::Remove(this);
+#endif
 
         // Remove the thread from scheduling
         if (ThreadState::Ready == m_eState) {
@@ -230,6 +295,14 @@ void Thread::Exit()
         // from the timer-scheduler (does no harm if it isn't
         // in the timer-list)
         TimerScheduler::Remove(&m_clTimer);
+#if KERNEL_BUDGET
+        m_clBudgetTimer.Stop();
+        m_u32Budget        = 0;
+        m_bBudgetExhausted = false;
+#endif // #if KERNEL_BUDGET
+#if KERNEL_RUN_TIME
+        RunTime::Remove(this);
+#endif // #if KERNEL_RUN_TIME
     } // End Critical Section
 
 #if KERNEL_THREAD_EXIT_CALLOUT
@@ -266,15 +339,67 @@ void Thread::Sleep(uint32_t u32TimeMs_)
     clSemaphore.Pend();
 }
 
-#if KERNEL_STACK_CHECK
 //---------------------------------------------------------------------------
-uint16_t Thread::GetStackSlack()
+void Thread::SleepUntil(uint32_t u32Tick_)
+{
+    auto  clSemaphore    = Semaphore {};
+    auto* pclTimer       = g_pclCurrent->GetTimer();
+    auto  lTimerCallback = [](Thread* /*pclOwner*/, void* pvData_) {
+        auto* pclSemaphore = static_cast<Semaphore*>(pvData_);
+        pclSemaphore->Post();
+    };
+
+    clSemaphore.Init(0, 1);
+
+    // The timer is armed for the tick itself rather than for the time left
+    // until it, so a tick arriving in between doesn't delay the wake-up.
+    pclTimer->Init();
+    if (pclTimer->StartAt(u32Tick_, lTimerCallback, &clSemaphore)) {
+        clSemaphore.Pend();
+    }
+}
+
+#if KERNEL_PERIODIC_THREADS
+//---------------------------------------------------------------------------
+void Thread::SetPeriod(uint32_t u32Period_)
+{
+    KERNEL_ASSERT(0 != u32Period_);
+
+    m_u32Period  = u32Period_;
+    m_u32Release = Kernel::GetTicks();
+}
+
+//---------------------------------------------------------------------------
+uint32_t Thread::WaitForPeriod(void)
+{
+    auto* pclThread = g_pclCurrent;
+    auto  u32Period = pclThread->m_u32Period;
+    KERNEL_ASSERT(0 != u32Period);
+
+    auto u32Release = pclThread->m_u32Release + u32Period;
+    auto u32Late    = Kernel::GetTicks() - u32Release;
+    auto u32Skipped = uint32_t { 0 };
+    if (static_cast<int32_t>(u32Late) >= 0) {
+        // Overrun - move on to the latest release that's due
+        u32Skipped = u32Late / u32Period;
+        u32Release += u32Skipped * u32Period;
+    }
+    pclThread->m_u32Release = u32Release;
+
+    SleepUntil(u32Release);
+    return u32Skipped;
+}
+#endif // #if KERNEL_PERIODIC_THREADS
+
+#if KERNEL_STACK_PAINT
+//---------------------------------------------------------------------------
+K_ADDR Thread::GetStackSlack()
 {
     KERNEL_ASSERT(IsInitialized());
 
-    auto wBottom = uint16_t { 0 };
-    auto wTop    = static_cast<uint16_t>((m_u16StackSize - 1) / sizeof(K_WORD));
-    auto wMid    = static_cast<uint16_t>(((wTop + wBottom) + 1) / 2);
+    auto wBottom = K_ADDR { 0 };
+    auto wTop    = static_cast<K_ADDR>((m_uStackSize - 1) / sizeof(K_WORD));
+    auto wMid    = static_cast<K_ADDR>(((wTop + wBottom) + 1) / 2);
 
     { // Begin critical section
         const auto cs = CriticalGuard{};
@@ -303,6 +428,14 @@ uint16_t Thread::GetStackSlack()
 //---------------------------------------------------------------------------
 void Thread::Yield()
 {
+#if KERNEL_DEFERRED_POST
+    // Carry out any requests queued by interrupts before choosing the next
+    // thread, so that the whole batch costs a single reschedule.
+    if (DeferredPost::IsDraining()) {
+        return;
+    }
+    DeferredPost::Drain();
+#endif // #if KERNEL_DEFERRED_POST
     const auto cs = CriticalGuard{};
     // Run the scheduler
     if (Scheduler::IsEnabled()) {
@@ -333,7 +466,7 @@ void Thread::SetPriorityBase(PORT_PRIO_TYPE /*uXPriority_*/)
     KERNEL_ASSERT(IsInitialized());
 
     GetCurrent()->Remove(this);
-    SetCurrent(Scheduler::GetThreadList(m_uXPriority));
+    SetCurrent(Scheduler::GetThreadList(m_uXPriority, GetCore(), GetPartition()));
     GetCurrent()->Add(this);
 }
 
@@ -383,19 +516,89 @@ void Thread::InheritPriority(PORT_PRIO_TYPE uXPriority_)
 {
     KERNEL_ASSERT(IsInitialized());
 
-    SetOwner(Scheduler::GetThreadList(uXPriority_));
+    SetOwner(Scheduler::GetThreadList(uXPriority_, GetCore(), GetPartition()));
     m_uXCurPriority = uXPriority_;
 }
 
+#if KERNEL_SMP
+//---------------------------------------------------------------------------
+void Thread::SetCore(uint8_t u8Core_)
+{
+    KERNEL_ASSERT(IsInitialized());
+    KERNEL_ASSERT(u8Core_ < KERNEL_NUM_CORES);
+
+    const auto cs = CriticalGuard{};
+    KERNEL_ASSERT((this == g_pclCurrent) || (this != g_apclCurrent[m_u8Core]));
+
+    if (ThreadState::Ready == m_eState) {
+        Scheduler::Remove(this);
+        m_u8Core = u8Core_;
+        Scheduler::Add(this);
+        m_pclOwner   = Scheduler::GetThreadList(m_uXCurPriority, m_u8Core, GetPartition());
+        m_pclCurrent = m_pclOwner;
+
+        // If moving ourself, switch out while still in the critical section,
+        // so that the new core can't pick us up until our context is saved.
+        if (this == g_pclCurrent) {
+#if KERNEL_ROUND_ROBIN
+            Quantum::Cancel();
+#endif // #if KERNEL_ROUND_ROBIN
+            Thread::Yield();
+        }
+    } else {
+        // Blocked/stopped threads are placed on the new core's ready list
+        // when they are next woken/started.
+        m_u8Core   = u8Core_;
+        m_pclOwner = Scheduler::GetThreadList(m_uXCurPriority, m_u8Core, GetPartition());
+    }
+}
+#endif // #if KERNEL_SMP
+
+#if KERNEL_PARTITIONS
+//---------------------------------------------------------------------------
+void Thread::SetPartition(uint8_t u8Partition_)
+{
+    KERNEL_ASSERT(IsInitialized());
+    if (u8Partition_ >= KERNEL_NUM_PARTITIONS) {
+        // The panic handler may return; the partition indexes the ready lists.
+        Kernel::Panic(PANIC_PARTITION_INVALID);
+        return;
+    }
+
+    auto bReschedule = false;
+    { // Begin critical section
+        const auto cs = CriticalGuard{};
+        if (ThreadState::Ready == m_eState) {
+            Scheduler::Remove(this);
+            m_u8Partition = u8Partition_;
+            Scheduler::Add(this);
+            m_pclOwner   = Scheduler::GetThreadList(m_uXPriority, GetCore(), m_u8Partition);
+            m_pclCurrent = m_pclOwner;
+
+            // Moving ourself out of the active partition, or moving another
+            // thread into it, may change which thread should be running.
+            bReschedule = Kernel::IsStarted() && ((this == g_pclCurrent) || Scheduler::WillPreempt(this));
+        } else {
+            // Blocked/stopped threads are placed on the new partition's ready
+            // list when they are next woken/started.
+            m_u8Partition = u8Partition_;
+            m_pclOwner    = Scheduler::GetThreadList(m_uXPriority, GetCore(), m_u8Partition);
+        }
+    } // End critical section
+
+    if (bReschedule) {
+        Thread::Yield();
+    }
+}
+#endif // #if KERNEL_PARTITIONS
+
 //---------------------------------------------------------------------------
 void Thread::ContextSwitchSWI()
 {
     // Call the context switch interrupt if the scheduler is enabled.
     if (Scheduler::IsEnabled()) {
 #if KERNEL_STACK_CHECK
-        if (g_pclCurrent && (g_pclCurrent->GetStackSlack() <= Kernel::GetStackGuardThreshold())) {
-            Kernel::Panic(PANIC_STACK_SLACK_VIOLATED);
-        }
+        StackGuard::Check(g_pclCurrent, g_pclNext);
 #endif
 #if KERNEL_CONTEXT_SWITCH_CALLOUT
         auto pfCallout = Kernel::GetThreadContextSwitchCallout();
@@ -403,6 +606,23 @@ void Thread::ContextSwitchSWI()
             pfCallout(g_pclCurrent);
         }
 #endif
+#if KERNEL_COST_MODEL
+        CostModel::Charge(CostEvent::ContextSwitch);
+#endif // #if KERNEL_COST_MODEL
+#if KERNEL_BUDGET
+        Budget::Update(g_pclNext);
+#endif // #if KERNEL_BUDGET
+#if KERNEL_RUN_TIME
+        RunTime::Update();
+#endif // #if KERNEL_RUN_TIME
+#if KERNEL_TRACE
+        if (g_pclCurrent != g_pclNext) {
+            KernelTrace::Record(TraceEvent::ContextSwitch,
+                                g_pclCurrent,
+                                g_pclNext,
+                                static_cast<uint16_t>(g_pclNext->GetCurPriority()));
+        }
+#endif // #if KERNEL_TRACE
         KernelSWI::Trigger();
     }
 }
@@ -47,6 +47,9 @@ void ThreadList::SetMapPointer(PriorityMap* pclMap_)
 void ThreadList::Add(Thread* pclThread_)
 {
     KERNEL_ASSERT(pclThread_ != nullptr);
+#if KERNEL_COST_MODEL
+    CostModel::Charge(CostEvent::ThreadListAdd);
+#endif // #if KERNEL_COST_MODEL
 
     // If list was empty, add the object for global threadlist tracking
     if (!GetHead()) {
@@ -71,6 +74,9 @@ void ThreadList::AddPriority(Thread* pclThread_)
         Add(pclThread_);
         return;
     }
+#if KERNEL_COST_MODEL
+    CostModel::Charge(CostEvent::ThreadListAdd);
+#endif // #if KERNEL_COST_MODEL
     auto uXHeadPri = pclCurr->GetCurPriority();
     auto* pclTail = GetTail();
 
@@ -110,6 +116,9 @@ void ThreadList::Add(Thread* node_, PriorityMap* pclMap_, PORT_PRIO_TYPE uXPrior
 //---------------------------------------------------------------------------
 void ThreadList::Remove(Thread* node_)
 {
+#if KERNEL_COST_MODEL
+    CostModel::Charge(CostEvent::ThreadListRemove);
+#endif // #if KERNEL_COST_MODEL
     // Remove the thread from the list
     TypedCircularLinkList<Thread>::Remove(node_);
 
@@ -22,5 +22,5 @@ See license.txt for more information
 #include "threadlistlist.h"
 
 namespace Mark3 {
-TypedDoubleLinkList<ThreadList> ThreadListList::m_clThreadListList;
+KERNEL_INSTANCE_STATE TypedDoubleLinkList<ThreadList> ThreadListList::m_clThreadListList;
 } // namespace Mark3
@@ -0,0 +1,58 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   tickless.cpp
+
+    @brief  Tick suppression while the system is idle
+*/
+
+#include "mark3.h"
+
+#if KERNEL_TICKLESS
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+void Tickless::Idle()
+{
+    const auto cs = CriticalGuard{};
+
+    // With interrupts disabled and only the idle thread ready, the timer
+    // thread has processed every tick so far, and nothing else can start or
+    // stop a timer until we wake.  No active timers means nothing to wake
+    // for, so sleep for as long as the timer allows.
+    auto u32Ticks = TimerScheduler::GetNextExpiry();
+    if ((uTimerTicksInvalid == u32Ticks) || (u32Ticks > PORT_TICKLESS_MAX_TICKS)) {
+        u32Ticks = PORT_TICKLESS_MAX_TICKS;
+    }
+#if KERNEL_PARTITIONS
+    // Threads in the next window may be ready, but can't run until it starts
+    auto u32Window = PartitionScheduler::GetTicksRemaining();
+    if ((0 != u32Window) && (u32Window < u32Ticks)) {
+        u32Ticks = u32Window;
+    }
+#endif // #if KERNEL_PARTITIONS
+
+    // Not worth suppressing the tick for an event due on the next one
+    if (u32Ticks < KERNEL_TICKLESS_MIN_TICKS) {
+        KernelTimer::Wait();
+        return;
+    }
+
+    KernelTimer::Suppress(u32Ticks);
+    KernelTimer::Wait();
+    KernelTimer::Resume();
+}
+} // namespace Mark3
+#endif // #if KERNEL_TICKLESS
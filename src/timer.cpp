@@ -23,7 +23,7 @@ See license.txt for more information
 
 namespace Mark3
 {
-TimerList TimerScheduler::m_clTimerList;
+KERNEL_INSTANCE_STATE TimerScheduler::TimerBackend TimerScheduler::m_clTimers;
 
 //---------------------------------------------------------------------------
 Timer::Timer()
@@ -41,8 +41,13 @@ void Timer::Init()
 
     ClearNode();
     m_u32Interval = 0;
+#if KERNEL_TIMER_WHEEL
+    m_u32Expiry = 0;
+    m_u8Slot    = uTimerSlotNone;
+#else
     m_u32TimeLeft = 0;
-    m_u8Flags     = 0;
+#endif // #if KERNEL_TIMER_WHEEL
+    m_u8Flags = 0;
 
     SetInitialized();
 }
@@ -69,6 +74,26 @@ void Timer::Start(bool bRepeat_, uint32_t u32IntervalMs_, TimerCallback pfCallba
     Start();
 }
 
+//---------------------------------------------------------------------------
+bool Timer::StartAt(uint32_t u32Tick_, TimerCallback pfCallback_, void* pvData_)
+{
+    KERNEL_ASSERT(IsInitialized());
+
+    if ((m_u8Flags & uTimerFlagActive) != 0) {
+        return false;
+    }
+
+    // The timer scheduler converts the tick count to an interval as the
+    // timer is added.
+    m_u32Interval = u32Tick_;
+    m_pfCallback  = pfCallback_;
+    m_pvData      = pvData_;
+    m_u8Flags     = uTimerFlagOneShot | uTimerFlagAbsolute;
+
+    Start();
+    return (m_u8Flags & uTimerFlagActive) != 0;
+}
+
 //---------------------------------------------------------------------------
 void Timer::Start()
 {
@@ -21,6 +21,8 @@ See license.txt for more information
 */
 
 #include "mark3.h"
+
+#if !KERNEL_TIMER_WHEEL
 namespace Mark3
 {
 //---------------------------------------------------------------------------
@@ -36,12 +38,25 @@ void TimerList::Add(Timer* pclListNode_)
 {
     KERNEL_ASSERT(nullptr != pclListNode_);
     auto lock = LockGuard { &m_clMutex };
+#if KERNEL_COST_MODEL
+    CostModel::Charge(CostEvent::TimerListAdd);
+#endif // #if KERNEL_COST_MODEL
+
+    // Set the initial timer value.  A zero interval expires on the next tick.
+    auto u32Interval = pclListNode_->m_u32Interval;
+    if ((pclListNode_->m_u8Flags & uTimerFlagAbsolute) != 0) {
+        // Ticks counted from here on can't be processed until the list is
+        // unlocked, so they count towards this timer.
+        u32Interval = u32Interval - Kernel::GetTicks();
+        if (static_cast<int32_t>(u32Interval) <= 0) {
+            pclListNode_->m_u8Flags |= uTimerFlagExpired;
+            return;
+        }
+    }
 
     pclListNode_->ClearNode();
     TypedDoubleLinkList<Timer>::Add(pclListNode_);
-
-    // Set the initial timer value
-    pclListNode_->m_u32TimeLeft = pclListNode_->m_u32Interval;
+    pclListNode_->m_u32TimeLeft = (0 != u32Interval) ? u32Interval : 1;
 
     // Set the timer as active.
     pclListNode_->m_u8Flags |= uTimerFlagActive;
@@ -52,42 +67,89 @@ void TimerList::Remove(Timer* pclLinkListNode_)
 {
     KERNEL_ASSERT(nullptr != pclLinkListNode_);
     auto lock = LockGuard { &m_clMutex };
+#if KERNEL_COST_MODEL
+    CostModel::Charge(CostEvent::TimerListRemove);
+#endif // #if KERNEL_COST_MODEL
 
     TypedDoubleLinkList<Timer>::Remove(pclLinkListNode_);
     pclLinkListNode_->m_u8Flags &= ~uTimerFlagActive;
 }
 
 //---------------------------------------------------------------------------
-void TimerList::Process(void)
+void TimerList::Process(uint32_t u32Ticks_)
 {
     auto lock = LockGuard { &m_clMutex };
 
+#if KERNEL_COST_MODEL
+    auto u16Nodes = uint16_t { 0 };
+#endif // #if KERNEL_COST_MODEL
+
     auto* pclCurr = GetHead();
     // Subtract the elapsed time interval from each active timer.
     while (nullptr != pclCurr) {
         auto* pclNext = pclCurr->GetNext();
+#if KERNEL_COST_MODEL
+        u16Nodes++;
+#endif // #if KERNEL_COST_MODEL
+
+        // Active timers only.  A periodic timer expires once for each of its
+        // periods covered by the elapsed interval, and stays in phase.
+        auto u32Elapsed = u32Ticks_;
+        while (((pclCurr->m_u8Flags & uTimerFlagActive) != 0) && (pclCurr->m_u32TimeLeft <= u32Elapsed)) {
+            u32Elapsed -= pclCurr->m_u32TimeLeft;
+
+            // Expired -- run the callback. these callbacks must be very fast...
+#if KERNEL_TRACE
+            KernelTrace::Record(TraceEvent::TimerExpiry, pclCurr->m_pclOwner, pclCurr);
+#endif // #if KERNEL_TRACE
+            if (nullptr != pclCurr->m_pfCallback) {
+                pclCurr->m_pfCallback(pclCurr->m_pclOwner, pclCurr->m_pvData);
+            }
+            if ((pclCurr->m_u8Flags & uTimerFlagOneShot) != 0) {
+                // If this was a one-shot timer, deactivate the timer + remove
+                pclCurr->m_u8Flags |= uTimerFlagExpired;
+                pclCurr->m_u8Flags &= ~uTimerFlagActive;
+                Remove(pclCurr);
+            } else {
+                // Reset the interval timer.
+                auto u32Interval       = pclCurr->m_u32Interval;
+                pclCurr->m_u32TimeLeft = (0 != u32Interval) ? u32Interval : 1;
+            }
+        }
+        if ((pclCurr->m_u8Flags & uTimerFlagActive) != 0) {
+            pclCurr->m_u32TimeLeft -= u32Elapsed;
+        }
+        pclCurr = pclNext;
+    }
+#if KERNEL_COST_MODEL
+    CostModel::Charge(CostEvent::TimerNode, u16Nodes);
+#endif // #if KERNEL_COST_MODEL
+}
+
+//---------------------------------------------------------------------------
+uint32_t TimerList::GetNextExpiry(void)
+{
+    const auto cs = CriticalGuard {};
 
-        // Active timers only...
+    // A thread holding the mutex may be part-way through relinking the list,
+    // so it can't be walked safely.  Only the next tick is known to be safe.
+    if (m_clMutex.IsClaimed()) {
+        return 1;
+    }
+
+    auto u32Next = uTimerTicksInvalid;
+
+    auto* pclCurr = GetHead();
+    while (nullptr != pclCurr) {
         if ((pclCurr->m_u8Flags & uTimerFlagActive) != 0) {
-            pclCurr->m_u32TimeLeft--;
-            if (0 == pclCurr->m_u32TimeLeft) {
-                // Expired -- run the callback. these callbacks must be very fast...
-                if (nullptr != pclCurr->m_pfCallback) {
-                    pclCurr->m_pfCallback(pclCurr->m_pclOwner, pclCurr->m_pvData);
-                }
-                if ((pclCurr->m_u8Flags & uTimerFlagOneShot) != 0) {
-                    // If this was a one-shot timer, deactivate the timer + remove
-                    pclCurr->m_u8Flags |= uTimerFlagExpired;
-                    pclCurr->m_u8Flags &= ~uTimerFlagActive;
-                    Remove(pclCurr);
-                } else {
-                    // Reset the interval timer.
-                    pclCurr->m_u32TimeLeft = pclCurr->m_u32Interval;
-                }
+            if ((uTimerTicksInvalid == u32Next) || (pclCurr->m_u32TimeLeft < u32Next)) {
+                u32Next = pclCurr->m_u32TimeLeft;
             }
         }
-        pclCurr = pclNext;
+        pclCurr = pclCurr->GetNext();
     }
+    return u32Next;
 }
 
 } // namespace Mark3
+#endif // #if !KERNEL_TIMER_WHEEL
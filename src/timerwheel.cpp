@@ -0,0 +1,254 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   timerwheel.cpp
+
+    @brief  Hierarchical timing wheel, used to manage active timers
+*/
+
+#include "mark3.h"
+
+#if KERNEL_TIMER_WHEEL
+namespace Mark3
+{
+//---------------------------------------------------------------------------
+void TimerWheel::Init()
+{
+    for (auto& clSlot : m_aclSlots) { clSlot.Init(); }
+    for (auto& u32Occupied : m_au32Occupied) { u32Occupied = 0; }
+    m_u32Now = 0;
+    m_clMutex.Init();
+}
+
+//---------------------------------------------------------------------------
+void TimerWheel::Add(Timer* pclTimer_)
+{
+    KERNEL_ASSERT(nullptr != pclTimer_);
+    auto lock = LockGuard { &m_clMutex };
+#if KERNEL_COST_MODEL
+    CostModel::Charge(CostEvent::TimerListAdd);
+#endif // #if KERNEL_COST_MODEL
+
+    // As with the timer list, a timer with a zero interval expires on the next
+    // tick, and an absolute one is converted to an interval with the wheel
+    // locked.
+    auto u32Interval = pclTimer_->m_u32Interval;
+    if ((pclTimer_->m_u8Flags & uTimerFlagAbsolute) != 0) {
+        u32Interval = u32Interval - Kernel::GetTicks();
+        if (static_cast<int32_t>(u32Interval) <= 0) {
+            pclTimer_->m_u8Flags |= uTimerFlagExpired;
+            return;
+        }
+    }
+    pclTimer_->m_u32Expiry = m_u32Now + ((0 != u32Interval) ? u32Interval : 1);
+    File(pclTimer_);
+
+    // Set the timer as active.
+    pclTimer_->m_u8Flags |= uTimerFlagActive;
+}
+
+//---------------------------------------------------------------------------
+void TimerWheel::Remove(Timer* pclTimer_)
+{
+    KERNEL_ASSERT(nullptr != pclTimer_);
+    auto lock = LockGuard { &m_clMutex };
+#if KERNEL_COST_MODEL
+    CostModel::Charge(CostEvent::TimerListRemove);
+#endif // #if KERNEL_COST_MODEL
+
+    Unfile(pclTimer_);
+    pclTimer_->m_u8Flags &= ~uTimerFlagActive;
+}
+
+//---------------------------------------------------------------------------
+void TimerWheel::Process(uint32_t u32Ticks_)
+{
+    auto lock = LockGuard { &m_clMutex };
+
+    // Timers visited, for the cost model
+    auto u16Nodes = uint16_t { 0 };
+
+    while (0 != u32Ticks_) {
+        // Skip straight to the next tick where there's something to do
+        auto u32Step = TicksToNextSlot();
+        if (u32Step > u32Ticks_) {
+            u32Step = u32Ticks_;
+        }
+        m_u32Now += u32Step;
+        u32Ticks_ -= u32Step;
+
+        if (0 == LevelIndex(m_u32Now, 0)) {
+            u16Nodes += Cascade();
+        }
+        u16Nodes += Expire();
+    }
+#if KERNEL_COST_MODEL
+    CostModel::Charge(CostEvent::TimerNode, u16Nodes);
+#endif // #if KERNEL_COST_MODEL
+}
+
+//---------------------------------------------------------------------------
+uint32_t TimerWheel::GetNextExpiry()
+{
+    const auto cs = CriticalGuard {};
+
+    // A thread holding the mutex may be part-way through refiling a timer,
+    // so the wheel can't be read safely.  Only the next tick is known to be
+    // safe.
+    if (m_clMutex.IsClaimed()) {
+        return 1;
+    }
+
+    auto u32Next = uTimerTicksInvalid;
+
+    for (auto u8Level = uint8_t { 0 }; u8Level < m_uLevels; u8Level++) {
+        auto u32Occupied = m_au32Occupied[u8Level];
+        if (0 == u32Occupied) {
+            continue;
+        }
+
+        // Slots are visited in expiry order starting after the current index
+        // (the current slot itself has either expired, or been cascaded), so
+        // the first occupied slot holds the level's earliest timers.
+        auto u8Index = LevelIndex(m_u32Now, u8Level);
+        do {
+            u8Index = static_cast<uint8_t>((u8Index + 1) & m_uSlotMask);
+        } while (0 == (u32Occupied & (uint32_t { 1 } << u8Index)));
+
+        auto* pclCurr = m_aclSlots[(u8Level * m_uSlots) + u8Index].GetHead();
+        while (nullptr != pclCurr) {
+            auto u32Left = pclCurr->m_u32Expiry - m_u32Now;
+            if ((uTimerTicksInvalid == u32Next) || (u32Left < u32Next)) {
+                u32Next = u32Left;
+            }
+            pclCurr = pclCurr->GetNext();
+        }
+    }
+    return u32Next;
+}
+
+//---------------------------------------------------------------------------
+void TimerWheel::File(Timer* pclTimer_)
+{
+    // Use the lowest level whose span covers the time remaining.  Once filed,
+    // a timer is only visited again when it's due to expire, or when its slot
+    // is cascaded - which can't happen before the remaining time drops below
+    // the span of the level beneath.
+    auto u32Left = pclTimer_->m_u32Expiry - m_u32Now;
+    auto u8Level = uint8_t { 0 };
+    while (((u8Level + 1) < m_uLevels) && (0 != (u32Left >> ((u8Level + 1) * m_uSlotBits)))) {
+        u8Level++;
+    }
+
+    auto u8Index        = LevelIndex(pclTimer_->m_u32Expiry, u8Level);
+    pclTimer_->m_u8Slot = static_cast<uint8_t>((u8Level * m_uSlots) + u8Index);
+
+    m_aclSlots[pclTimer_->m_u8Slot].Add(pclTimer_);
+    m_au32Occupied[u8Level] |= (uint32_t { 1 } << u8Index);
+}
+
+//---------------------------------------------------------------------------
+void TimerWheel::Unfile(Timer* pclTimer_)
+{
+    auto u8Slot = pclTimer_->m_u8Slot;
+    if (uTimerSlotNone == u8Slot) {
+        return;
+    }
+
+    auto& clSlot = m_aclSlots[u8Slot];
+    clSlot.Remove(pclTimer_);
+    if (nullptr == clSlot.GetHead()) {
+        m_au32Occupied[u8Slot >> m_uSlotBits] &= ~(uint32_t { 1 } << (u8Slot & m_uSlotMask));
+    }
+    pclTimer_->m_u8Slot = uTimerSlotNone;
+}
+
+//---------------------------------------------------------------------------
+uint16_t TimerWheel::Cascade()
+{
+    // Level 1 moves on each time level 0 wraps, level 2 each time level 1
+    // wraps, and so on.  Work from the top down, so that each level's slot
+    // is emptied before the levels beneath it.
+    auto u8Top = uint8_t { 1 };
+    while (((u8Top + 1) < m_uLevels) && (0 == LevelIndex(m_u32Now, u8Top))) {
+        u8Top++;
+    }
+
+    auto u16Count = uint16_t { 0 };
+    for (auto u8Level = u8Top; u8Level != 0; u8Level--) {
+        auto& clSlot = m_aclSlots[(u8Level * m_uSlots) + LevelIndex(m_u32Now, u8Level)];
+
+        auto* pclCurr = clSlot.GetHead();
+        while (nullptr != pclCurr) {
+            Unfile(pclCurr);
+            File(pclCurr);
+            u16Count++;
+            pclCurr = clSlot.GetHead();
+        }
+    }
+    return u16Count;
+}
+
+//---------------------------------------------------------------------------
+uint16_t TimerWheel::Expire()
+{
+    // Callbacks may start or stop other timers, but can't add to this slot:
+    // anything filed from here on expires on a later tick.
+    auto& clSlot   = m_aclSlots[LevelIndex(m_u32Now, 0)];
+    auto  u16Count = uint16_t { 0 };
+
+    auto* pclCurr = clSlot.GetHead();
+    while (nullptr != pclCurr) {
+        Unfile(pclCurr);
+        u16Count++;
+
+        // Expired -- run the callback. these callbacks must be very fast...
+#if KERNEL_TRACE
+        KernelTrace::Record(TraceEvent::TimerExpiry, pclCurr->m_pclOwner, pclCurr);
+#endif // #if KERNEL_TRACE
+        if (nullptr != pclCurr->m_pfCallback) {
+            pclCurr->m_pfCallback(pclCurr->m_pclOwner, pclCurr->m_pvData);
+        }
+        if ((pclCurr->m_u8Flags & uTimerFlagOneShot) != 0) {
+            // If this was a one-shot timer, deactivate the timer
+            pclCurr->m_u8Flags |= uTimerFlagExpired;
+            pclCurr->m_u8Flags &= ~uTimerFlagActive;
+        } else if ((pclCurr->m_u8Flags & uTimerFlagActive) != 0) {
+            // Restart the interval timer, unless the callback stopped it.
+            auto u32Interval     = pclCurr->m_u32Interval;
+            pclCurr->m_u32Expiry = m_u32Now + ((0 != u32Interval) ? u32Interval : 1);
+            File(pclCurr);
+        }
+        pclCurr = clSlot.GetHead();
+    }
+    return u16Count;
+}
+
+//---------------------------------------------------------------------------
+uint32_t TimerWheel::TicksToNextSlot()
+{
+    auto u8Index = LevelIndex(m_u32Now, 0);
+
+    // Occupied level-0 slots later in the current rotation, if any.  The
+    // shift is split in two, as shifting a 32-bit word by 32 is undefined.
+    auto u32Later = (m_au32Occupied[0] >> u8Index) >> 1;
+    if (0 != u32Later) {
+        // Isolate the lowest set bit - PriorityFromBitmap() returns its index plus one.
+        return PriorityMapWord<uint32_t>::PriorityFromBitmap(u32Later & (~u32Later + 1));
+    }
+    return m_uSlots - u8Index;
+}
+} // namespace Mark3
+#endif // #if KERNEL_TIMER_WHEEL
@@ -0,0 +1,245 @@
+#include "mark3.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#if !KERNEL_COST_MODEL
+#error "cost_profile requires KERNEL_COST_MODEL"
+#endif
+
+using namespace Mark3;
+
+namespace
+{
+//---------------------------------------------------------------------------
+// Estimate the per-call target cycle cost of common kernel APIs on each of
+// the built-in cost tables, along with the per-thread totals, so that changes
+// in scheduling overhead show up without running on hardware.
+//---------------------------------------------------------------------------
+#define ITERATIONS (100)
+
+//---------------------------------------------------------------------------
+ProfileTimer clSemPostTimer;
+ProfileTimer clSemPendTimer;
+ProfileTimer clSemaphoreFlyback;
+ProfileTimer clMutexClaimTimer;
+ProfileTimer clMutexReleaseTimer;
+ProfileTimer clMailboxSendTimer;
+ProfileTimer clMailboxReceiveTimer;
+ProfileTimer clThreadStartTimer;
+ProfileTimer clYieldTimer;
+ProfileTimer clSleepTimer;
+
+//---------------------------------------------------------------------------
+Thread clMainThread;
+Thread clIdleThread;
+Thread clTestThread1;
+
+K_WORD awMainStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD awIdleStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD awTestStack1[PORT_KERNEL_DEFAULT_STACK_SIZE];
+
+//---------------------------------------------------------------------------
+Semaphore clSem;
+Mutex     clMutex;
+Mailbox   clMailbox;
+uint8_t   au8MailboxBuffer[256];
+
+//---------------------------------------------------------------------------
+const CostTable* const apclTargets[] = {
+    &CostModel::clAVR,      &CostModel::clMSP430,   &CostModel::clCortexM0,
+    &CostModel::clCortexM3, &CostModel::clCortexM4F,
+};
+
+//---------------------------------------------------------------------------
+void IdleMain(void* /*unused*/)
+{
+    while (1) {}
+}
+
+//---------------------------------------------------------------------------
+void ProfileInit()
+{
+    clSemPostTimer.Init();
+    clSemPendTimer.Init();
+    clSemaphoreFlyback.Init();
+    clMutexClaimTimer.Init();
+    clMutexReleaseTimer.Init();
+    clMailboxSendTimer.Init();
+    clMailboxReceiveTimer.Init();
+    clThreadStartTimer.Init();
+    clYieldTimer.Init();
+    clSleepTimer.Init();
+}
+
+//---------------------------------------------------------------------------
+void Semaphore_Flyback(void* /*unused*/)
+{
+    clSemaphoreFlyback.Start();
+    clSem.Pend();
+    clSemaphoreFlyback.Stop();
+
+    Scheduler::GetCurrentThread()->Exit();
+}
+
+//---------------------------------------------------------------------------
+void Semaphore_Profiling()
+{
+    clSem.Init(0, ITERATIONS);
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        clSemPostTimer.Start();
+        clSem.Post();
+        clSemPostTimer.Stop();
+    }
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        clSemPendTimer.Start();
+        clSem.Pend();
+        clSemPendTimer.Stop();
+    }
+
+    // Post to a higher-priority waiter, including the switch there and back
+    clSem.Init(0, 1);
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        clTestThread1.Init(awTestStack1, sizeof(awTestStack1), 2, Semaphore_Flyback, nullptr);
+        clTestThread1.Start();
+        clSem.Post();
+    }
+}
+
+//---------------------------------------------------------------------------
+void Mutex_Profiling()
+{
+    clMutex.Init();
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        clMutexClaimTimer.Start();
+        clMutex.Claim();
+        clMutexClaimTimer.Stop();
+
+        clMutexReleaseTimer.Start();
+        clMutex.Release();
+        clMutexReleaseTimer.Stop();
+    }
+}
+
+//---------------------------------------------------------------------------
+void Mailbox_Profiling()
+{
+    uint8_t au8Message[16] = {};
+
+    clMailbox.Init(au8MailboxBuffer, sizeof(au8MailboxBuffer), sizeof(au8Message));
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        clMailboxSendTimer.Start();
+        clMailbox.Send(au8Message);
+        clMailboxSendTimer.Stop();
+
+        clMailboxReceiveTimer.Start();
+        clMailbox.Receive(au8Message);
+        clMailboxReceiveTimer.Stop();
+    }
+}
+
+//---------------------------------------------------------------------------
+void Thread_ProfilingThread(void* /*unused*/)
+{
+    clThreadStartTimer.Stop();
+    Scheduler::GetCurrentThread()->Exit();
+}
+
+//---------------------------------------------------------------------------
+void Thread_Profiling()
+{
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        clTestThread1.Init(awTestStack1, sizeof(awTestStack1), 2, Thread_ProfilingThread, nullptr);
+        clThreadStartTimer.Start();
+        clTestThread1.Start();
+    }
+
+    // Yield with no other thread at this priority - scheduler cost only
+    for (uint16_t i = 0; i < ITERATIONS; i++) {
+        clYieldTimer.Start();
+        Thread::Yield();
+        clYieldTimer.Stop();
+    }
+
+    // Sleep covers timer setup, timer list processing, and the switches to/from idle
+    for (uint16_t i = 0; i < 10; i++) {
+        clSleepTimer.Start();
+        Thread::Sleep(1);
+        clSleepTimer.Stop();
+    }
+}
+
+//---------------------------------------------------------------------------
+void ProfilePrint(ProfileTimer* pclProfile_, const char* szName_)
+{
+    printf("  %-16s %8u\n", szName_, static_cast<unsigned>(pclProfile_->GetAverage()));
+}
+
+//---------------------------------------------------------------------------
+void ProfilePrintResults(const CostTable* pclTarget_)
+{
+    printf("[%s] estimated cycles per call\n", pclTarget_->szName);
+    ProfilePrint(&clSemPostTimer, "Semaphore::Post");
+    ProfilePrint(&clSemPendTimer, "Semaphore::Pend");
+    ProfilePrint(&clSemaphoreFlyback, "Semaphore flyback");
+    ProfilePrint(&clMutexClaimTimer, "Mutex::Claim");
+    ProfilePrint(&clMutexReleaseTimer, "Mutex::Release");
+    ProfilePrint(&clMailboxSendTimer, "Mailbox::Send");
+    ProfilePrint(&clMailboxReceiveTimer, "Mailbox::Receive");
+    ProfilePrint(&clThreadStartTimer, "Thread::Start");
+    ProfilePrint(&clYieldTimer, "Thread::Yield");
+    ProfilePrint(&clSleepTimer, "Thread::Sleep(1)");
+}
+
+//---------------------------------------------------------------------------
+void AppMain(void* /*unused*/)
+{
+    for (auto* pclTarget : apclTargets) {
+        CostModel::SetTarget(pclTarget);
+        auto u64MainStart = clMainThread.GetEstimatedCycles();
+        auto u64IdleStart = clIdleThread.GetEstimatedCycles();
+
+        ProfileInit();
+        Semaphore_Profiling();
+        Mutex_Profiling();
+        Mailbox_Profiling();
+        Thread_Profiling();
+
+        ProfilePrintResults(pclTarget);
+        printf("[%s] estimated cycles per thread\n", pclTarget->szName);
+        printf("  %-16s %8llu\n", "main", static_cast<unsigned long long>(clMainThread.GetEstimatedCycles() - u64MainStart));
+        printf("  %-16s %8llu\n", "idle", static_cast<unsigned long long>(clIdleThread.GetEstimatedCycles() - u64IdleStart));
+    }
+
+    printf("[events] count / cycles (all targets)\n");
+    static const char* const aszEvents[] = {
+        "ContextSwitch", "Schedule",    "ThreadListAdd", "ThreadListRemove", "TimerNode",       "MailboxCopy",
+        "MailboxByte",   "SemaphoreOp", "MutexOp",       "TimerListAdd",     "TimerListRemove",
+    };
+    for (uint8_t i = 0; i < static_cast<uint8_t>(CostEvent::Count); i++) {
+        auto eEvent = static_cast<CostEvent>(i);
+        printf("  %-16s %8u %10llu\n",
+               aszEvents[i],
+               static_cast<unsigned>(CostModel::GetEventCount(eEvent)),
+               static_cast<unsigned long long>(CostModel::GetEventCycles(eEvent)));
+    }
+
+    fflush(stdout);
+    _exit(0);
+}
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+int main(void)
+{
+    Kernel::Init();
+
+    clMainThread.Init(awMainStack, sizeof(awMainStack), 1, AppMain, nullptr);
+    clIdleThread.Init(awIdleStack, sizeof(awIdleStack), 0, IdleMain, nullptr);
+
+    clMainThread.Start();
+    clIdleThread.Start();
+
+    Kernel::Start();
+    return 0;
+}
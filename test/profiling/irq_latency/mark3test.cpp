@@ -0,0 +1,442 @@
+#include "mark3.h"
+#include "driver.h"
+#include "memutil.h"
+#include "ut_support.h"
+#include "m3_core_cm3.h"
+
+extern "C" void __cxa_pure_virtual() {}
+
+namespace
+{
+using namespace Mark3;
+
+//---------------------------------------------------------------------------
+// Interrupt-to-thread wake latency harness for the QEMU LM3S6965 target.
+//
+// General-purpose timer 1 fires a periodic interrupt, which wakes the
+// highest-priority thread in the system through a Semaphore, Notify, or
+// EventFlag.  The latency from the start of the interrupt handler to the
+// woken thread running is recorded in a histogram for each wake source,
+// under each background load profile, and reported over /dev/tty along with
+// min/mean/max, jitter, standard deviation, and percentiles.
+//
+// Timestamps are taken from KernelTimer::GetCycleCount() (the SysTick
+// down-counter, extended by the kernel tick count), so all figures are in CPU
+// cycles.  Run QEMU with "-icount shift=0" (or similar) so that the
+// counter advances with executed instructions rather than host time.
+//---------------------------------------------------------------------------
+#define SAMPLES (4096)
+#define HISTOGRAM_BINS (64)
+#define HISTOGRAM_BIN_WIDTH (32) //!< Cycles per histogram bin
+#define TIMER_PERIOD (PORT_SYSTEM_FREQ / 1733) //!< Deliberately not a multiple of the kernel tick
+#define BACKGROUND_TIMERS (16)
+
+//---------------------------------------------------------------------------
+// LM3S6965 system control and general-purpose timer 1 registers
+#define SYSCTL_RCGC1 (*reinterpret_cast<volatile uint32_t*>(0x400FE104))
+#define SYSCTL_RCGC1_TIMER1 (1UL << 17)
+
+#define GPTM1_BASE (0x40031000UL)
+#define GPTM1_CFG (*reinterpret_cast<volatile uint32_t*>(GPTM1_BASE + 0x000))
+#define GPTM1_TAMR (*reinterpret_cast<volatile uint32_t*>(GPTM1_BASE + 0x004))
+#define GPTM1_CTL (*reinterpret_cast<volatile uint32_t*>(GPTM1_BASE + 0x00C))
+#define GPTM1_IMR (*reinterpret_cast<volatile uint32_t*>(GPTM1_BASE + 0x018))
+#define GPTM1_ICR (*reinterpret_cast<volatile uint32_t*>(GPTM1_BASE + 0x024))
+#define GPTM1_TAILR (*reinterpret_cast<volatile uint32_t*>(GPTM1_BASE + 0x028))
+
+#define GPTM_CFG_32BIT (0x0UL)
+#define GPTM_TAMR_PERIODIC (0x2UL)
+#define GPTM_CTL_TAEN (1UL << 0)
+#define GPTM_IMR_TATOIM (1UL << 0)
+#define GPTM_ICR_TATOCINT (1UL << 0)
+
+#define TIMER1A_IRQn (21)
+#define NUM_VECTORS (16 + 64)
+
+//---------------------------------------------------------------------------
+enum class WakeSource : uint8_t {
+    Semaphore,
+    Notify,
+    EventFlag,
+    //---
+    Count
+};
+
+enum class LoadProfile : uint8_t {
+    Idle,    //!< No background load
+    Cpu,     //!< Busy-looping lower-priority thread
+    Kernel,  //!< Lower-priority thread hammering kernel objects
+    Timers,  //!< Software timers expiring on every tick
+    //---
+    Count
+};
+
+const char* const aszSourceNames[] = { "sem", "notify", "eventflag" };
+const char* const aszLoadNames[]   = { "idle", "cpu", "kernel", "timers" };
+
+//---------------------------------------------------------------------------
+/**
+ * Histogram of latency samples, with running statistics
+ */
+class Histogram
+{
+public:
+    void Init()
+    {
+        for (auto& u32Bin : m_au32Bins) { u32Bin = 0; }
+        m_u32Overflow = 0;
+        m_u32Count    = 0;
+        m_u32Min      = UINT32_MAX;
+        m_u32Max      = 0;
+        m_u64Sum      = 0;
+        m_u64SumSq    = 0;
+    }
+
+    void Add(uint32_t u32Sample_)
+    {
+        auto u32Bin = u32Sample_ / HISTOGRAM_BIN_WIDTH;
+        if (u32Bin < HISTOGRAM_BINS) {
+            m_au32Bins[u32Bin]++;
+        } else {
+            m_u32Overflow++;
+        }
+        if (u32Sample_ < m_u32Min) {
+            m_u32Min = u32Sample_;
+        }
+        if (u32Sample_ > m_u32Max) {
+            m_u32Max = u32Sample_;
+        }
+        m_u32Count++;
+        m_u64Sum += u32Sample_;
+        m_u64SumSq += static_cast<uint64_t>(u32Sample_) * u32Sample_;
+    }
+
+    uint32_t GetCount() const { return m_u32Count; }
+    uint32_t GetMin() const { return m_u32Min; }
+    uint32_t GetMax() const { return m_u32Max; }
+    uint32_t GetMean() const { return m_u32Count ? static_cast<uint32_t>(m_u64Sum / m_u32Count) : 0; }
+    uint32_t GetBin(uint8_t u8Bin_) const { return m_au32Bins[u8Bin_]; }
+    uint32_t GetOverflow() const { return m_u32Overflow; }
+
+    uint32_t GetStdDev() const
+    {
+        if (0 == m_u32Count) {
+            return 0;
+        }
+        auto u64Mean     = m_u64Sum / m_u32Count;
+        auto u64Variance = (m_u64SumSq / m_u32Count) - (u64Mean * u64Mean);
+
+        // Integer square root
+        auto u64Root = uint64_t { 0 };
+        auto u64Bit  = uint64_t { 1 } << 62;
+        while (u64Bit > u64Variance) { u64Bit >>= 2; }
+        while (0 != u64Bit) {
+            if (u64Variance >= u64Root + u64Bit) {
+                u64Variance -= u64Root + u64Bit;
+                u64Root = (u64Root >> 1) + u64Bit;
+            } else {
+                u64Root >>= 1;
+            }
+            u64Bit >>= 2;
+        }
+        return static_cast<uint32_t>(u64Root);
+    }
+
+    // Upper edge of the bin containing the given fraction (in 1/1000ths) of samples
+    uint32_t GetPercentile(uint16_t u16PerMille_) const
+    {
+        auto u32Target = static_cast<uint32_t>((static_cast<uint64_t>(m_u32Count) * u16PerMille_) / 1000);
+        auto u32Total  = uint32_t { 0 };
+        for (uint8_t i = 0; i < HISTOGRAM_BINS; i++) {
+            u32Total += m_au32Bins[i];
+            if (u32Total > u32Target) {
+                return (i + 1) * HISTOGRAM_BIN_WIDTH;
+            }
+        }
+        return m_u32Max;
+    }
+
+private:
+    uint32_t m_au32Bins[HISTOGRAM_BINS];
+    uint32_t m_u32Overflow;
+    uint32_t m_u32Count;
+    uint32_t m_u32Min;
+    uint32_t m_u32Max;
+    uint64_t m_u64Sum;
+    uint64_t m_u64SumSq;
+};
+
+//---------------------------------------------------------------------------
+Thread clMainThread;
+Thread clIdleThread;
+Thread clWakeThread;
+Thread clLoadThread;
+
+K_WORD awMainStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD awIdleStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD awWakeStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD awLoadStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+
+Semaphore clSem;
+Notify    clNotify;
+EventFlag clEventFlag;
+Semaphore clDoneSem;
+
+Semaphore clLoadSem;
+Mutex     clLoadMutex;
+Timer     aclLoadTimers[BACKGROUND_TIMERS];
+
+Histogram clHistogram;
+
+volatile WakeSource eSource;
+volatile uint32_t   u32IsrStamp;
+volatile uint32_t   u32LoadSpin;
+
+using Vector = void (*)(void);
+alignas(512) Vector apfVectors[NUM_VECTORS];
+
+//---------------------------------------------------------------------------
+void Timer1A_Handler(void)
+{
+    u32IsrStamp = KernelTimer::GetCycleCount();
+    GPTM1_ICR   = GPTM_ICR_TATOCINT;
+
+    switch (eSource) {
+        case WakeSource::Semaphore: clSem.Post(); break;
+        case WakeSource::Notify: clNotify.Signal(); break;
+        case WakeSource::EventFlag: clEventFlag.Set(0x0001); break;
+        default: break;
+    }
+}
+
+//---------------------------------------------------------------------------
+void Interrupt_Init()
+{
+    // Relocate the vector table to RAM, so the handler can be installed
+    // without depending on the BSP's startup code.
+    auto* apfOld = reinterpret_cast<const volatile Vector*>(static_cast<K_ADDR>(SCB->VTOR));
+    for (uint8_t i = 0; i < NUM_VECTORS; i++) { apfVectors[i] = apfOld[i]; }
+    apfVectors[16 + TIMER1A_IRQn] = Timer1A_Handler;
+    {
+        const auto cs = CriticalGuard{};
+        SCB->VTOR     = reinterpret_cast<K_ADDR>(apfVectors);
+    }
+
+    SYSCTL_RCGC1 |= SYSCTL_RCGC1_TIMER1;
+    GPTM1_CTL   = 0;
+    GPTM1_CFG   = GPTM_CFG_32BIT;
+    GPTM1_TAMR  = GPTM_TAMR_PERIODIC;
+    GPTM1_TAILR = TIMER_PERIOD - 1;
+    GPTM1_ICR   = GPTM_ICR_TATOCINT;
+    GPTM1_IMR   = GPTM_IMR_TATOIM;
+
+    // Same priority as the kernel tick, so it can call into the kernel
+    M3_NVIC_SetPriority(TIMER1A_IRQn, (1 << __NVIC_PRIO_BITS) - 2);
+    M3_NVIC_EnableIRQ(TIMER1A_IRQn);
+}
+
+//---------------------------------------------------------------------------
+void Interrupt_Enable(bool bEnable_)
+{
+    GPTM1_CTL = bEnable_ ? GPTM_CTL_TAEN : 0;
+    GPTM1_ICR = GPTM_ICR_TATOCINT;
+}
+
+//---------------------------------------------------------------------------
+void IdleMain(void* /*unused*/)
+{
+    while (1) {}
+}
+
+//---------------------------------------------------------------------------
+void WakeMain(void* /*unused*/)
+{
+    auto bFlag = false;
+    while (clHistogram.GetCount() < SAMPLES) {
+        switch (eSource) {
+            case WakeSource::Semaphore: clSem.Pend(); break;
+            case WakeSource::Notify: clNotify.Wait(&bFlag); break;
+            case WakeSource::EventFlag: clEventFlag.Wait(0x0001, EventFlagOperation::Any_Clear); break;
+            default: break;
+        }
+        clHistogram.Add(KernelTimer::GetCycleCount() - u32IsrStamp);
+    }
+    clDoneSem.Post();
+    Scheduler::GetCurrentThread()->Exit();
+}
+
+//---------------------------------------------------------------------------
+void LoadTimer_Callback(Thread* /*pclOwner_*/, void* /*pvData_*/)
+{
+    u32LoadSpin++;
+}
+
+//---------------------------------------------------------------------------
+void LoadMain(void* pvArg_)
+{
+    auto eLoad = static_cast<LoadProfile>(reinterpret_cast<K_ADDR>(pvArg_));
+    switch (eLoad) {
+        case LoadProfile::Cpu: {
+            while (1) { u32LoadSpin++; }
+        } break;
+        case LoadProfile::Kernel: {
+            // Constant critical sections and scheduler lock/unlock
+            while (1) {
+                clLoadMutex.Claim();
+                clLoadSem.Post();
+                clLoadSem.Pend();
+                clLoadMutex.Release();
+            }
+        } break;
+        case LoadProfile::Timers: {
+            for (auto& clTimer : aclLoadTimers) {
+                clTimer.Init();
+                clTimer.Start(true, 1, LoadTimer_Callback, nullptr);
+            }
+            while (1) { u32LoadSpin++; }
+        } break;
+        default: break;
+    }
+}
+
+//---------------------------------------------------------------------------
+void PrintWait(Driver* pclDriver_, const char* szData_)
+{
+    auto u16Size    = MemUtil::StringLength(szData_);
+    auto u16Written = uint16_t { 0 };
+
+    while (u16Written < u16Size) {
+        u16Written += pclDriver_->Write(&szData_[u16Written], (u16Size - u16Written));
+        if (u16Written != u16Size) {
+            Thread::Sleep(5);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+void PrintValue(Driver* pclDriver_, const char* szName_, uint32_t u32Value_)
+{
+    char szBuf[12];
+    MemUtil::DecimalToString(u32Value_, szBuf);
+    PrintWait(pclDriver_, " ");
+    PrintWait(pclDriver_, szName_);
+    PrintWait(pclDriver_, "=");
+    PrintWait(pclDriver_, szBuf);
+}
+
+//---------------------------------------------------------------------------
+void PrintResults(Driver* pclDriver_, WakeSource eSource_, LoadProfile eLoad_)
+{
+    auto* szSource = aszSourceNames[static_cast<uint8_t>(eSource_)];
+    auto* szLoad   = aszLoadNames[static_cast<uint8_t>(eLoad_)];
+
+    PrintWait(pclDriver_, "LAT ");
+    PrintWait(pclDriver_, szSource);
+    PrintWait(pclDriver_, " ");
+    PrintWait(pclDriver_, szLoad);
+    PrintValue(pclDriver_, "n", clHistogram.GetCount());
+    PrintValue(pclDriver_, "min", clHistogram.GetMin());
+    PrintValue(pclDriver_, "mean", clHistogram.GetMean());
+    PrintValue(pclDriver_, "max", clHistogram.GetMax());
+    PrintValue(pclDriver_, "jitter", clHistogram.GetMax() - clHistogram.GetMin());
+    PrintValue(pclDriver_, "sd", clHistogram.GetStdDev());
+    PrintValue(pclDriver_, "p50", clHistogram.GetPercentile(500));
+    PrintValue(pclDriver_, "p99", clHistogram.GetPercentile(990));
+    PrintValue(pclDriver_, "p999", clHistogram.GetPercentile(999));
+    PrintWait(pclDriver_, "\n");
+
+    // One line per non-empty bin: lower edge (cycles) and sample count
+    for (uint8_t i = 0; i < HISTOGRAM_BINS; i++) {
+        if (0 != clHistogram.GetBin(i)) {
+            PrintWait(pclDriver_, "HIST ");
+            PrintWait(pclDriver_, szSource);
+            PrintWait(pclDriver_, " ");
+            PrintWait(pclDriver_, szLoad);
+            PrintValue(pclDriver_, "bin", i * HISTOGRAM_BIN_WIDTH);
+            PrintValue(pclDriver_, "count", clHistogram.GetBin(i));
+            PrintWait(pclDriver_, "\n");
+        }
+    }
+    if (0 != clHistogram.GetOverflow()) {
+        PrintWait(pclDriver_, "HIST ");
+        PrintWait(pclDriver_, szSource);
+        PrintWait(pclDriver_, " ");
+        PrintWait(pclDriver_, szLoad);
+        PrintValue(pclDriver_, "bin", HISTOGRAM_BINS * HISTOGRAM_BIN_WIDTH);
+        PrintValue(pclDriver_, "count", clHistogram.GetOverflow());
+        PrintWait(pclDriver_, " overflow\n");
+    }
+}
+
+//---------------------------------------------------------------------------
+void Latency_Run(WakeSource eSource_, LoadProfile eLoad_)
+{
+    clSem.Init(0, 1);
+    clNotify.Init();
+    clEventFlag.Init();
+    clDoneSem.Init(0, 1);
+    clLoadSem.Init(0, 1);
+    clLoadMutex.Init();
+    clHistogram.Init();
+    eSource = eSource_;
+
+    // The woken thread outranks everything but the kernel timer thread; the
+    // load runs below this thread, which is blocked for the whole run.
+    clWakeThread.Init(awWakeStack, sizeof(awWakeStack), KERNEL_TIMERS_THREAD_PRIORITY - 1, WakeMain, nullptr);
+    clWakeThread.Start();
+    if (LoadProfile::Idle != eLoad_) {
+        clLoadThread.Init(awLoadStack, sizeof(awLoadStack), 1, LoadMain, reinterpret_cast<void*>(static_cast<K_ADDR>(eLoad_)));
+        clLoadThread.Start();
+    }
+
+    Interrupt_Enable(true);
+    clDoneSem.Pend();
+    Interrupt_Enable(false);
+
+    if (LoadProfile::Idle != eLoad_) {
+        clLoadThread.Exit();
+        if (LoadProfile::Timers == eLoad_) {
+            for (auto& clTimer : aclLoadTimers) { clTimer.Stop(); }
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+void AppMain(void* /*unused*/)
+{
+    UnitTestSupport::OnStart();
+    auto* pclUART = DriverList::FindByPath("/dev/tty");
+
+    PrintWait(pclUART, "START\n");
+    Interrupt_Init();
+    for (uint8_t i = 0; i < static_cast<uint8_t>(WakeSource::Count); i++) {
+        for (uint8_t j = 0; j < static_cast<uint8_t>(LoadProfile::Count); j++) {
+            Latency_Run(static_cast<WakeSource>(i), static_cast<LoadProfile>(j));
+            PrintResults(pclUART, static_cast<WakeSource>(i), static_cast<LoadProfile>(j));
+        }
+    }
+    PrintWait(pclUART, "DONE\n");
+    Thread::Sleep(1000);
+
+    typedef void (*myFunc)(void);
+    myFunc reboot = 0;
+    reboot();
+}
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+int main(void)
+{
+    Kernel::Init();
+
+    clMainThread.Init(awMainStack, sizeof(awMainStack), 2, AppMain, nullptr);
+    clIdleThread.Init(awIdleStack, sizeof(awIdleStack), 0, IdleMain, nullptr);
+
+    clMainThread.Start();
+    clIdleThread.Start();
+
+    UnitTestSupport::OnInit();
+
+    Kernel::Start();
+    return 0;
+}
@@ -0,0 +1,83 @@
+# Compare kernel benchmark results against a baseline.
+#
+# Usage:
+#   cmake -DBASELINE=<baseline.json> -DRESULTS=<results.json> [-DTHRESHOLD=<percent>] -P compare.cmake
+#
+# The results must come from a build with the same configuration (cost model,
+# virtual time, cost table) as the baseline, and every scenario in the
+# baseline must be present in the results.  A scenario regresses if its median
+# or p99 exceeds the baseline by more than THRESHOLD percent; any regression
+# fails the script.  A baseline of zero can't detect a regression, so it is
+# rejected too.
+
+if(NOT DEFINED BASELINE OR NOT DEFINED RESULTS)
+    message(FATAL_ERROR "compare.cmake requires -DBASELINE=<file> and -DRESULTS=<file>")
+endif()
+if(NOT DEFINED THRESHOLD)
+    set(THRESHOLD 10)
+endif()
+
+file(READ "${BASELINE}" baseline_json)
+file(READ "${RESULTS}" results_json)
+
+string(JSON baseline_unit GET "${baseline_json}" unit)
+string(JSON results_unit GET "${results_json}" unit)
+if(NOT "${baseline_unit}" STREQUAL "${results_unit}")
+    message(FATAL_ERROR "Baseline is in ${baseline_unit}, results are in ${results_unit}")
+endif()
+
+foreach(key cost_model virtual_time target)
+    string(JSON baseline_value ERROR_VARIABLE baseline_error GET "${baseline_json}" config ${key})
+    if(baseline_error)
+        message(FATAL_ERROR "Baseline ${BASELINE} does not record config.${key}; re-record it with the current kernel_benchmark")
+    endif()
+    string(JSON results_value ERROR_VARIABLE results_error GET "${results_json}" config ${key})
+    if(results_error OR NOT "${baseline_value}" STREQUAL "${results_value}")
+        message(FATAL_ERROR "Baseline was recorded with config.${key} = ${baseline_value}, results have ${results_value}; "
+                            "rebuild with the baseline's configuration or point MARK3_BENCHMARK_BASELINE at a matching baseline")
+    endif()
+endforeach()
+
+# Index the results by scenario name
+string(JSON results_count LENGTH "${results_json}" results)
+math(EXPR results_last "${results_count} - 1")
+foreach(i RANGE ${results_last})
+    string(JSON name GET "${results_json}" results ${i} name)
+    set(result_index_${name} ${i})
+endforeach()
+
+set(regressions 0)
+string(JSON baseline_count LENGTH "${baseline_json}" results)
+math(EXPR baseline_last "${baseline_count} - 1")
+foreach(i RANGE ${baseline_last})
+    string(JSON name GET "${baseline_json}" results ${i} name)
+    if(NOT DEFINED result_index_${name})
+        message(SEND_ERROR "${name}: missing from results")
+        math(EXPR regressions "${regressions} + 1")
+        continue()
+    endif()
+
+    foreach(metric median p99)
+        string(JSON old GET "${baseline_json}" results ${i} ${metric})
+        string(JSON new GET "${results_json}" results ${result_index_${name}} ${metric})
+        if(${old} EQUAL 0)
+            message(SEND_ERROR "${name}: baseline ${metric} is 0 ${results_unit}, which can't detect a regression")
+            math(EXPR regressions "${regressions} + 1")
+            continue()
+        endif()
+
+        # new > old * (100 + THRESHOLD) / 100, in integer arithmetic
+        math(EXPR limit "(${old} * (100 + ${THRESHOLD})) / 100")
+        if(${new} GREATER ${limit})
+            message(SEND_ERROR "${name}: ${metric} regressed from ${old} to ${new} ${results_unit} (limit ${limit})")
+            math(EXPR regressions "${regressions} + 1")
+        elseif(${new} LESS ${old})
+            message(STATUS "${name}: ${metric} improved from ${old} to ${new} ${results_unit}")
+        endif()
+    endforeach()
+endforeach()
+
+if(${regressions} GREATER 0)
+    message(FATAL_ERROR "${regressions} kernel benchmark regression(s) beyond ${THRESHOLD}%")
+endif()
+message(STATUS "Kernel benchmark: no regressions beyond ${THRESHOLD}% against ${BASELINE}")
@@ -0,0 +1,491 @@
+#include "mark3.h"
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+
+using namespace Mark3;
+
+namespace
+{
+//---------------------------------------------------------------------------
+// Kernel benchmark suite.  Each scenario collects a fixed number of samples,
+// and the median, 99th percentile, and maximum are reported as JSON on
+// stdout, for comparison against a saved baseline (see compare.cmake).
+//
+// With KERNEL_COST_MODEL enabled, samples are estimated target cycles, and
+// the medians and 99th percentiles are reproducible from run to run (a
+// maximum may include a timer tick, which isn't).  Otherwise, samples are
+// host nanoseconds.  The build configuration is reported alongside the
+// results, so a baseline is only ever compared against a matching build.
+//---------------------------------------------------------------------------
+#define SAMPLES (1000)
+#define FANOUT_WAITERS (8)
+#define TIMER_CHURN_BACKGROUND (32)
+#define PI_CHAIN_DEPTH (4)
+#define MAILBOX_MESSAGE_SIZE (16)
+#define MESSAGE_POOL_SIZE (8)
+
+//---------------------------------------------------------------------------
+#if KERNEL_COST_MODEL
+const char* const szUnit = "cycles";
+const char* Benchmark_Target()
+{
+    return CostModel::GetTarget()->szName;
+}
+uint32_t Benchmark_Now()
+{
+    return static_cast<uint32_t>(CostModel::GetCycles());
+}
+#else
+const char* const szUnit = "ns";
+const char* Benchmark_Target()
+{
+    return "host";
+}
+uint32_t Benchmark_Now()
+{
+    auto stTime = timespec {};
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return static_cast<uint32_t>((static_cast<uint64_t>(stTime.tv_sec) * 1000000000ULL) + stTime.tv_nsec);
+}
+#endif // #if KERNEL_COST_MODEL
+
+//---------------------------------------------------------------------------
+/**
+ * Fixed-size sample set for a single benchmark scenario
+ */
+class Samples
+{
+public:
+    void Init(const char* szName_)
+    {
+        m_szName     = szName_;
+        m_u16Samples = 0;
+    }
+    void Start() { m_u32Start = Benchmark_Now(); }
+    void Stop() { Add(Benchmark_Now() - m_u32Start); }
+    void Add(uint32_t u32Sample_)
+    {
+        if (m_u16Samples < SAMPLES) {
+            m_au32Samples[m_u16Samples++] = u32Sample_;
+        }
+    }
+    void Report(bool bLast_)
+    {
+        std::sort(m_au32Samples, m_au32Samples + m_u16Samples);
+        printf("    {\"name\": \"%s\", \"samples\": %u, \"median\": %u, \"p99\": %u, \"max\": %u}%s\n",
+               m_szName,
+               m_u16Samples,
+               Percentile(50),
+               Percentile(99),
+               m_u16Samples ? m_au32Samples[m_u16Samples - 1] : 0,
+               bLast_ ? "" : ",");
+    }
+
+private:
+    uint32_t Percentile(uint16_t u16Percent_)
+    {
+        if (0 == m_u16Samples) {
+            return 0;
+        }
+        auto u32Index = (static_cast<uint32_t>(m_u16Samples) * u16Percent_) / 100;
+        if (u32Index >= m_u16Samples) {
+            u32Index = m_u16Samples - 1;
+        }
+        return m_au32Samples[u32Index];
+    }
+
+    const char* m_szName;
+    uint16_t    m_u16Samples;
+    uint32_t    m_u32Start;
+    uint32_t    m_au32Samples[SAMPLES];
+};
+
+//---------------------------------------------------------------------------
+enum class Scenario : uint8_t {
+    SemaphoreInit,
+    SemaphorePost,
+    SemaphorePend,
+    SemaphoreFlyback,
+    MutexInit,
+    MutexClaim,
+    MutexRelease,
+    ThreadInit,
+    ThreadStart,
+    ThreadExit,
+    SchedulerSchedule,
+    MailboxThroughput,
+    MessageQueueThroughput,
+    EventFlagFanout,
+    TimerChurn,
+    PriorityInheritanceChain,
+    //---
+    Count
+};
+
+Samples aclSamples[static_cast<uint8_t>(Scenario::Count)];
+
+Samples& GetSamples(Scenario eScenario_)
+{
+    return aclSamples[static_cast<uint8_t>(eScenario_)];
+}
+
+//---------------------------------------------------------------------------
+Thread clMainThread;
+Thread clIdleThread;
+Thread clTestThread1;
+Thread aclWorkerThreads[FANOUT_WAITERS];
+
+K_WORD awMainStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD awIdleStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD awTestStack1[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD aawWorkerStacks[FANOUT_WAITERS][PORT_KERNEL_DEFAULT_STACK_SIZE];
+
+//---------------------------------------------------------------------------
+Semaphore clSem;
+Semaphore clDoneSem;
+Semaphore clGateSem;
+
+//---------------------------------------------------------------------------
+void IdleMain(void* /*unused*/)
+{
+    while (1) {}
+}
+
+//---------------------------------------------------------------------------
+void Semaphore_FlybackThread(void* /*unused*/)
+{
+    clSem.Pend();
+    GetSamples(Scenario::SemaphoreFlyback).Stop();
+    Scheduler::GetCurrentThread()->Exit();
+}
+
+//---------------------------------------------------------------------------
+void Semaphore_Benchmark()
+{
+    auto clLocal = Semaphore {};
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        GetSamples(Scenario::SemaphoreInit).Start();
+        clLocal.Init(0, SAMPLES);
+        GetSamples(Scenario::SemaphoreInit).Stop();
+    }
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        GetSamples(Scenario::SemaphorePost).Start();
+        clLocal.Post();
+        GetSamples(Scenario::SemaphorePost).Stop();
+    }
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        GetSamples(Scenario::SemaphorePend).Start();
+        clLocal.Pend();
+        GetSamples(Scenario::SemaphorePend).Stop();
+    }
+
+    // Time from posting a semaphore to a higher-priority waiter running
+    clSem.Init(0, 1);
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        clTestThread1.Init(awTestStack1, sizeof(awTestStack1), 3, Semaphore_FlybackThread, nullptr);
+        clTestThread1.Start();
+        GetSamples(Scenario::SemaphoreFlyback).Start();
+        clSem.Post();
+    }
+}
+
+//---------------------------------------------------------------------------
+void Mutex_Benchmark()
+{
+    auto clLocal = Mutex {};
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        GetSamples(Scenario::MutexInit).Start();
+        clLocal.Init();
+        GetSamples(Scenario::MutexInit).Stop();
+    }
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        GetSamples(Scenario::MutexClaim).Start();
+        clLocal.Claim();
+        GetSamples(Scenario::MutexClaim).Stop();
+
+        GetSamples(Scenario::MutexRelease).Start();
+        clLocal.Release();
+        GetSamples(Scenario::MutexRelease).Stop();
+    }
+}
+
+//---------------------------------------------------------------------------
+void Thread_BenchmarkThread(void* /*unused*/)
+{
+    GetSamples(Scenario::ThreadStart).Stop();
+    GetSamples(Scenario::ThreadExit).Start();
+    Scheduler::GetCurrentThread()->Exit();
+}
+
+//---------------------------------------------------------------------------
+void Thread_Benchmark()
+{
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        GetSamples(Scenario::ThreadInit).Start();
+        clTestThread1.Init(awTestStack1, sizeof(awTestStack1), 3, Thread_BenchmarkThread, nullptr);
+        GetSamples(Scenario::ThreadInit).Stop();
+
+        // Start -> running in the new thread, then exit -> back in this thread
+        GetSamples(Scenario::ThreadStart).Start();
+        clTestThread1.Start();
+        GetSamples(Scenario::ThreadExit).Stop();
+    }
+
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        const auto cs = CriticalGuard{};
+        GetSamples(Scenario::SchedulerSchedule).Start();
+        Scheduler::Schedule();
+        GetSamples(Scenario::SchedulerSchedule).Stop();
+    }
+}
+
+//---------------------------------------------------------------------------
+Mailbox clMailbox;
+uint8_t au8MailboxBuffer[MAILBOX_MESSAGE_SIZE * 4];
+
+void Mailbox_ReceiverThread(void* /*unused*/)
+{
+    uint8_t au8Message[MAILBOX_MESSAGE_SIZE];
+    while (1) {
+        clMailbox.Receive(au8Message);
+        GetSamples(Scenario::MailboxThroughput).Stop();
+    }
+}
+
+//---------------------------------------------------------------------------
+void Mailbox_Benchmark()
+{
+    uint8_t au8Message[MAILBOX_MESSAGE_SIZE] = {};
+
+    // Each sample is one message handed from sender to a blocked receiver
+    clMailbox.Init(au8MailboxBuffer, sizeof(au8MailboxBuffer), sizeof(au8Message));
+    clTestThread1.Init(awTestStack1, sizeof(awTestStack1), 3, Mailbox_ReceiverThread, nullptr);
+    clTestThread1.Start();
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        GetSamples(Scenario::MailboxThroughput).Start();
+        clMailbox.Send(au8Message);
+    }
+    clTestThread1.Exit();
+}
+
+//---------------------------------------------------------------------------
+MessageQueue clMessageQueue;
+MessagePool  clMessagePool;
+Message      aclMessages[MESSAGE_POOL_SIZE];
+
+void MessageQueue_ReceiverThread(void* /*unused*/)
+{
+    while (1) {
+        auto* pclMessage = clMessageQueue.Receive();
+        GetSamples(Scenario::MessageQueueThroughput).Stop();
+        clMessagePool.Push(pclMessage);
+    }
+}
+
+//---------------------------------------------------------------------------
+void MessageQueue_Benchmark()
+{
+    clMessageQueue.Init();
+    clMessagePool.Init();
+    for (auto& clMessage : aclMessages) {
+        clMessage.Init();
+        clMessagePool.Push(&clMessage);
+    }
+
+    // Each sample covers allocating, sending, and receiving one message
+    clTestThread1.Init(awTestStack1, sizeof(awTestStack1), 3, MessageQueue_ReceiverThread, nullptr);
+    clTestThread1.Start();
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        GetSamples(Scenario::MessageQueueThroughput).Start();
+        auto* pclMessage = clMessagePool.Pop();
+        pclMessage->SetCode(i);
+        clMessageQueue.Send(pclMessage);
+    }
+    clTestThread1.Exit();
+}
+
+//---------------------------------------------------------------------------
+EventFlag clEventFlag;
+
+void EventFlag_WaiterThread(void* /*unused*/)
+{
+    while (1) {
+        clEventFlag.Wait(0x0001, EventFlagOperation::Any_Set);
+        clDoneSem.Post();
+        clGateSem.Pend();
+    }
+}
+
+//---------------------------------------------------------------------------
+void EventFlag_Benchmark()
+{
+    clEventFlag.Init();
+    clDoneSem.Init(0, FANOUT_WAITERS);
+    clGateSem.Init(0, FANOUT_WAITERS);
+    for (uint8_t i = 0; i < FANOUT_WAITERS; i++) {
+        aclWorkerThreads[i].Init(aawWorkerStacks[i], sizeof(aawWorkerStacks[i]), 3, EventFlag_WaiterThread, nullptr);
+        aclWorkerThreads[i].Start();
+    }
+
+    // Each sample is the time taken to wake every waiter and have them all run
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        GetSamples(Scenario::EventFlagFanout).Start();
+        clEventFlag.Set(0x0001);
+        for (uint8_t j = 0; j < FANOUT_WAITERS; j++) { clDoneSem.Pend(); }
+        GetSamples(Scenario::EventFlagFanout).Stop();
+
+        clEventFlag.Clear(0x0001);
+        for (uint8_t j = 0; j < FANOUT_WAITERS; j++) { clGateSem.Post(); }
+    }
+
+    for (auto& clThread : aclWorkerThreads) { clThread.Exit(); }
+}
+
+//---------------------------------------------------------------------------
+Timer aclBackgroundTimers[TIMER_CHURN_BACKGROUND];
+
+void Timer_Callback(Thread* /*pclOwner_*/, void* /*pvData_*/) {}
+
+//---------------------------------------------------------------------------
+void Timer_Benchmark()
+{
+    // Start/stop a timer while other timers are active
+    for (uint8_t i = 0; i < TIMER_CHURN_BACKGROUND; i++) {
+        aclBackgroundTimers[i].Init();
+        aclBackgroundTimers[i].Start(true, 1000 + i, Timer_Callback, nullptr);
+    }
+
+    auto clTimer = Timer {};
+    clTimer.Init();
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        GetSamples(Scenario::TimerChurn).Start();
+        clTimer.Start(false, 10, Timer_Callback, nullptr);
+        clTimer.Stop();
+        GetSamples(Scenario::TimerChurn).Stop();
+    }
+
+    for (auto& clBackground : aclBackgroundTimers) { clBackground.Stop(); }
+}
+
+//---------------------------------------------------------------------------
+Mutex aclChainMutex[PI_CHAIN_DEPTH];
+
+void PriorityInheritance_ChainThread(void* pvArg_)
+{
+    auto uIndex = reinterpret_cast<K_ADDR>(pvArg_);
+
+    // Hold our own mutex, then block on the next link in the chain; the end
+    // of the chain waits for the benchmark to open the gate.
+    aclChainMutex[uIndex].Claim();
+    clDoneSem.Post();
+    if (0 == uIndex) {
+        clGateSem.Pend();
+    } else {
+        aclChainMutex[uIndex - 1].Claim();
+        aclChainMutex[uIndex - 1].Release();
+    }
+    aclChainMutex[uIndex].Release();
+    clDoneSem.Post();
+    Scheduler::GetCurrentThread()->Exit();
+}
+
+//---------------------------------------------------------------------------
+void PriorityInheritance_Benchmark()
+{
+    for (auto& clMutex : aclChainMutex) { clMutex.Init(); }
+    clDoneSem.Init(0, PI_CHAIN_DEPTH);
+    clGateSem.Init(0, 1);
+
+    // Each sample is the time for a high-priority thread to claim a mutex at
+    // the end of a chain of low-priority owners, each blocked on the next.
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        for (K_ADDR j = 0; j < PI_CHAIN_DEPTH; j++) {
+            aclWorkerThreads[j].Init(aawWorkerStacks[j],
+                                     sizeof(aawWorkerStacks[j]),
+                                     1,
+                                     PriorityInheritance_ChainThread,
+                                     reinterpret_cast<void*>(j));
+            aclWorkerThreads[j].Start();
+            clDoneSem.Pend();
+        }
+
+        clGateSem.Post();
+        GetSamples(Scenario::PriorityInheritanceChain).Start();
+        aclChainMutex[PI_CHAIN_DEPTH - 1].Claim();
+        GetSamples(Scenario::PriorityInheritanceChain).Stop();
+        aclChainMutex[PI_CHAIN_DEPTH - 1].Release();
+
+        for (uint8_t j = 0; j < PI_CHAIN_DEPTH; j++) { clDoneSem.Pend(); }
+    }
+}
+
+//---------------------------------------------------------------------------
+void Benchmark_Report()
+{
+    printf("{\n");
+    printf("  \"suite\": \"mark3-kernel\",\n");
+    printf("  \"unit\": \"%s\",\n", szUnit);
+    printf("  \"config\": {\"cost_model\": %d, \"virtual_time\": %d, \"target\": \"%s\"},\n",
+           KERNEL_COST_MODEL,
+           PORT_HOST_VIRTUAL_TIME,
+           Benchmark_Target());
+    printf("  \"results\": [\n");
+    for (uint8_t i = 0; i < static_cast<uint8_t>(Scenario::Count); i++) {
+        aclSamples[i].Report((i + 1) == static_cast<uint8_t>(Scenario::Count));
+    }
+    printf("  ]\n");
+    printf("}\n");
+}
+
+//---------------------------------------------------------------------------
+void AppMain(void* /*unused*/)
+{
+    GetSamples(Scenario::SemaphoreInit).Init("semaphore_init");
+    GetSamples(Scenario::SemaphorePost).Init("semaphore_post");
+    GetSamples(Scenario::SemaphorePend).Init("semaphore_pend");
+    GetSamples(Scenario::SemaphoreFlyback).Init("semaphore_flyback");
+    GetSamples(Scenario::MutexInit).Init("mutex_init");
+    GetSamples(Scenario::MutexClaim).Init("mutex_claim");
+    GetSamples(Scenario::MutexRelease).Init("mutex_release");
+    GetSamples(Scenario::ThreadInit).Init("thread_init");
+    GetSamples(Scenario::ThreadStart).Init("thread_start");
+    GetSamples(Scenario::ThreadExit).Init("thread_exit");
+    GetSamples(Scenario::SchedulerSchedule).Init("scheduler_schedule");
+    GetSamples(Scenario::MailboxThroughput).Init("mailbox_throughput");
+    GetSamples(Scenario::MessageQueueThroughput).Init("message_queue_throughput");
+    GetSamples(Scenario::EventFlagFanout).Init("event_flag_fanout");
+    GetSamples(Scenario::TimerChurn).Init("timer_churn");
+    GetSamples(Scenario::PriorityInheritanceChain).Init("priority_inheritance_chain");
+
+    Semaphore_Benchmark();
+    Mutex_Benchmark();
+    Thread_Benchmark();
+    Mailbox_Benchmark();
+    MessageQueue_Benchmark();
+    EventFlag_Benchmark();
+    Timer_Benchmark();
+    PriorityInheritance_Benchmark();
+
+    Benchmark_Report();
+    fflush(stdout);
+    _exit(0);
+}
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+int main(void)
+{
+    Kernel::Init();
+
+    clMainThread.Init(awMainStack, sizeof(awMainStack), 2, AppMain, nullptr);
+    clIdleThread.Init(awIdleStack, sizeof(awIdleStack), 0, IdleMain, nullptr);
+
+    clMainThread.Start();
+    clIdleThread.Start();
+
+    Kernel::Start();
+    return 0;
+}
@@ -0,0 +1,170 @@
+#include "mark3.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#if !KERNEL_MULTI_INSTANCE
+#error "kernel_instances requires KERNEL_MULTI_INSTANCE"
+#endif
+
+using namespace Mark3;
+
+namespace
+{
+//---------------------------------------------------------------------------
+// Run two kernel instances side by side, each on its own host thread.  Each
+// instance ping-pongs a pair of threads through two semaphores, retires the
+// pong thread, then sleeps for a different number of ticks, and shuts itself
+// down with ThreadPort_ExitKernel(), returning its host thread from
+// Kernel::Start().  The instances are started again for a second round, on
+// new host threads and with the same objects, to check that nothing is left
+// linked into the previous instance.
+//---------------------------------------------------------------------------
+#define INSTANCES (2)
+#define ROUNDS (2)
+#define ITERATIONS (10000)
+#define SLEEP_TICKS (20)
+
+struct Instance {
+    Thread clPingThread;
+    Thread clPongThread;
+    Thread clIdleThread;
+
+    K_WORD awPingStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+    K_WORD awPongStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+    K_WORD awIdleStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+
+    Semaphore clPingSem;
+    Semaphore clPongSem;
+
+    uint32_t u32Sleep;
+    uint32_t u32Pongs;
+    uint32_t u32Slept;
+    bool     bDone;
+    bool     bExited;
+};
+
+Instance astInstances[INSTANCES];
+
+// The instance running on the calling host thread
+thread_local Instance* pstCurrent;
+
+//---------------------------------------------------------------------------
+void PanicHandler(uint16_t u16Cause_)
+{
+    printf("FAIL: kernel panic %u\n", u16Cause_);
+    fflush(stdout);
+    _exit(1);
+}
+
+//---------------------------------------------------------------------------
+void IdleMain(void* /*unused*/)
+{
+    while (1) {}
+}
+
+//---------------------------------------------------------------------------
+void PongMain(void* pvArg_)
+{
+    auto* pstInstance = static_cast<Instance*>(pvArg_);
+    while (1) {
+        pstInstance->clPingSem.Pend();
+        if (pstInstance->bDone) {
+            break;
+        }
+        pstInstance->u32Pongs++;
+        pstInstance->clPongSem.Post();
+    }
+    Scheduler::GetCurrentThread()->Exit();
+}
+
+//---------------------------------------------------------------------------
+void PingMain(void* pvArg_)
+{
+    auto* pstInstance = static_cast<Instance*>(pvArg_);
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        pstInstance->clPingSem.Post();
+        pstInstance->clPongSem.Pend();
+    }
+    pstInstance->bDone = true;
+    pstInstance->clPingSem.Post();
+
+    auto u32Start = Kernel::GetTicks();
+    Thread::Sleep(pstInstance->u32Sleep);
+    pstInstance->u32Slept = Kernel::GetTicks() - u32Start;
+
+    ThreadPort_ExitKernel();
+}
+
+//---------------------------------------------------------------------------
+void* InstanceMain(void* pvArg_)
+{
+    auto* pstInstance = static_cast<Instance*>(pvArg_);
+    pstCurrent        = pstInstance;
+
+    Kernel::Init();
+    Kernel::SetPanic(PanicHandler);
+
+    pstInstance->clPingSem.Init(0, 1);
+    pstInstance->clPongSem.Init(0, 1);
+
+    pstInstance->clPingThread.Init(
+        pstInstance->awPingStack, sizeof(pstInstance->awPingStack), 2, PingMain, pstInstance);
+    pstInstance->clPongThread.Init(
+        pstInstance->awPongStack, sizeof(pstInstance->awPongStack), 3, PongMain, pstInstance);
+    pstInstance->clIdleThread.Init(
+        pstInstance->awIdleStack, sizeof(pstInstance->awIdleStack), 0, IdleMain, nullptr);
+
+    pstInstance->clPingThread.Start();
+    pstInstance->clPongThread.Start();
+    pstInstance->clIdleThread.Start();
+
+    Kernel::Start();
+
+    // Only reached once the instance has called ThreadPort_ExitKernel()
+    pstInstance->bExited = (pstCurrent == pstInstance);
+    return nullptr;
+}
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+int main(void)
+{
+    auto bPass = true;
+    for (uint8_t u8Round = 0; u8Round < ROUNDS; u8Round++) {
+        pthread_t astHostThreads[INSTANCES];
+        for (uint8_t i = 0; i < INSTANCES; i++) {
+            auto* pstInstance     = &astInstances[i];
+            pstInstance->u32Sleep = SLEEP_TICKS * (i + 1);
+            pstInstance->u32Pongs = 0;
+            pstInstance->u32Slept = 0;
+            pstInstance->bDone    = false;
+            pstInstance->bExited  = false;
+            pthread_create(&astHostThreads[i], nullptr, InstanceMain, pstInstance);
+        }
+
+        for (uint8_t i = 0; i < INSTANCES; i++) {
+            pthread_join(astHostThreads[i], nullptr);
+
+            auto* pstInstance = &astInstances[i];
+            auto  bOk         = pstInstance->bExited && (ITERATIONS == pstInstance->u32Pongs)
+                       && (pstInstance->u32Slept >= pstInstance->u32Sleep);
+            printf("round %u, instance %u: %u pongs, slept %u/%u ticks, %s\n",
+                   u8Round,
+                   i,
+                   static_cast<unsigned>(pstInstance->u32Pongs),
+                   static_cast<unsigned>(pstInstance->u32Slept),
+                   static_cast<unsigned>(pstInstance->u32Sleep),
+                   bOk ? "ok" : "FAIL");
+            bPass = bPass && bOk;
+        }
+    }
+
+    printf("%s\n", bPass ? "PASS" : "FAIL");
+    fflush(stdout);
+
+    // The instances' threads are abandoned in place, not destroyed; see
+    // ThreadPort_ExitKernel().
+    _exit(bPass ? 0 : 1);
+}
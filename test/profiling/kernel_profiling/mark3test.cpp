@@ -306,7 +306,6 @@ void ProfilePrint(ProfileTimer* pclProfile, const char* szName_)
     Driver*  pclUART = DriverList::FindByPath("/dev/tty");
     char     szBuf[16];
     uint32_t u32Val = pclProfile->GetAverage() - clProfileOverhead.GetAverage();
-    u32Val *= 8;
     for (int i = 0; i < 16; i++) { szBuf[i] = 0; }
     szBuf[0] = '0';
 
@@ -0,0 +1,241 @@
+#include "mark3.h"
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+
+using namespace Mark3;
+
+namespace
+{
+//---------------------------------------------------------------------------
+// Kernel scalability stress test.  Sweeps the number of active timers and
+// the number of threads blocked on a single object from 10 to 10,000, and
+// reports the median, 99th percentile, and maximum cost of each operation at
+// every point as JSON, giving a cost curve for each path that is linear in
+// object count:
+//
+//  - timer_process: one tick of TimerScheduler::Process() with N active timers
+//  - timer_start_stop: starting and stopping a timer with N active timers
+//  - semaphore_block: blocking the lowest-priority waiter on a semaphore with
+//    N waiters (ThreadList::AddPriority walks the whole block list)
+//  - event_flag_set: setting a flag that none of N waiters is waiting on
+//
+// Samples are in host nanoseconds.
+//---------------------------------------------------------------------------
+#define SAMPLES (100)
+#define MAX_OBJECTS (10000)
+
+const uint16_t au16Counts[] = { 10, 100, 1000, 10000 };
+
+//---------------------------------------------------------------------------
+uint32_t Stress_Now()
+{
+    auto stTime = timespec {};
+    clock_gettime(CLOCK_MONOTONIC, &stTime);
+    return static_cast<uint32_t>((static_cast<uint64_t>(stTime.tv_sec) * 1000000000ULL) + stTime.tv_nsec);
+}
+
+//---------------------------------------------------------------------------
+/**
+ * Sample set for a single operation at a single object count
+ */
+class Samples
+{
+public:
+    void Init()
+    {
+        m_u16Samples = 0;
+    }
+    void Start() { m_u32Start = Stress_Now(); }
+    void Stop()
+    {
+        if (m_u16Samples < SAMPLES) {
+            m_au32Samples[m_u16Samples++] = Stress_Now() - m_u32Start;
+        }
+    }
+    void Report(const char* szName_, uint16_t u16Count_, bool bLast_)
+    {
+        std::sort(m_au32Samples, m_au32Samples + m_u16Samples);
+        printf("    {\"name\": \"%s\", \"count\": %u, \"samples\": %u, \"median\": %u, \"p99\": %u, \"max\": %u}%s\n",
+               szName_,
+               u16Count_,
+               m_u16Samples,
+               m_u16Samples ? m_au32Samples[m_u16Samples / 2] : 0,
+               m_u16Samples ? m_au32Samples[(m_u16Samples * 99) / 100] : 0,
+               m_u16Samples ? m_au32Samples[m_u16Samples - 1] : 0,
+               bLast_ ? "" : ",");
+    }
+
+private:
+    uint16_t m_u16Samples;
+    uint32_t m_u32Start;
+    uint32_t m_au32Samples[SAMPLES];
+};
+
+Samples clSamples;
+
+//---------------------------------------------------------------------------
+Thread clMainThread;
+Thread clIdleThread;
+Thread clStampThread;
+Thread aclWaiterThreads[MAX_OBJECTS];
+
+K_WORD awMainStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD awIdleStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD awStampStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD aawWaiterStacks[MAX_OBJECTS][PORT_KERNEL_DEFAULT_STACK_SIZE / sizeof(K_WORD)];
+
+Timer aclTimers[MAX_OBJECTS];
+
+Semaphore clSem;
+Semaphore clStampSem;
+EventFlag clEventFlag;
+
+//---------------------------------------------------------------------------
+void IdleMain(void* /*unused*/)
+{
+    while (1) {}
+}
+
+//---------------------------------------------------------------------------
+void Timer_Callback(Thread* /*pclOwner_*/, void* /*pvData_*/) {}
+
+//---------------------------------------------------------------------------
+void Timer_Stress(uint16_t u16Count_, bool bLast_)
+{
+    // Timers are set to expire far beyond the end of the test
+    for (uint16_t i = 0; i < u16Count_; i++) {
+        aclTimers[i].Init();
+        aclTimers[i].Start(true, 1000000, Timer_Callback, nullptr);
+    }
+
+    clSamples.Init();
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        clSamples.Start();
+        TimerScheduler::Process(1);
+        clSamples.Stop();
+    }
+    clSamples.Report("timer_process", u16Count_, false);
+
+    auto clTimer = Timer {};
+    clTimer.Init();
+    clSamples.Init();
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        clSamples.Start();
+        clTimer.Start(false, 1000000, Timer_Callback, nullptr);
+        clTimer.Stop();
+        clSamples.Stop();
+    }
+    clSamples.Report("timer_start_stop", u16Count_, bLast_);
+
+    for (uint16_t i = 0; i < u16Count_; i++) { aclTimers[i].Stop(); }
+}
+
+//---------------------------------------------------------------------------
+void Semaphore_WaiterThread(void* /*unused*/)
+{
+    clSem.Pend();
+}
+
+//---------------------------------------------------------------------------
+void Semaphore_StampThread(void* /*unused*/)
+{
+    // Lowest-priority thread, which runs as soon as the main thread blocks
+    while (1) {
+        clStampSem.Pend();
+        clSamples.Stop();
+    }
+}
+
+//---------------------------------------------------------------------------
+void EventFlag_WaiterThread(void* /*unused*/)
+{
+    clEventFlag.Wait(0x8000, EventFlagOperation::Any_Set);
+}
+
+//---------------------------------------------------------------------------
+void Waiters_Start(uint16_t u16Count_, ThreadEntryFunc pfEntry_)
+{
+    // Waiters outrank the main thread, so each blocks as soon as it's started
+    for (uint16_t i = 0; i < u16Count_; i++) {
+        aclWaiterThreads[i].Init(aawWaiterStacks[i], sizeof(aawWaiterStacks[i]), 3, pfEntry_, nullptr);
+        aclWaiterThreads[i].Start();
+    }
+}
+
+//---------------------------------------------------------------------------
+void Waiters_Exit(uint16_t u16Count_)
+{
+    for (uint16_t i = 0; i < u16Count_; i++) { aclWaiterThreads[i].Exit(); }
+}
+
+//---------------------------------------------------------------------------
+void Waiter_Stress(uint16_t u16Count_, bool bLast_)
+{
+    // Time from blocking the main thread behind N higher-priority waiters to
+    // the stamp thread running.  The pend times out on the next tick.
+    clSem.Init(0, 1);
+    clStampSem.Init(0, 1);
+    Waiters_Start(u16Count_, Semaphore_WaiterThread);
+    clSamples.Init();
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        clStampSem.Post();
+        clSamples.Start();
+        clSem.Pend(1);
+    }
+    clSamples.Report("semaphore_block", u16Count_, false);
+    Waiters_Exit(u16Count_);
+
+    // Set flags which don't wake any of the N waiters
+    clEventFlag.Init();
+    Waiters_Start(u16Count_, EventFlag_WaiterThread);
+    clSamples.Init();
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        clSamples.Start();
+        clEventFlag.Set(0x0001);
+        clSamples.Stop();
+        clEventFlag.Clear(0x0001);
+    }
+    clSamples.Report("event_flag_set", u16Count_, bLast_);
+    Waiters_Exit(u16Count_);
+}
+
+//---------------------------------------------------------------------------
+void AppMain(void* /*unused*/)
+{
+    clStampThread.Init(awStampStack, sizeof(awStampStack), 1, Semaphore_StampThread, nullptr);
+    clStampThread.Start();
+
+    printf("{\n");
+    printf("  \"suite\": \"mark3-stress\",\n");
+    printf("  \"unit\": \"ns\",\n");
+    printf("  \"results\": [\n");
+    for (auto u16Count : au16Counts) {
+        auto bLast = (u16Count == au16Counts[(sizeof(au16Counts) / sizeof(au16Counts[0])) - 1]);
+        Timer_Stress(u16Count, false);
+        Waiter_Stress(u16Count, bLast);
+    }
+    printf("  ]\n");
+    printf("}\n");
+
+    fflush(stdout);
+    _exit(0);
+}
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+int main(void)
+{
+    Kernel::Init();
+
+    clMainThread.Init(awMainStack, sizeof(awMainStack), 2, AppMain, nullptr);
+    clIdleThread.Init(awIdleStack, sizeof(awIdleStack), 0, IdleMain, nullptr);
+
+    clMainThread.Start();
+    clIdleThread.Start();
+
+    Kernel::Start();
+    return 0;
+}
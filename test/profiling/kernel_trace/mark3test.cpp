@@ -0,0 +1,162 @@
+#include "mark3.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#if !KERNEL_TRACE
+#error "kernel_trace requires KERNEL_TRACE"
+#endif
+
+using namespace Mark3;
+
+namespace
+{
+//---------------------------------------------------------------------------
+// Record a short kernel timeline - a producer/consumer pair passing messages
+// through a mailbox, two threads contending for a mutex, and a periodic
+// timer waking a thread through a semaphore - then dump the trace buffer to
+// kernel_trace.bin (or the file given on the command line).  Convert the
+// dump with tools/trace2json to view the timeline in Perfetto.
+//---------------------------------------------------------------------------
+#define MESSAGES (16)
+
+Thread clMainThread;
+Thread clIdleThread;
+Thread clProducerThread;
+Thread clConsumerThread;
+Thread clContenderThread;
+
+K_WORD awMainStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD awIdleStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD awProducerStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD awConsumerStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD awContenderStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+
+Mailbox   clMailbox;
+uint8_t   au8MailboxBuffer[64];
+Mutex     clMutex;
+Semaphore clTimerSem;
+Semaphore clDoneSem;
+Timer     clTimer;
+
+const char* szPath = "kernel_trace.bin";
+
+//---------------------------------------------------------------------------
+void IdleMain(void* /*unused*/)
+{
+    while (1) {}
+}
+
+//---------------------------------------------------------------------------
+void ProducerMain(void* /*unused*/)
+{
+    for (uint32_t i = 0; i < MESSAGES; i++) {
+        clMailbox.Send(&i);
+        if (0 == (i % 4)) {
+            Thread::Sleep(1);
+        }
+    }
+    clDoneSem.Post();
+    Scheduler::GetCurrentThread()->Exit();
+}
+
+//---------------------------------------------------------------------------
+void ConsumerMain(void* /*unused*/)
+{
+    auto u32Message = uint32_t {};
+    for (uint32_t i = 0; i < MESSAGES; i++) {
+        clMailbox.Receive(&u32Message);
+
+        clMutex.Claim();
+        Thread::Sleep(1);
+        clMutex.Release();
+    }
+    clDoneSem.Post();
+    Scheduler::GetCurrentThread()->Exit();
+}
+
+//---------------------------------------------------------------------------
+void ContenderMain(void* /*unused*/)
+{
+    for (uint32_t i = 0; i < MESSAGES; i++) {
+        clTimerSem.Pend();
+
+        clMutex.Claim();
+        clMutex.Release();
+    }
+    clDoneSem.Post();
+    Scheduler::GetCurrentThread()->Exit();
+}
+
+//---------------------------------------------------------------------------
+void Timer_Callback(Thread* /*pclOwner_*/, void* /*pvData_*/)
+{
+    clTimerSem.Post();
+}
+
+//---------------------------------------------------------------------------
+void Trace_Write(const void* pvData_, uint16_t u16Size_, void* pvContext_)
+{
+    fwrite(pvData_, 1, u16Size_, static_cast<FILE*>(pvContext_));
+}
+
+//---------------------------------------------------------------------------
+void AppMain(void* /*unused*/)
+{
+    clMailbox.Init(au8MailboxBuffer, sizeof(au8MailboxBuffer), sizeof(uint32_t));
+    clMutex.Init();
+    clTimerSem.Init(0, MESSAGES);
+    clDoneSem.Init(0, 3);
+
+    clProducerThread.Init(awProducerStack, sizeof(awProducerStack), 3, ProducerMain, nullptr);
+    clConsumerThread.Init(awConsumerStack, sizeof(awConsumerStack), 2, ConsumerMain, nullptr);
+    clContenderThread.Init(awContenderStack, sizeof(awContenderStack), 4, ContenderMain, nullptr);
+    clProducerThread.SetID(1);
+    clConsumerThread.SetID(2);
+    clContenderThread.SetID(3);
+
+    clTimer.Init();
+    clTimer.Start(true, 2, Timer_Callback, nullptr);
+
+    clProducerThread.Start();
+    clConsumerThread.Start();
+    clContenderThread.Start();
+    for (uint8_t i = 0; i < 3; i++) { clDoneSem.Pend(); }
+    clTimer.Stop();
+
+    auto u16Count = KernelTrace::GetCount();
+    auto u32Lost  = KernelTrace::GetLost();
+    auto* pstFile = fopen(szPath, "wb");
+    if (nullptr == pstFile) {
+        printf("can't create %s\n", szPath);
+        fflush(stdout);
+        _exit(1);
+    }
+    KernelTrace::Dump(Trace_Write, pstFile);
+    fclose(pstFile);
+    printf("wrote %u records (%u lost) to %s\n", u16Count, static_cast<unsigned>(u32Lost), szPath);
+
+    fflush(stdout);
+    _exit(0);
+}
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    if (argc > 1) {
+        szPath = argv[1];
+    }
+
+    Kernel::Init();
+
+    clMainThread.Init(awMainStack, sizeof(awMainStack), 1, AppMain, nullptr);
+    clIdleThread.Init(awIdleStack, sizeof(awIdleStack), 0, IdleMain, nullptr);
+    clMainThread.SetID(0);
+
+    clMainThread.Start();
+    clIdleThread.Start();
+
+    Kernel::Start();
+    return 0;
+}
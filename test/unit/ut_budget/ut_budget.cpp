@@ -0,0 +1,135 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "thread.h"
+#include "memutil.h"
+#include "driver.h"
+
+//===========================================================================
+// Local Defines
+//===========================================================================
+#if KERNEL_BUDGET
+namespace
+{
+using namespace Mark3;
+
+Thread        clThread;
+K_WORD        aucStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+TickStopwatch clStopwatch;
+
+//---------------------------------------------------------------------------
+void SpinEntry(void* /*unused*/)
+{
+    while (1) {}
+}
+
+//---------------------------------------------------------------------------
+void SleepEntry(void* /*unused*/)
+{
+    while (1) { Thread::Sleep(5); }
+}
+} // anonymous namespace
+#endif // #if KERNEL_BUDGET
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_BUDGET
+TEST(ut_budget_exhaust)
+{
+    // A high-priority thread that never blocks runs for its budget, then is
+    // demoted to its exhausted priority - here below the app's priority, so
+    // the app gets to run again straight away.
+    clThread.Init(aucStack, sizeof(aucStack), 3, SpinEntry, nullptr);
+    clThread.SetBudget(10, 200, 0);
+    EXPECT_EQUALS(clThread.GetBudgetRemaining(), 10);
+    EXPECT_FALSE(clThread.IsBudgetExhausted());
+
+    clStopwatch.Init();
+    clStopwatch.Start();
+    clThread.Start();
+    clStopwatch.Stop();
+
+    EXPECT_TRUE(clThread.IsBudgetExhausted());
+    EXPECT_EQUALS(clThread.GetPriority(), 0);
+    EXPECT_EQUALS(clThread.GetBudgetRemaining(), 0);
+    EXPECT_GTE(clStopwatch.GetCurrent(), 10);
+    EXPECT_LTE(clStopwatch.GetCurrent(), 12);
+
+    // Stop the thread, so that it's still stopped when its next period
+    // begins; the replenishment refills its budget and restores its priority
+    // whatever state it's in.
+    clThread.Stop();
+    Thread::Sleep(200);
+    EXPECT_FALSE(clThread.IsBudgetExhausted());
+    EXPECT_EQUALS(clThread.GetPriority(), 3);
+    EXPECT_EQUALS(clThread.GetBudgetRemaining(), 10);
+
+    clThread.Exit();
+}
+
+//===========================================================================
+TEST(ut_budget_remove)
+{
+    // Removing the budget from an exhausted thread restores its priority
+    // immediately, and it's no longer limited.
+    clThread.Init(aucStack, sizeof(aucStack), 3, SpinEntry, nullptr);
+    clThread.SetBudget(5, 500, 0);
+    clThread.Start();
+
+    EXPECT_TRUE(clThread.IsBudgetExhausted());
+    EXPECT_EQUALS(clThread.GetPriority(), 0);
+
+    clThread.Stop();
+    clThread.SetBudget(0, 0, 0);
+    EXPECT_FALSE(clThread.IsBudgetExhausted());
+    EXPECT_EQUALS(clThread.GetPriority(), 3);
+
+    clThread.Exit();
+}
+
+//===========================================================================
+TEST(ut_budget_blocked)
+{
+    // A thread is only charged for the ticks it's running, so one that spends
+    // nearly all its time asleep never runs out of budget.
+    clThread.Init(aucStack, sizeof(aucStack), 3, SleepEntry, nullptr);
+    clThread.SetBudget(5, 500, 1);
+    clThread.Start();
+
+    Thread::Sleep(100);
+    EXPECT_FALSE(clThread.IsBudgetExhausted());
+    EXPECT_EQUALS(clThread.GetPriority(), 3);
+    EXPECT_GT(clThread.GetBudgetRemaining(), 0);
+
+    clThread.Exit();
+}
+#endif // #if KERNEL_BUDGET
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_BUDGET
+TEST_CASE(ut_budget_exhaust), TEST_CASE(ut_budget_remove), TEST_CASE(ut_budget_blocked),
+#endif // #if KERNEL_BUDGET
+    TEST_CASE_END
+} // namespace Mark3
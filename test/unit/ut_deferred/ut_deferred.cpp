@@ -0,0 +1,220 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "thread.h"
+#include "ksemaphore.h"
+#include "notify.h"
+#include "eventflag.h"
+#include "deferredpost.h"
+#include "memutil.h"
+#include "driver.h"
+
+//===========================================================================
+// Local Defines
+//===========================================================================
+#if KERNEL_DEFERRED_POST
+namespace
+{
+using namespace Mark3;
+
+Thread           clThread1;
+Thread           clThread2;
+K_WORD           aucStack1[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD           aucStack2[PORT_KERNEL_DEFAULT_STACK_SIZE];
+Semaphore        clSem;
+Notify           clNotify;
+volatile uint8_t u8Wakes1;
+volatile uint8_t u8Wakes2;
+
+//---------------------------------------------------------------------------
+void SemEntry(void* /*unused*/)
+{
+    while (1) {
+        clSem.Pend();
+        u8Wakes1++;
+    }
+}
+
+//---------------------------------------------------------------------------
+void NotifyEntry(void* /*unused*/)
+{
+    while (1) {
+        clNotify.Wait(nullptr);
+        u8Wakes2++;
+    }
+}
+
+#if KERNEL_EVENT_FLAGS
+EventFlag clFlag;
+
+//---------------------------------------------------------------------------
+void FlagEntry(void* /*unused*/)
+{
+    while (1) {
+        clFlag.Wait(0x0001, EventFlagOperation::Any_Set);
+        clFlag.Clear(0x0001);
+        u8Wakes1++;
+    }
+}
+#endif // #if KERNEL_EVENT_FLAGS
+
+//---------------------------------------------------------------------------
+// Start a thread above the app's priority, which runs until it blocks
+void StartWaiter(Thread* pclThread_, K_WORD* pwStack_, K_ADDR uStackSize_, ThreadEntryFunc pfEntry_)
+{
+    pclThread_->Init(pwStack_, uStackSize_, 2, pfEntry_, nullptr);
+    pclThread_->Start();
+}
+} // anonymous namespace
+#endif // #if KERNEL_DEFERRED_POST
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_DEFERRED_POST
+TEST(ut_deferred_post)
+{
+    // A post from an interrupt is only queued; the waiting thread is woken
+    // when the interrupt commits the queue.
+    u8Wakes1 = 0;
+    clSem.Init(0, 1);
+    StartWaiter(&clThread1, aucStack1, sizeof(aucStack1), SemEntry);
+
+    auto bQueued  = false;
+    auto bPending = false;
+    {
+        // Interrupts are disabled while in an interrupt handler
+        const auto cs = CriticalGuard {};
+        bQueued       = clSem.PostFromIsr();
+        bPending      = DeferredPost::IsPending();
+    }
+    EXPECT_TRUE(bQueued);
+    EXPECT_TRUE(bPending);
+    EXPECT_EQUALS(u8Wakes1, 0);
+
+    DeferredPost::Commit();
+    EXPECT_FALSE(DeferredPost::IsPending());
+    EXPECT_EQUALS(u8Wakes1, 1);
+
+    clThread1.Exit();
+}
+
+//===========================================================================
+TEST(ut_deferred_batch)
+{
+    // Requests queued on different objects are all carried out by one commit
+    u8Wakes1 = 0;
+    u8Wakes2 = 0;
+    clNotify.Init();
+    StartWaiter(&clThread2, aucStack2, sizeof(aucStack2), NotifyEntry);
+#if KERNEL_EVENT_FLAGS
+    clFlag.Init();
+    StartWaiter(&clThread1, aucStack1, sizeof(aucStack1), FlagEntry);
+#endif // #if KERNEL_EVENT_FLAGS
+
+    {
+        const auto cs = CriticalGuard {};
+        clNotify.SignalFromIsr();
+#if KERNEL_EVENT_FLAGS
+        clFlag.SetFromIsr(0x0001);
+#endif // #if KERNEL_EVENT_FLAGS
+    }
+    EXPECT_EQUALS(u8Wakes2, 0);
+
+    DeferredPost::Commit();
+    EXPECT_EQUALS(u8Wakes2, 1);
+#if KERNEL_EVENT_FLAGS
+    EXPECT_EQUALS(u8Wakes1, 1);
+    clThread1.Exit();
+#endif // #if KERNEL_EVENT_FLAGS
+    clThread2.Exit();
+}
+
+//===========================================================================
+TEST(ut_deferred_full)
+{
+    // Requests beyond the queue's depth are refused, and the rest are all
+    // carried out in order.
+    clSem.Init(0, KERNEL_DEFERRED_POST_DEPTH + 1);
+
+    auto u8Queued = uint8_t { 0 };
+    auto bRefused = false;
+    {
+        const auto cs = CriticalGuard {};
+        for (uint8_t i = 0; i < KERNEL_DEFERRED_POST_DEPTH; i++) {
+            if (clSem.PostFromIsr()) {
+                u8Queued++;
+            }
+        }
+        bRefused = !clSem.PostFromIsr();
+    }
+    EXPECT_EQUALS(u8Queued, KERNEL_DEFERRED_POST_DEPTH);
+    EXPECT_TRUE(bRefused);
+
+    DeferredPost::Commit();
+    EXPECT_EQUALS(clSem.GetCount(), KERNEL_DEFERRED_POST_DEPTH);
+
+    // There's room again once the queue has been drained
+    {
+        const auto cs = CriticalGuard {};
+        bRefused      = !clSem.PostFromIsr();
+    }
+    EXPECT_FALSE(bRefused);
+    DeferredPost::Commit();
+    EXPECT_EQUALS(clSem.GetCount(), KERNEL_DEFERRED_POST_DEPTH + 1);
+}
+
+//===========================================================================
+TEST(ut_deferred_locked)
+{
+    // While the scheduler is locked, queued requests are held until it's
+    // unlocked.
+    u8Wakes1 = 0;
+    clSem.Init(0, 1);
+    StartWaiter(&clThread1, aucStack1, sizeof(aucStack1), SemEntry);
+
+    Scheduler::Lock();
+    {
+        const auto cs = CriticalGuard {};
+        clSem.PostFromIsr();
+    }
+    DeferredPost::Commit();
+    EXPECT_TRUE(DeferredPost::IsPending());
+    EXPECT_EQUALS(u8Wakes1, 0);
+
+    Scheduler::Unlock();
+    EXPECT_FALSE(DeferredPost::IsPending());
+    EXPECT_EQUALS(u8Wakes1, 1);
+
+    clThread1.Exit();
+}
+#endif // #if KERNEL_DEFERRED_POST
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_DEFERRED_POST
+TEST_CASE(ut_deferred_post), TEST_CASE(ut_deferred_batch), TEST_CASE(ut_deferred_full),
+    TEST_CASE(ut_deferred_locked),
+#endif // #if KERNEL_DEFERRED_POST
+    TEST_CASE_END
+} // namespace Mark3
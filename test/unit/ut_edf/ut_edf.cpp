@@ -0,0 +1,216 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "thread.h"
+#include "deadlineheap.h"
+#include "paniccodes.h"
+#include "memutil.h"
+#include "driver.h"
+
+//===========================================================================
+// Local Defines
+//===========================================================================
+#if KERNEL_EDF
+namespace
+{
+using namespace Mark3;
+
+#define NUM_THREADS (4)
+
+Thread           aclThreads[NUM_THREADS];
+K_WORD           aucStacks[NUM_THREADS][PORT_KERNEL_DEFAULT_STACK_SIZE];
+volatile uint8_t au8Order[NUM_THREADS];
+volatile uint8_t u8Runs;
+volatile uint16_t u16Panic;
+
+//---------------------------------------------------------------------------
+// Record the cause of a panic, and carry on
+void OnPanic(uint16_t u16Cause_)
+{
+    u16Panic = u16Cause_;
+}
+
+//---------------------------------------------------------------------------
+void InitThreads(PORT_PRIO_TYPE uXPriority_, ThreadEntryFunc pfEntry_)
+{
+    for (uint8_t i = 0; i < NUM_THREADS; i++) {
+        aclThreads[i].Init(aucStacks[i], sizeof(aucStacks[i]), uXPriority_, pfEntry_, reinterpret_cast<void*>(i));
+    }
+}
+
+//---------------------------------------------------------------------------
+void ExitThreads()
+{
+    for (uint8_t i = 0; i < NUM_THREADS; i++) { aclThreads[i].Exit(); }
+}
+
+//---------------------------------------------------------------------------
+// Empty a heap in deadline order, checking that each thread comes out in the
+// expected position.  Returns the number of threads in the right place.
+uint8_t DrainHeap(DeadlineHeap* pclHeap_, const uint8_t* pu8Expected_)
+{
+    auto u8Matched = uint8_t { 0 };
+    for (uint8_t i = 0; i < NUM_THREADS; i++) {
+        auto* pclHead = pclHeap_->GetHead();
+        if (pclHead == &aclThreads[pu8Expected_[i]]) {
+            u8Matched++;
+        }
+        pclHeap_->Remove(pclHead);
+    }
+    return u8Matched;
+}
+} // anonymous namespace
+#endif // #if KERNEL_EDF
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_EDF
+TEST(ut_edf_heap_order)
+{
+    // Threads come out of the heap earliest deadline first, regardless of the
+    // order they were added in, and removing from the middle keeps the order.
+    auto lEntry = [](void* /*unused*/) {};
+    InitThreads(KERNEL_EDF_PRIORITY, lEntry);
+
+    DeadlineHeap clHeap;
+    clHeap.Init();
+    clHeap.Add(&aclThreads[0], 300);
+    clHeap.Add(&aclThreads[1], 100);
+    clHeap.Add(&aclThreads[2], 400);
+    clHeap.Add(&aclThreads[3], 200);
+    EXPECT_EQUALS(clHeap.GetCount(), NUM_THREADS);
+    EXPECT_EQUALS(aclThreads[2].GetAbsoluteDeadline(), 400);
+
+    const uint8_t au8Expected[NUM_THREADS] = { 1, 3, 0, 2 };
+    EXPECT_EQUALS(DrainHeap(&clHeap, au8Expected), NUM_THREADS);
+    EXPECT_TRUE(nullptr == clHeap.GetHead());
+
+    clHeap.Add(&aclThreads[0], 300);
+    clHeap.Add(&aclThreads[1], 100);
+    clHeap.Add(&aclThreads[2], 400);
+    clHeap.Add(&aclThreads[3], 200);
+    clHeap.Remove(&aclThreads[3]);
+    clHeap.Add(&aclThreads[3], 500);
+
+    const uint8_t au8Reordered[NUM_THREADS] = { 1, 0, 2, 3 };
+    EXPECT_EQUALS(DrainHeap(&clHeap, au8Reordered), NUM_THREADS);
+
+    ExitThreads();
+}
+
+//===========================================================================
+TEST(ut_edf_heap_wrap)
+{
+    // Deadlines are compared modulo 2^32, so deadlines just past a tick count
+    // wraparound still sort after those just before it.
+    auto lEntry = [](void* /*unused*/) {};
+    InitThreads(KERNEL_EDF_PRIORITY, lEntry);
+
+    DeadlineHeap clHeap;
+    clHeap.Init();
+    clHeap.Add(&aclThreads[0], 0x00000010);
+    clHeap.Add(&aclThreads[1], 0xFFFFFFFF);
+    clHeap.Add(&aclThreads[2], 0x00000000);
+    clHeap.Add(&aclThreads[3], 0xFFFFFFF0);
+
+    const uint8_t au8Expected[NUM_THREADS] = { 3, 1, 2, 0 };
+    EXPECT_EQUALS(DrainHeap(&clHeap, au8Expected), NUM_THREADS);
+
+    ExitThreads();
+}
+
+//===========================================================================
+TEST(ut_edf_heap_full)
+{
+    // A full heap refuses further threads with a panic instead of writing
+    // past its end, and threads it doesn't hold can't be removed from it.
+    auto lEntry = [](void* /*unused*/) {};
+    InitThreads(KERNEL_EDF_PRIORITY, lEntry);
+
+    auto pfOldPanic = Kernel::GetPanic();
+    Kernel::SetPanic(OnPanic);
+    u16Panic = 0;
+
+    DeadlineHeap clHeap;
+    clHeap.Init();
+    for (uint16_t i = 0; i < KERNEL_EDF_MAX_THREADS - 1; i++) { clHeap.Add(&aclThreads[0], 1000 + i); }
+    clHeap.Add(&aclThreads[1], 100);
+    EXPECT_EQUALS(u16Panic, 0);
+
+    clHeap.Add(&aclThreads[2], 50);
+    EXPECT_EQUALS(u16Panic, PANIC_EDF_HEAP_FULL);
+    EXPECT_EQUALS(clHeap.GetCount(), KERNEL_EDF_MAX_THREADS);
+    EXPECT_TRUE(&aclThreads[1] == clHeap.GetHead());
+
+    clHeap.Remove(&aclThreads[2]);
+    EXPECT_EQUALS(clHeap.GetCount(), KERNEL_EDF_MAX_THREADS);
+    clHeap.Remove(&aclThreads[1]);
+    EXPECT_EQUALS(clHeap.GetCount(), KERNEL_EDF_MAX_THREADS - 1);
+
+    Kernel::SetPanic(pfOldPanic);
+    ExitThreads();
+}
+
+//===========================================================================
+TEST(ut_edf_schedule)
+{
+    // Threads made ready together in the EDF band run in order of their
+    // relative deadlines, not the order they were started in.
+    auto lEntry = [](void* param_) {
+        au8Order[u8Runs++] = static_cast<uint8_t>(reinterpret_cast<K_ADDR>(param_));
+        Scheduler::GetCurrentThread()->Exit();
+    };
+
+    u8Runs = 0;
+    InitThreads(KERNEL_EDF_PRIORITY, lEntry);
+    aclThreads[0].SetDeadline(40);
+    aclThreads[1].SetDeadline(10);
+    aclThreads[2].SetDeadline(30);
+    aclThreads[3].SetDeadline(20);
+    EXPECT_EQUALS(aclThreads[1].GetDeadline(), 10);
+
+    // Run above the band while the threads are started, then get out of the
+    // way.
+    auto* pclApp = Scheduler::GetCurrentThread();
+    pclApp->SetPriority(KERNEL_EDF_PRIORITY + 1);
+    for (uint8_t i = 0; i < NUM_THREADS; i++) { aclThreads[i].Start(); }
+    Thread::Sleep(10);
+    pclApp->SetPriority(1);
+
+    EXPECT_EQUALS(u8Runs, NUM_THREADS);
+    EXPECT_EQUALS(au8Order[0], 1);
+    EXPECT_EQUALS(au8Order[1], 3);
+    EXPECT_EQUALS(au8Order[2], 2);
+    EXPECT_EQUALS(au8Order[3], 0);
+}
+#endif // #if KERNEL_EDF
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_EDF
+TEST_CASE(ut_edf_heap_order), TEST_CASE(ut_edf_heap_wrap), TEST_CASE(ut_edf_heap_full),
+    TEST_CASE(ut_edf_schedule),
+#endif // #if KERNEL_EDF
+    TEST_CASE_END
+} // namespace Mark3
@@ -0,0 +1,165 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "thread.h"
+#include "ksemaphore.h"
+#include "hirestimer.h"
+#include "memutil.h"
+#include "driver.h"
+
+//===========================================================================
+// Local Defines
+//===========================================================================
+#if KERNEL_HIRES_TIMERS
+namespace
+{
+using namespace Mark3;
+
+#define MAX_EXPIRIES (16)
+
+// Kernel clock cycles in the given number of microseconds
+#define US_TO_CYCLES(x) ((static_cast<uint64_t>(x) * PORT_TIMER_FREQ) / 1000)
+
+HiResTimer        aclTimers[3];
+Semaphore         clSem;
+uint64_t          au64Expired[MAX_EXPIRIES];
+uintptr_t         auOrder[MAX_EXPIRIES];
+volatile uint8_t  u8Expired;
+
+//---------------------------------------------------------------------------
+// Record when, and which, timer expired
+void OnExpiry(Thread* /*owner*/, void* data_)
+{
+    if (u8Expired < MAX_EXPIRIES) {
+        au64Expired[u8Expired] = Kernel::GetClock();
+        auOrder[u8Expired]     = reinterpret_cast<uintptr_t>(data_);
+        u8Expired++;
+        clSem.Post();
+    }
+}
+} // anonymous namespace
+#endif // #if KERNEL_HIRES_TIMERS
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_HIRES_TIMERS
+TEST(ut_hirestimer_oneshot)
+{
+    // A one-shot timer expires once, no earlier than its interval, and well
+    // within a kernel tick of it.
+    u8Expired = 0;
+    clSem.Init(0, MAX_EXPIRIES);
+    aclTimers[0].Init();
+
+    auto u64Start = Kernel::GetClock();
+    aclTimers[0].Start(false, 300, OnExpiry, nullptr);
+    EXPECT_TRUE(aclTimers[0].IsActive());
+    EXPECT_TRUE(clSem.Pend(10));
+    EXPECT_FALSE(aclTimers[0].IsActive());
+
+    auto u64Elapsed = au64Expired[0] - u64Start;
+    EXPECT_GTE(u64Elapsed, US_TO_CYCLES(300));
+    EXPECT_LT(u64Elapsed, US_TO_CYCLES(300) + PORT_TIMER_FREQ);
+
+    Thread::Sleep(2);
+    EXPECT_EQUALS(u8Expired, 1);
+}
+
+//===========================================================================
+TEST(ut_hirestimer_periodic)
+{
+    // A periodic timer is reloaded from its previous expiry, so its
+    // expiries stay in phase with the time it was started.
+    u8Expired = 0;
+    clSem.Init(0, MAX_EXPIRIES);
+    aclTimers[0].Init();
+
+    auto u64Start = Kernel::GetClock();
+    aclTimers[0].Start(true, 250, OnExpiry, nullptr);
+    for (uint8_t i = 0; i < 8; i++) { clSem.Pend(10); }
+    aclTimers[0].Stop();
+    EXPECT_FALSE(aclTimers[0].IsActive());
+
+    EXPECT_EQUALS(u8Expired, 8);
+    for (uint8_t i = 0; i < 8; i++) { EXPECT_GTE(au64Expired[i] - u64Start, US_TO_CYCLES(250) * (i + 1)); }
+
+    // Eight periods, with no error accumulated along the way
+    EXPECT_LT(au64Expired[7] - u64Start, (US_TO_CYCLES(250) * 8) + PORT_TIMER_FREQ);
+}
+
+//===========================================================================
+TEST(ut_hirestimer_order)
+{
+    // Timers expire in order of their expiry time, not of when they were
+    // started.
+    static const uint32_t au32Intervals[] = { 600, 200, 400 };
+
+    u8Expired = 0;
+    clSem.Init(0, MAX_EXPIRIES);
+    {
+        // Start them together, so their expiries are spaced as their intervals
+        const auto cs = CriticalGuard {};
+        for (uintptr_t i = 0; i < 3; i++) {
+            aclTimers[i].Init();
+            aclTimers[i].Start(false, au32Intervals[i], OnExpiry, reinterpret_cast<void*>(i));
+        }
+    }
+    for (uint8_t i = 0; i < 3; i++) { clSem.Pend(10); }
+
+    EXPECT_EQUALS(u8Expired, 3);
+    EXPECT_EQUALS(auOrder[0], 1);
+    EXPECT_EQUALS(auOrder[1], 2);
+    EXPECT_EQUALS(auOrder[2], 0);
+}
+
+//===========================================================================
+TEST(ut_hirestimer_stop)
+{
+    // A stopped timer never expires, even if it was at the head of the queue
+    // with the compare already armed for it.
+    u8Expired = 0;
+    clSem.Init(0, MAX_EXPIRIES);
+    aclTimers[0].Init();
+    aclTimers[1].Init();
+
+    aclTimers[0].Start(false, 500, OnExpiry, reinterpret_cast<void*>(0));
+    aclTimers[1].Start(false, 1500, OnExpiry, reinterpret_cast<void*>(1));
+    aclTimers[0].Stop();
+    EXPECT_FALSE(aclTimers[0].IsActive());
+
+    EXPECT_TRUE(clSem.Pend(10));
+    Thread::Sleep(2);
+    EXPECT_EQUALS(u8Expired, 1);
+    EXPECT_EQUALS(auOrder[0], 1);
+}
+#endif // #if KERNEL_HIRES_TIMERS
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_HIRES_TIMERS
+TEST_CASE(ut_hirestimer_oneshot), TEST_CASE(ut_hirestimer_periodic), TEST_CASE(ut_hirestimer_order),
+    TEST_CASE(ut_hirestimer_stop),
+#endif // #if KERNEL_HIRES_TIMERS
+    TEST_CASE_END
+} // namespace Mark3
@@ -0,0 +1,202 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "thread.h"
+#include "partitionscheduler.h"
+#include "paniccodes.h"
+#include "memutil.h"
+#include "driver.h"
+
+//===========================================================================
+// Local Defines
+//===========================================================================
+#if KERNEL_PARTITIONS
+namespace
+{
+using namespace Mark3;
+
+// The app runs above the partitioned threads, so it can watch them
+#define APP_PRIO (3)
+#define SPIN_PRIO (2)
+
+Thread            clThread1;
+Thread            clThread2;
+K_WORD            aucStack1[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD            aucStack2[PORT_KERNEL_DEFAULT_STACK_SIZE];
+volatile uint32_t au32Ticks[2];
+volatile uint16_t u16Panic;
+
+//---------------------------------------------------------------------------
+// Record the cause of a panic, and carry on
+void OnPanic(uint16_t u16Cause_)
+{
+    u16Panic = u16Cause_;
+}
+
+//---------------------------------------------------------------------------
+// Count the distinct ticks during which the thread got to run
+void SpinEntry(void* param_)
+{
+    auto* pu32Ticks = static_cast<volatile uint32_t*>(param_);
+    auto  u32Last   = Kernel::GetTicks();
+    while (1) {
+        auto u32Now = Kernel::GetTicks();
+        if (u32Now != u32Last) {
+            u32Last = u32Now;
+            (*pu32Ticks)++;
+        }
+    }
+}
+} // anonymous namespace
+#endif // #if KERNEL_PARTITIONS
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_PARTITIONS
+TEST(ut_partition_invalid)
+{
+    // Partitions past KERNEL_NUM_PARTITIONS are refused - by a panic, after
+    // which the thread and the schedule are left as they were.
+    static const PartitionWindow astBadPartition[] = {
+        { 1, 10 },
+        { KERNEL_NUM_PARTITIONS, 10 },
+    };
+    static const PartitionWindow astBadTicks[] = {
+        { 1, 0 },
+    };
+
+    auto pfOldPanic = Kernel::GetPanic();
+    Kernel::SetPanic(OnPanic);
+
+    u16Panic = 0;
+    clThread1.Init(aucStack1, sizeof(aucStack1), SPIN_PRIO, SpinEntry, (void*)&au32Ticks[0]);
+    clThread1.SetPartition(KERNEL_NUM_PARTITIONS);
+    EXPECT_EQUALS(u16Panic, PANIC_PARTITION_INVALID);
+    EXPECT_EQUALS(clThread1.GetPartition(), 0);
+
+    u16Panic = 0;
+    PartitionScheduler::SetSchedule(astBadPartition, 2);
+    EXPECT_EQUALS(u16Panic, PANIC_PARTITION_INVALID);
+    EXPECT_EQUALS(Scheduler::GetActivePartition(), 0);
+
+    u16Panic = 0;
+    PartitionScheduler::SetSchedule(astBadTicks, 1);
+    EXPECT_EQUALS(u16Panic, PANIC_PARTITION_INVALID);
+    EXPECT_EQUALS(Scheduler::GetActivePartition(), 0);
+
+    Kernel::SetPanic(pfOldPanic);
+}
+#endif // #if KERNEL_PARTITIONS
+
+// The remaining tests need two partitions besides the system partition
+#if KERNEL_NUM_PARTITIONS >= 3
+//===========================================================================
+TEST(ut_partition_windows)
+{
+    // Two threads that never block, in different partitions, each only run in
+    // their own partition's windows - splitting the CPU 1:3, as the schedule
+    // does.
+    static const PartitionWindow astFrame[] = {
+        { 1, 10 },
+        { 2, 30 },
+    };
+
+    auto* pclApp = Scheduler::GetCurrentThread();
+    pclApp->SetPriority(APP_PRIO);
+
+    au32Ticks[0] = 0;
+    au32Ticks[1] = 0;
+    clThread1.Init(aucStack1, sizeof(aucStack1), SPIN_PRIO, SpinEntry, (void*)&au32Ticks[0]);
+    clThread2.Init(aucStack2, sizeof(aucStack2), SPIN_PRIO, SpinEntry, (void*)&au32Ticks[1]);
+    clThread1.SetPartition(1);
+    clThread2.SetPartition(2);
+    EXPECT_EQUALS(clThread2.GetPartition(), 2);
+
+    PartitionScheduler::SetSchedule(astFrame, 2);
+    EXPECT_EQUALS(Scheduler::GetActivePartition(), 1);
+    EXPECT_EQUALS(PartitionScheduler::GetWindow(), 0);
+
+    clThread1.Start();
+    clThread2.Start();
+    Thread::Sleep(400);
+
+    clThread1.Exit();
+    clThread2.Exit();
+    pclApp->SetPriority(1);
+
+    EXPECT_GTE(au32Ticks[0], 80);
+    EXPECT_LTE(au32Ticks[0], 120);
+    EXPECT_GTE(au32Ticks[1], 260);
+    EXPECT_LTE(au32Ticks[1], 320);
+    EXPECT_LTE(au32Ticks[0] + au32Ticks[1], 400);
+}
+
+//===========================================================================
+TEST(ut_partition_move)
+{
+    // A ready thread outside the active partition doesn't run until it's
+    // moved into it.  The system partition - the app's - runs throughout.
+    static const PartitionWindow astFrame[] = {
+        { 2, 1000 },
+    };
+
+    auto* pclApp = Scheduler::GetCurrentThread();
+    pclApp->SetPriority(APP_PRIO);
+    PartitionScheduler::SetSchedule(astFrame, 1);
+    EXPECT_EQUALS(Scheduler::GetActivePartition(), 2);
+
+    au32Ticks[0] = 0;
+    clThread1.Init(aucStack1, sizeof(aucStack1), SPIN_PRIO, SpinEntry, (void*)&au32Ticks[0]);
+    clThread1.SetPartition(1);
+    clThread1.Start();
+    Thread::Sleep(20);
+    EXPECT_EQUALS(au32Ticks[0], 0);
+
+    clThread1.SetPartition(2);
+    Thread::Sleep(20);
+    EXPECT_GT(au32Ticks[0], 0);
+    EXPECT_LTE(PartitionScheduler::GetTicksRemaining(), 1000 - 40);
+
+    clThread1.Exit();
+    pclApp->SetPriority(1);
+
+    // Leave only the system partition running
+    static const PartitionWindow astSystem[] = {
+        { 0, 1000 },
+    };
+    PartitionScheduler::SetSchedule(astSystem, 1);
+    EXPECT_EQUALS(Scheduler::GetActivePartition(), 0);
+}
+#endif // #if KERNEL_NUM_PARTITIONS >= 3
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_PARTITIONS
+TEST_CASE(ut_partition_invalid),
+#endif // #if KERNEL_PARTITIONS
+#if KERNEL_NUM_PARTITIONS >= 3
+    TEST_CASE(ut_partition_windows), TEST_CASE(ut_partition_move),
+#endif // #if KERNEL_NUM_PARTITIONS >= 3
+    TEST_CASE_END
+} // namespace Mark3
@@ -34,6 +34,12 @@ K_WORD aucAppStack[(PORT_KERNEL_DEFAULT_STACK_SIZE * 3) / 2];
 Thread IdleThread; //!< Idle thread - runs when app can't
 K_WORD aucIdleStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
 
+#if KERNEL_SMP
+//---------------------------------------------------------------------------
+Thread aclCoreIdleThreads[KERNEL_NUM_CORES - 1]; //!< Idle threads for the other cores
+K_WORD aucCoreIdleStacks[KERNEL_NUM_CORES - 1][PORT_KERNEL_DEFAULT_STACK_SIZE];
+#endif // #if KERNEL_SMP
+
 using FuncPtr = void (*)(void);
 
 //---------------------------------------------------------------------------
@@ -81,7 +87,13 @@ void AppEntry(void* /*unused*/)
 //---------------------------------------------------------------------------
 void IdleEntry(void* args)
 {
-    while (1) { UnitTestSupport::OnIdle(); }
+    while (1) {
+#if KERNEL_TICKLESS
+        Tickless::Idle();
+#else
+        UnitTestSupport::OnIdle();
+#endif // #if KERNEL_TICKLESS
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -121,6 +133,54 @@ void MyUnitTest::PrintTestResult()
     PrintString((const char*)acTemp);
     PrintString("]\n");
 }
+
+//---------------------------------------------------------------------------
+void TickStopwatch::Init()
+{
+    m_u32StartTicks       = 0;
+    m_u32CurrentIteration = 0;
+    m_u32Cumulative       = 0;
+    m_u32Iterations       = 0;
+    m_bActive             = false;
+}
+
+//---------------------------------------------------------------------------
+void TickStopwatch::Start()
+{
+    if (!m_bActive) {
+        m_u32StartTicks = Kernel::GetTicks();
+        m_bActive       = true;
+    }
+}
+
+//---------------------------------------------------------------------------
+void TickStopwatch::Stop()
+{
+    if (m_bActive) {
+        m_u32CurrentIteration = Kernel::GetTicks() - m_u32StartTicks;
+        m_u32Cumulative += m_u32CurrentIteration;
+        m_u32Iterations++;
+        m_bActive = false;
+    }
+}
+
+//---------------------------------------------------------------------------
+uint32_t TickStopwatch::GetCurrent()
+{
+    if (m_bActive) {
+        return Kernel::GetTicks() - m_u32StartTicks;
+    }
+    return m_u32CurrentIteration;
+}
+
+//---------------------------------------------------------------------------
+uint32_t TickStopwatch::GetAverage()
+{
+    if (0u != m_u32Iterations) {
+        return (m_u32Cumulative + (m_u32Iterations / 2)) / m_u32Iterations;
+    }
+    return 0;
+}
 } // namespace Mark3
 
 using namespace Mark3;
@@ -146,6 +206,22 @@ int main(void)
 
     IdleThread.Start();
 
+#if KERNEL_SMP
+    // The app and its idle thread run on core 0; every other core only needs
+    // an idle thread until a test assigns it work.
+    AppThread.SetCore(0);
+    IdleThread.SetCore(0);
+    for (uint8_t i = 0; i < KERNEL_NUM_CORES - 1; i++) {
+        aclCoreIdleThreads[i].Init(aucCoreIdleStacks[i],
+                                   sizeof(aucCoreIdleStacks[i]),
+                                   0,
+                                   (ThreadEntryFunc)IdleEntry,
+                                   nullptr);
+        aclCoreIdleThreads[i].SetCore(i + 1);
+        aclCoreIdleThreads[i].Start();
+    }
+#endif // #if KERNEL_SMP
+
     UnitTestSupport::OnInit();
 
     Kernel::Start(); //!< Start the kernel!
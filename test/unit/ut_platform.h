@@ -28,6 +28,29 @@ public:
     void PrintTestResult();
 };
 
+//---------------------------------------------------------------------------
+/**
+ * Stopwatch for tests that check sleeps and timer expiries, measured in
+ * kernel ticks (ms).  Mirrors the ProfileTimer interface, which counts CPU
+ * cycles rather than ticks.
+ */
+class TickStopwatch
+{
+public:
+    void     Init();
+    void     Start();
+    void     Stop();
+    uint32_t GetCurrent();
+    uint32_t GetAverage();
+
+private:
+    uint32_t m_u32StartTicks;
+    uint32_t m_u32CurrentIteration;
+    uint32_t m_u32Cumulative;
+    uint32_t m_u32Iterations;
+    bool     m_bActive;
+};
+
 //---------------------------------------------------------------------------
 typedef void (*TestFunc)(MyUnitTest* pclCurrent);
 
@@ -0,0 +1,127 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "mark3.h"
+
+namespace
+{
+using namespace Mark3;
+//===========================================================================
+// Local Defines
+//===========================================================================
+// One single-level and one multi-level map for each word size
+PriorityMapN<uint8_t, 8>     clMap8x1;
+PriorityMapN<uint8_t, 200>   clMap8x3;
+PriorityMapN<uint16_t, 16>   clMap16x1;
+PriorityMapN<uint16_t, 4096> clMap16x3;
+PriorityMapN<uint32_t, 32>   clMap32x1;
+PriorityMapN<uint32_t, 1025> clMap32x3;
+PriorityMapN<uint64_t, 64>   clMap64x1;
+PriorityMapN<uint64_t, 4096> clMap64x2;
+
+//---------------------------------------------------------------------------
+// Set every priority from lowest to highest, checking the highest at each
+// step, then clear them from highest to lowest.
+template <typename T, size_t C>
+bool PriorityMap_Sweep(PriorityMapN<T, C>* pclMap_)
+{
+    if (0 != pclMap_->HighestPriority()) {
+        return false;
+    }
+    for (size_t i = 0; i < C; i++) {
+        pclMap_->Set(static_cast<T>(i));
+        if (static_cast<size_t>(pclMap_->HighestPriority()) != (i + 1)) {
+            return false;
+        }
+    }
+    for (size_t i = C; i > 0; i--) {
+        if (static_cast<size_t>(pclMap_->HighestPriority()) != i) {
+            return false;
+        }
+        pclMap_->Clear(static_cast<T>(i - 1));
+    }
+    return (0 == pclMap_->HighestPriority());
+}
+
+//---------------------------------------------------------------------------
+// Clearing a priority must not affect others sharing the same words
+template <typename T, size_t C>
+bool PriorityMap_Sparse(PriorityMapN<T, C>* pclMap_)
+{
+    auto uXLow  = T { 0 };
+    auto uXMid  = static_cast<T>(C / 2);
+    auto uXHigh = static_cast<T>(C - 1);
+
+    pclMap_->Set(uXLow);
+    pclMap_->Set(uXHigh);
+    pclMap_->Set(uXMid);
+    if (pclMap_->HighestPriority() != (uXHigh + 1)) {
+        return false;
+    }
+    pclMap_->Clear(uXHigh);
+    if (pclMap_->HighestPriority() != (uXMid + 1)) {
+        return false;
+    }
+    // Setting the same priority twice is idempotent
+    pclMap_->Set(uXMid);
+    pclMap_->Clear(uXMid);
+    if (pclMap_->HighestPriority() != (uXLow + 1)) {
+        return false;
+    }
+    pclMap_->Clear(uXLow);
+    return (0 == pclMap_->HighestPriority());
+}
+} // anonymous namespace
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+TEST(ut_priomap_sweep)
+{
+    EXPECT_TRUE(PriorityMap_Sweep(&clMap8x1));
+    EXPECT_TRUE(PriorityMap_Sweep(&clMap8x3));
+    EXPECT_TRUE(PriorityMap_Sweep(&clMap16x1));
+    EXPECT_TRUE(PriorityMap_Sweep(&clMap16x3));
+    EXPECT_TRUE(PriorityMap_Sweep(&clMap32x1));
+    EXPECT_TRUE(PriorityMap_Sweep(&clMap32x3));
+    EXPECT_TRUE(PriorityMap_Sweep(&clMap64x1));
+    EXPECT_TRUE(PriorityMap_Sweep(&clMap64x2));
+}
+
+//===========================================================================
+TEST(ut_priomap_sparse)
+{
+    EXPECT_TRUE(PriorityMap_Sparse(&clMap8x1));
+    EXPECT_TRUE(PriorityMap_Sparse(&clMap8x3));
+    EXPECT_TRUE(PriorityMap_Sparse(&clMap16x1));
+    EXPECT_TRUE(PriorityMap_Sparse(&clMap16x3));
+    EXPECT_TRUE(PriorityMap_Sparse(&clMap32x1));
+    EXPECT_TRUE(PriorityMap_Sparse(&clMap32x3));
+    EXPECT_TRUE(PriorityMap_Sparse(&clMap64x1));
+    EXPECT_TRUE(PriorityMap_Sparse(&clMap64x2));
+}
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+TEST_CASE(ut_priomap_sweep), TEST_CASE(ut_priomap_sparse), TEST_CASE_END
+} // namespace Mark3
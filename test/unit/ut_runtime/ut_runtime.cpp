@@ -0,0 +1,146 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "ksemaphore.h"
+#include "thread.h"
+#include "runtime.h"
+#include "memutil.h"
+#include "driver.h"
+
+//===========================================================================
+// Local Defines
+//===========================================================================
+#if KERNEL_RUN_TIME
+namespace
+{
+using namespace Mark3;
+
+#define MAX_SAMPLES (8)
+
+Thread        clThread1;
+Thread        clThread2;
+K_WORD        aucStack1[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD        aucStack2[PORT_KERNEL_DEFAULT_STACK_SIZE];
+Semaphore     clSem;
+RunTimeSample astSamples[MAX_SAMPLES];
+
+//---------------------------------------------------------------------------
+// Busy-wait for the number of ticks given, then block for good
+void BusyEntry(void* param_)
+{
+    auto u32Ticks = static_cast<uint32_t>(reinterpret_cast<K_ADDR>(param_));
+    auto u32Start = Kernel::GetTicks();
+    while ((Kernel::GetTicks() - u32Start) < u32Ticks) {}
+    clSem.Pend();
+}
+
+//---------------------------------------------------------------------------
+// Return the snapshot entry for a thread, or nullptr if it isn't there
+RunTimeSample* FindSample(uint16_t u16Count_, Thread* pclThread_)
+{
+    for (uint16_t i = 0; i < u16Count_; i++) {
+        if (astSamples[i].pclThread == pclThread_) {
+            return &astSamples[i];
+        }
+    }
+    return nullptr;
+}
+} // anonymous namespace
+#endif // #if KERNEL_RUN_TIME
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_RUN_TIME
+TEST(ut_runtime_busy)
+{
+    // Threads are charged for the time they spend running, in proportion:
+    // one that's busy three times as long uses about three times the cycles.
+    clSem.Init(0, 1);
+    clThread1.Init(aucStack1, sizeof(aucStack1), 2, BusyEntry, reinterpret_cast<void*>(30));
+    clThread2.Init(aucStack2, sizeof(aucStack2), 2, BusyEntry, reinterpret_cast<void*>(10));
+    EXPECT_EQUALS(clThread1.GetRunTime(), 0);
+
+    clThread1.Start();
+    clThread2.Start();
+
+    auto u64Time1 = clThread1.GetRunTime();
+    auto u64Time2 = clThread2.GetRunTime();
+    EXPECT_GT(u64Time2, 0);
+    EXPECT_TRUE((u64Time1 > (u64Time2 * 2)) && (u64Time1 < (u64Time2 * 4)));
+
+    // Blocked threads aren't charged any more
+    Thread::Sleep(10);
+    EXPECT_TRUE(clThread1.GetRunTime() == u64Time1);
+
+    clThread1.Exit();
+    clThread2.Exit();
+}
+
+//===========================================================================
+TEST(ut_runtime_idle)
+{
+    // Time spent in the idle thread counts towards the idle time, and time
+    // spent elsewhere doesn't.
+    clSem.Init(0, 1);
+    clThread1.Init(aucStack1, sizeof(aucStack1), 2, BusyEntry, reinterpret_cast<void*>(10));
+
+    auto u64Idle = RunTime::GetIdleTime();
+    clThread1.Start();
+    EXPECT_TRUE(RunTime::GetIdleTime() == u64Idle);
+
+    Thread::Sleep(10);
+    EXPECT_TRUE(RunTime::GetIdleTime() > u64Idle);
+
+    clThread1.Exit();
+}
+
+//===========================================================================
+TEST(ut_runtime_snapshot)
+{
+    // A snapshot lists each initialized thread once, with its current run
+    // time, and stops listing a thread once it exits.
+    clSem.Init(0, 1);
+    clThread1.Init(aucStack1, sizeof(aucStack1), 2, BusyEntry, reinterpret_cast<void*>(5));
+    clThread1.Start();
+
+    auto  u16Count = RunTime::Snapshot(astSamples, MAX_SAMPLES);
+    auto* pstEntry = FindSample(u16Count, &clThread1);
+    EXPECT_TRUE(nullptr != pstEntry);
+    EXPECT_TRUE((nullptr != pstEntry) && (pstEntry->u64RunTime == clThread1.GetRunTime()));
+    EXPECT_TRUE(nullptr != FindSample(u16Count, Scheduler::GetCurrentThread()));
+
+    clThread1.Exit();
+    auto u16After = RunTime::Snapshot(astSamples, MAX_SAMPLES);
+    EXPECT_EQUALS(u16After, u16Count - 1);
+    EXPECT_TRUE(nullptr == FindSample(u16After, &clThread1));
+}
+#endif // #if KERNEL_RUN_TIME
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_RUN_TIME
+TEST_CASE(ut_runtime_busy), TEST_CASE(ut_runtime_idle), TEST_CASE(ut_runtime_snapshot),
+#endif // #if KERNEL_RUN_TIME
+    TEST_CASE_END
+} // namespace Mark3
@@ -0,0 +1,152 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "thread.h"
+#include "mutex.h"
+#include "schedulerguard.h"
+#include "memutil.h"
+#include "driver.h"
+
+//===========================================================================
+// Local Defines
+//===========================================================================
+namespace
+{
+using namespace Mark3;
+
+Thread           clThread;
+K_WORD           aucStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+Mutex            clMutex;
+volatile uint8_t u8Runs;
+
+//---------------------------------------------------------------------------
+void RunEntry(void* /*unused*/)
+{
+    u8Runs++;
+    Scheduler::GetCurrentThread()->Exit();
+}
+
+//---------------------------------------------------------------------------
+// Make a higher-priority thread ready on this core; it runs as soon as the
+// scheduler can switch to it.
+void StartHigher()
+{
+    u8Runs = 0;
+    clThread.Init(aucStack, sizeof(aucStack), 2, RunEntry, nullptr);
+#if KERNEL_SMP
+    clThread.SetCore(Scheduler::GetCurrentCore());
+#endif // #if KERNEL_SMP
+    clThread.Start();
+}
+} // anonymous namespace
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+TEST(ut_scheduler_nested_lock)
+{
+    // The scheduler stays disabled until the outermost lock is released, and
+    // the switch requested while locked happens then - before Unlock() returns.
+    EXPECT_TRUE(Scheduler::IsEnabled());
+    Scheduler::Lock();
+    Scheduler::Lock();
+    EXPECT_FALSE(Scheduler::IsEnabled());
+
+    StartHigher();
+    EXPECT_EQUALS(u8Runs, 0);
+
+    Scheduler::Unlock();
+    EXPECT_FALSE(Scheduler::IsEnabled());
+    EXPECT_EQUALS(u8Runs, 0);
+
+    Scheduler::Unlock();
+    EXPECT_TRUE(Scheduler::IsEnabled());
+    EXPECT_EQUALS(u8Runs, 1);
+}
+
+//===========================================================================
+TEST(ut_scheduler_nested_guard)
+{
+    // Kernel objects used inside a guard don't re-enable the scheduler early
+    {
+        const auto guard = SchedulerGuard {};
+        clMutex.Init();
+        StartHigher();
+        {
+            const auto inner = SchedulerGuard {};
+            clMutex.Claim();
+            clMutex.Release();
+        }
+        EXPECT_FALSE(Scheduler::IsEnabled());
+        EXPECT_EQUALS(u8Runs, 0);
+    }
+    EXPECT_TRUE(Scheduler::IsEnabled());
+    EXPECT_EQUALS(u8Runs, 1);
+}
+
+//===========================================================================
+TEST(ut_scheduler_set_restore)
+{
+    // Disabling, then restoring the returned state, puts the scheduler back
+    // as it was - enabled, running the queued switch...
+    auto bEnabled = Scheduler::SetScheduler(false);
+    EXPECT_TRUE(bEnabled);
+    EXPECT_FALSE(Scheduler::IsEnabled());
+
+    StartHigher();
+    EXPECT_EQUALS(u8Runs, 0);
+    EXPECT_FALSE(Scheduler::SetScheduler(bEnabled));
+    EXPECT_TRUE(Scheduler::IsEnabled());
+    EXPECT_EQUALS(u8Runs, 1);
+
+    // ...or locked at the same depth, when nested inside Lock()/Unlock()
+    Scheduler::Lock();
+    StartHigher();
+    bEnabled = Scheduler::SetScheduler(false);
+    EXPECT_FALSE(bEnabled);
+    Scheduler::SetScheduler(bEnabled);
+    EXPECT_FALSE(Scheduler::IsEnabled());
+    EXPECT_EQUALS(u8Runs, 0);
+
+    Scheduler::Unlock();
+    EXPECT_TRUE(Scheduler::IsEnabled());
+    EXPECT_EQUALS(u8Runs, 1);
+}
+
+//===========================================================================
+TEST(ut_scheduler_set_enable)
+{
+    // Enabling the scheduler releases every outstanding lock at once
+    Scheduler::Lock();
+    Scheduler::Lock();
+    StartHigher();
+    Scheduler::SetScheduler(true);
+    EXPECT_TRUE(Scheduler::IsEnabled());
+    EXPECT_EQUALS(u8Runs, 1);
+}
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+TEST_CASE(ut_scheduler_nested_lock), TEST_CASE(ut_scheduler_nested_guard), TEST_CASE(ut_scheduler_set_restore),
+    TEST_CASE(ut_scheduler_set_enable), TEST_CASE_END
+} // namespace Mark3
@@ -0,0 +1,167 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "ksemaphore.h"
+#include "thread.h"
+#include "memutil.h"
+#include "driver.h"
+
+//===========================================================================
+// Local Defines
+//===========================================================================
+#if KERNEL_SMP
+namespace
+{
+using namespace Mark3;
+
+// Ticks to wait for another core to respond before giving up
+constexpr auto u32WaitTicks = uint32_t { 100 };
+
+Thread             clThread1;
+Thread             clThread2;
+K_WORD             aucStack1[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD             aucStack2[PORT_KERNEL_DEFAULT_STACK_SIZE];
+Semaphore          clSem;
+volatile bool      bRan;
+volatile uint8_t   u8RanOn;
+volatile uint8_t   u8Counter;
+
+//---------------------------------------------------------------------------
+// Spin on the calling core (without blocking, so that nothing else gets
+// scheduled here) until bRan is set, or the wait times out.
+bool WaitForRun()
+{
+    auto u32Start = Kernel::GetTicks();
+    while (!bRan && ((Kernel::GetTicks() - u32Start) < u32WaitTicks)) {}
+    return bRan;
+}
+} // anonymous namespace
+#endif // #if KERNEL_SMP
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_SMP
+TEST(ut_smp_core_assign)
+{
+    // Threads that aren't explicitly assigned are spread across the cores in
+    // turn, starting from core 0 each time the kernel is initialized.
+    auto lEntry = [](void* /*unused*/) {};
+
+    clThread1.Init(aucStack1, sizeof(aucStack1), 2, lEntry, nullptr);
+    clThread2.Init(aucStack2, sizeof(aucStack2), 2, lEntry, nullptr);
+    EXPECT_EQUALS(clThread2.GetCore(), (clThread1.GetCore() + 1) % KERNEL_NUM_CORES);
+    clThread1.Exit();
+    clThread2.Exit();
+
+    // The single-argument overload reads core 0's system partition
+    EXPECT_TRUE(Scheduler::GetThreadList(1) == Scheduler::GetThreadList(1, 0, 0));
+    EXPECT_TRUE(Scheduler::GetThreadList(1) == Scheduler::GetCurrentThread()->GetOwner());
+}
+
+//===========================================================================
+TEST(ut_smp_start_remote)
+{
+    // Starting a thread on another core must interrupt that core to run it,
+    // while this core carries on running the app thread.  Only core 0 takes
+    // the tick, so without the IPI the idle remote core would never notice.
+    auto lEntry = [](void* /*unused*/) {
+        u8RanOn = Scheduler::GetCurrentCore();
+        bRan    = true;
+        Scheduler::GetCurrentThread()->Exit();
+    };
+
+    bRan    = false;
+    u8RanOn = 0;
+    clThread1.Init(aucStack1, sizeof(aucStack1), 2, lEntry, nullptr);
+    clThread1.SetCore(1);
+    clThread1.Start();
+
+    EXPECT_TRUE(WaitForRun());
+    EXPECT_EQUALS(u8RanOn, 1);
+}
+
+//===========================================================================
+TEST(ut_smp_migrate_self)
+{
+    // A thread can move itself to another core; it resumes there right away.
+    auto lEntry = [](void* /*unused*/) {
+        Scheduler::GetCurrentThread()->SetCore(1);
+        u8RanOn = Scheduler::GetCurrentCore();
+        bRan    = true;
+        Scheduler::GetCurrentThread()->Exit();
+    };
+
+    bRan    = false;
+    u8RanOn = 0;
+    clThread1.Init(aucStack1, sizeof(aucStack1), 2, lEntry, nullptr);
+    clThread1.SetCore(0);
+    clThread1.Start();
+
+    EXPECT_TRUE(WaitForRun());
+    EXPECT_EQUALS(u8RanOn, 1);
+    EXPECT_EQUALS(clThread1.GetCore(), 1);
+}
+
+//===========================================================================
+TEST(ut_smp_wake_remote)
+{
+    // Posting a semaphore that a thread on another core is blocked on wakes
+    // it there, via the IPI sent when it's added back to that core's ready
+    // list.
+    auto lEntry = [](void* /*unused*/) {
+        while (1) {
+            clSem.Pend();
+            u8Counter++;
+        }
+    };
+
+    clSem.Init(0, 1);
+    u8Counter = 0;
+    clThread1.Init(aucStack1, sizeof(aucStack1), 2, lEntry, nullptr);
+    clThread1.SetCore(1);
+    clThread1.Start();
+
+    auto bOk = true;
+    for (uint8_t i = 0; i < 10; i++) {
+        clSem.Post();
+
+        auto u32Start = Kernel::GetTicks();
+        while ((u8Counter == i) && ((Kernel::GetTicks() - u32Start) < u32WaitTicks)) {}
+        bOk = bOk && (u8Counter == (i + 1));
+    }
+    EXPECT_TRUE(bOk);
+    EXPECT_EQUALS(u8Counter, 10);
+
+    clThread1.Exit();
+}
+#endif // #if KERNEL_SMP
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_SMP
+TEST_CASE(ut_smp_core_assign), TEST_CASE(ut_smp_start_remote), TEST_CASE(ut_smp_migrate_self),
+    TEST_CASE(ut_smp_wake_remote),
+#endif // #if KERNEL_SMP
+    TEST_CASE_END
+} // namespace Mark3
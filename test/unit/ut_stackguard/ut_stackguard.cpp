@@ -0,0 +1,186 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "thread.h"
+#include "ksemaphore.h"
+#include "paniccodes.h"
+#include "memutil.h"
+#include "driver.h"
+
+//===========================================================================
+// Local Defines
+//===========================================================================
+#if KERNEL_STACK_CHECK
+namespace
+{
+using namespace Mark3;
+
+#define STACK_WORDS (PORT_KERNEL_DEFAULT_STACK_SIZE / sizeof(K_WORD))
+
+Thread            clThread;
+K_WORD            aucStack[STACK_WORDS];
+Semaphore         clSem;
+volatile uint8_t  u8Runs;
+volatile uint16_t u16Panic;
+PanicFunc         pfOldPanic;
+
+//---------------------------------------------------------------------------
+// Record the cause of a panic, and carry on
+void OnPanic(uint16_t u16Cause_)
+{
+    u16Panic = u16Cause_;
+}
+
+//---------------------------------------------------------------------------
+void WaitEntry(void* /*unused*/)
+{
+    while (1) {
+        clSem.Pend();
+        u8Runs++;
+    }
+}
+
+#if KERNEL_STACK_PAINT
+#define BUFFER_WORDS (256)
+
+//---------------------------------------------------------------------------
+// Use a known amount of stack once, then wait as WaitEntry() does
+void DeepEntry(void* /*unused*/)
+{
+    volatile K_WORD awBuffer[BUFFER_WORDS];
+    for (uint16_t i = 0; i < BUFFER_WORDS; i++) { awBuffer[i] = i; }
+    (void)awBuffer;
+    WaitEntry(nullptr);
+}
+#endif // #if KERNEL_STACK_PAINT
+
+//---------------------------------------------------------------------------
+// Start a thread above the app's priority, which runs until it blocks, with
+// panics recorded rather than fatal.
+void StartWaiter(ThreadEntryFunc pfEntry_)
+{
+    u8Runs     = 0;
+    u16Panic   = 0;
+    pfOldPanic = Kernel::GetPanic();
+    Kernel::SetPanic(OnPanic);
+    clSem.Init(0, 1);
+    clThread.Init(aucStack, sizeof(aucStack), 2, pfEntry_, nullptr);
+    clThread.Start();
+}
+
+//---------------------------------------------------------------------------
+void StopWaiter()
+{
+    clThread.Exit();
+    Kernel::SetPanic(pfOldPanic);
+}
+} // anonymous namespace
+#endif // #if KERNEL_STACK_CHECK
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_STACK_CHECK
+TEST(ut_stackguard_clean)
+{
+    // A thread which stays within its stack can be switched in and out
+    // without tripping the guard.
+    StartWaiter(WaitEntry);
+    for (uint8_t i = 0; i < 10; i++) { clSem.Post(); }
+    EXPECT_EQUALS(u8Runs, 10);
+    EXPECT_EQUALS(u16Panic, 0);
+    StopWaiter();
+}
+
+//===========================================================================
+TEST(ut_stackguard_overflow)
+{
+    // Clobbering the far end of a thread's stack - as an overflow would - is
+    // caught the next time the thread is switched in or out.
+    StartWaiter(WaitEntry);
+    for (uint16_t i = 0; i < (STACK_WORDS / 2) + 1; i++) {
+#if PORT_STACK_GROWS_DOWN
+        aucStack[i] = 0;
+#else
+        aucStack[STACK_WORDS - 1 - i] = 0;
+#endif
+    }
+    EXPECT_EQUALS(u16Panic, 0);
+
+    clSem.Post();
+    EXPECT_EQUALS(u8Runs, 1);
+    EXPECT_EQUALS(u16Panic, PANIC_STACK_SLACK_VIOLATED);
+    StopWaiter();
+}
+
+//===========================================================================
+TEST(ut_stackguard_threshold)
+{
+    // A thread is flagged once it leaves no more than the guard threshold
+    // free on its stack.
+    auto u16Threshold = Kernel::GetStackGuardThreshold();
+    StartWaiter(WaitEntry);
+
+    Kernel::SetStackGuardThreshold(static_cast<uint16_t>(sizeof(aucStack)));
+    clSem.Post();
+    EXPECT_EQUALS(u16Panic, PANIC_STACK_SLACK_VIOLATED);
+
+    Kernel::SetStackGuardThreshold(u16Threshold);
+    u16Panic = 0;
+    clSem.Post();
+    EXPECT_EQUALS(u8Runs, 2);
+    EXPECT_EQUALS(u16Panic, 0);
+    StopWaiter();
+}
+
+#if KERNEL_STACK_PAINT
+//===========================================================================
+TEST(ut_stackguard_slack)
+{
+    // Painted stacks can be measured on demand: the slack shrinks by at least
+    // as much stack as the thread has used.
+    StartWaiter(WaitEntry);
+    auto uShallow = clThread.GetStackSlack();
+    EXPECT_GT(uShallow, Kernel::GetStackGuardThreshold());
+    EXPECT_LT(uShallow, sizeof(aucStack));
+    StopWaiter();
+
+    StartWaiter(DeepEntry);
+    auto uDeep = clThread.GetStackSlack();
+    EXPECT_LTE(uDeep, uShallow - (BUFFER_WORDS * sizeof(K_WORD)));
+    EXPECT_EQUALS(u16Panic, 0);
+    StopWaiter();
+}
+#endif // #if KERNEL_STACK_PAINT
+#endif // #if KERNEL_STACK_CHECK
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_STACK_CHECK
+TEST_CASE(ut_stackguard_clean), TEST_CASE(ut_stackguard_overflow), TEST_CASE(ut_stackguard_threshold),
+#if KERNEL_STACK_PAINT
+    TEST_CASE(ut_stackguard_slack),
+#endif // #if KERNEL_STACK_PAINT
+#endif // #if KERNEL_STACK_CHECK
+    TEST_CASE_END
+} // namespace Mark3
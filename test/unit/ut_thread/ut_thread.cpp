@@ -45,7 +45,7 @@ volatile uint32_t u32RR1;
 volatile uint32_t u32RR2;
 volatile uint32_t u32RR3;
 
-ProfileTimer clProfiler1;
+TickStopwatch clStopwatch;
 } // anonymous namespace
 
 namespace Mark3
@@ -141,33 +141,95 @@ TEST(ut_threadsleep)
     // Start the thread (threads are created in the stopped state)
     clThread1.Start();
 
-    clProfiler1.Init();
+    clStopwatch.Init();
 
-    clProfiler1.Start();
+    clStopwatch.Start();
     clSem1.Post();
     clSem2.Pend();
-    clProfiler1.Stop();
+    clStopwatch.Stop();
 
-    EXPECT_GTE(clProfiler1.GetCurrent(), 5);
-    EXPECT_LTE(clProfiler1.GetCurrent(), 7);
+    EXPECT_GTE(clStopwatch.GetCurrent(), 5);
+    EXPECT_LTE(clStopwatch.GetCurrent(), 7);
 
     clSem1.Post();
-    clProfiler1.Start();
+    clStopwatch.Start();
     clSem2.Pend();
-    clProfiler1.Stop();
+    clStopwatch.Stop();
 
-    EXPECT_GTE(clProfiler1.GetCurrent(), 50);
-    EXPECT_LTE(clProfiler1.GetCurrent(), 52);
+    EXPECT_GTE(clStopwatch.GetCurrent(), 50);
+    EXPECT_LTE(clStopwatch.GetCurrent(), 52);
 
     clSem1.Post();
-    clProfiler1.Start();
+    clStopwatch.Start();
     clSem2.Pend();
-    clProfiler1.Stop();
+    clStopwatch.Stop();
 
-    EXPECT_GTE(clProfiler1.GetCurrent(), 200);
-    EXPECT_LTE(clProfiler1.GetCurrent(), 202);
+    EXPECT_GTE(clStopwatch.GetCurrent(), 200);
+    EXPECT_LTE(clStopwatch.GetCurrent(), 202);
 }
 
+//===========================================================================
+TEST(ut_threadsleepuntil)
+{
+    // Work done between sleeps mustn't push back the following wake-ups
+    auto u32Release = Kernel::GetTicks();
+    for (auto i = 0; i < 10; i++) {
+        auto u32Busy = Kernel::GetTicks() + 3;
+        while (static_cast<int32_t>(Kernel::GetTicks() - u32Busy) < 0) {}
+
+        u32Release += 10;
+        Thread::SleepUntil(u32Release);
+        // Waking early would wrap the difference around
+        EXPECT_LTE(Kernel::GetTicks() - u32Release, 1);
+    }
+
+    // A tick that's already passed doesn't block
+    auto u32Now = Kernel::GetTicks();
+    Thread::SleepUntil(u32Now - 5);
+    EXPECT_LTE(Kernel::GetTicks() - u32Now, 1);
+}
+
+#if KERNEL_PERIODIC_THREADS
+//===========================================================================
+TEST(ut_threadperiodic)
+{
+    // Each release is one period after the previous one, however long the
+    // activation in between took.
+    auto* pclThread = Scheduler::GetCurrentThread();
+    pclThread->SetPeriod(10);
+    EXPECT_EQUALS(pclThread->GetPeriod(), 10);
+
+    auto u32Release = pclThread->GetRelease();
+    for (auto i = 0; i < 5; i++) {
+        auto u32Busy = Kernel::GetTicks() + 3;
+        while (static_cast<int32_t>(Kernel::GetTicks() - u32Busy) < 0) {}
+
+        u32Release += 10;
+        EXPECT_EQUALS(Thread::WaitForPeriod(), 0);
+        EXPECT_EQUALS(pclThread->GetRelease(), u32Release);
+        EXPECT_LTE(Kernel::GetTicks() - u32Release, 1);
+    }
+
+    // An activation overrunning into the period after next skips the release
+    // it missed, and carries on in phase from the latest one due - without
+    // waiting, as that's already passed.
+    auto u32Busy = u32Release + 25;
+    while (static_cast<int32_t>(Kernel::GetTicks() - u32Busy) < 0) {}
+
+    EXPECT_EQUALS(Thread::WaitForPeriod(), 1);
+    EXPECT_EQUALS(pclThread->GetRelease(), u32Release + 20);
+    EXPECT_LTE(Kernel::GetTicks() - u32Busy, 1);
+
+    EXPECT_EQUALS(Thread::WaitForPeriod(), 0);
+    EXPECT_EQUALS(pclThread->GetRelease(), u32Release + 30);
+    EXPECT_LTE(Kernel::GetTicks() - (u32Release + 30), 1);
+}
+#endif // #if KERNEL_PERIODIC_THREADS
+
+// The round-robin tests compare how much work CPU-bound threads get done in
+// their time slices, which is only repeatable on a CPU that isn't shared with
+// anything else (see PORT_SHARED_CPU).
+#if !PORT_SHARED_CPU
 //===========================================================================
 TEST(ut_roundrobin)
 {
@@ -323,12 +385,19 @@ TEST(ut_quanta)
     EXPECT_FAIL_EQUALS(u32RR2, 0);
     EXPECT_FAIL_EQUALS(u32RR3, 0);
 }
+#endif // #if !PORT_SHARED_CPU
 
 //===========================================================================
 // Test Whitelist Goes Here
 //===========================================================================
 TEST_CASE_START
 TEST_CASE(ut_threadcreate)
-, TEST_CASE(ut_threadstop), TEST_CASE(ut_threadexit), TEST_CASE(ut_threadsleep), TEST_CASE(ut_roundrobin),
-    TEST_CASE(ut_quanta), TEST_CASE_END
+, TEST_CASE(ut_threadstop), TEST_CASE(ut_threadexit), TEST_CASE(ut_threadsleep), TEST_CASE(ut_threadsleepuntil),
+#if KERNEL_PERIODIC_THREADS
+    TEST_CASE(ut_threadperiodic),
+#endif // #if KERNEL_PERIODIC_THREADS
+#if !PORT_SHARED_CPU
+    TEST_CASE(ut_roundrobin), TEST_CASE(ut_quanta),
+#endif // #if !PORT_SHARED_CPU
+    TEST_CASE_END
 } // namespace Mark3
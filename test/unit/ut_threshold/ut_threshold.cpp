@@ -0,0 +1,169 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "thread.h"
+#include "memutil.h"
+#include "driver.h"
+
+//===========================================================================
+// Local Defines
+//===========================================================================
+#if KERNEL_PREEMPT_THRESHOLD
+namespace
+{
+using namespace Mark3;
+
+// Log entries, recording which thread got to run when
+#define LOW_START (1)
+#define LOW_END (2)
+#define MID (3)
+#define HIGH (4)
+
+// The low thread runs at 2 with a threshold of 4, shielding it from the
+// mid-priority thread, but not the high-priority thread.
+#define LOW_PRIO (2)
+#define LOW_THRESHOLD (4)
+#define MID_PRIO (3)
+#define HIGH_PRIO (5)
+
+Thread           clLowThread;
+Thread           clMidThread;
+Thread           clHighThread;
+K_WORD           aucLowStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD           aucMidStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+K_WORD           aucHighStack[PORT_KERNEL_DEFAULT_STACK_SIZE];
+volatile uint8_t au8Log[4];
+volatile uint8_t u8LogCount;
+
+//---------------------------------------------------------------------------
+void Log(uint8_t u8Entry_)
+{
+    au8Log[u8LogCount++] = u8Entry_;
+}
+
+//---------------------------------------------------------------------------
+void LogEntry(void* param_)
+{
+    Log(static_cast<uint8_t>(reinterpret_cast<K_ADDR>(param_)));
+    Scheduler::GetCurrentThread()->Exit();
+}
+
+//---------------------------------------------------------------------------
+// Set up the three threads, with the given entry point for the low thread,
+// then run the low thread until it's done.  Threads that weren't started are
+// retired, so they can be initialized again.
+void RunLow(ThreadEntryFunc pfLowEntry_, PORT_PRIO_TYPE uXThreshold_)
+{
+    u8LogCount = 0;
+    clLowThread.Init(aucLowStack, sizeof(aucLowStack), LOW_PRIO, pfLowEntry_, nullptr);
+    clMidThread.Init(aucMidStack, sizeof(aucMidStack), MID_PRIO, LogEntry, reinterpret_cast<void*>(MID));
+    clHighThread.Init(aucHighStack, sizeof(aucHighStack), HIGH_PRIO, LogEntry, reinterpret_cast<void*>(HIGH));
+    clLowThread.SetPreemptThreshold(uXThreshold_);
+    clLowThread.Start();
+    Thread::Sleep(10);
+
+    clLowThread.Exit();
+    clMidThread.Exit();
+    clHighThread.Exit();
+}
+} // anonymous namespace
+#endif // #if KERNEL_PREEMPT_THRESHOLD
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_PREEMPT_THRESHOLD
+TEST(ut_threshold_shield)
+{
+    // A thread made ready at or below the running thread's threshold doesn't
+    // preempt it, even at a higher priority; without a threshold, it does.
+    auto lLowEntry = [](void* /*unused*/) {
+        Log(LOW_START);
+        clMidThread.Start();
+        Log(LOW_END);
+        Scheduler::GetCurrentThread()->Exit();
+    };
+
+    RunLow(lLowEntry, LOW_THRESHOLD);
+    EXPECT_EQUALS(u8LogCount, 3);
+    EXPECT_EQUALS(au8Log[0], LOW_START);
+    EXPECT_EQUALS(au8Log[1], LOW_END);
+    EXPECT_EQUALS(au8Log[2], MID);
+
+    RunLow(lLowEntry, LOW_PRIO);
+    EXPECT_EQUALS(u8LogCount, 3);
+    EXPECT_EQUALS(au8Log[0], LOW_START);
+    EXPECT_EQUALS(au8Log[1], MID);
+    EXPECT_EQUALS(au8Log[2], LOW_END);
+}
+
+//===========================================================================
+TEST(ut_threshold_resume)
+{
+    // A thread above the threshold preempts; once it's done, the preempted
+    // thread resumes ahead of the higher-priority thread still shielded by
+    // its threshold.
+    auto lLowEntry = [](void* /*unused*/) {
+        Log(LOW_START);
+        clMidThread.Start();
+        clHighThread.Start();
+        Log(LOW_END);
+        Scheduler::GetCurrentThread()->Exit();
+    };
+
+    RunLow(lLowEntry, LOW_THRESHOLD);
+    EXPECT_EQUALS(u8LogCount, 4);
+    EXPECT_EQUALS(au8Log[0], LOW_START);
+    EXPECT_EQUALS(au8Log[1], HIGH);
+    EXPECT_EQUALS(au8Log[2], LOW_END);
+    EXPECT_EQUALS(au8Log[3], MID);
+}
+
+//===========================================================================
+TEST(ut_threshold_block)
+{
+    // The threshold only protects a thread while it's running: once it
+    // blocks, higher-priority threads that became ready meanwhile run first.
+    auto lLowEntry = [](void* /*unused*/) {
+        Log(LOW_START);
+        clMidThread.Start();
+        Thread::Sleep(1);
+        Log(LOW_END);
+        Scheduler::GetCurrentThread()->Exit();
+    };
+
+    RunLow(lLowEntry, LOW_THRESHOLD);
+    EXPECT_EQUALS(u8LogCount, 3);
+    EXPECT_EQUALS(au8Log[0], LOW_START);
+    EXPECT_EQUALS(au8Log[1], MID);
+    EXPECT_EQUALS(au8Log[2], LOW_END);
+}
+#endif // #if KERNEL_PREEMPT_THRESHOLD
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_PREEMPT_THRESHOLD
+TEST_CASE(ut_threshold_shield), TEST_CASE(ut_threshold_resume), TEST_CASE(ut_threshold_block),
+#endif // #if KERNEL_PREEMPT_THRESHOLD
+    TEST_CASE_END
+} // namespace Mark3
@@ -0,0 +1,147 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+===========================================================================*/
+
+//---------------------------------------------------------------------------
+
+#include "kerneltypes.h"
+#include "kernel.h"
+#include "../ut_platform.h"
+#include "thread.h"
+#include "timer.h"
+#include "memutil.h"
+#include "driver.h"
+
+//===========================================================================
+// Local Defines
+//===========================================================================
+#if KERNEL_TICKLESS && KERNEL_CONTEXT_SWITCH_CALLOUT
+namespace
+{
+using namespace Mark3;
+
+Timer                clTimer;
+volatile uint32_t    u32Expired;
+volatile uint32_t    u32IdleWakes;
+ThreadContextCallout pfOldCallout;
+
+//---------------------------------------------------------------------------
+// Count the times the idle thread is switched out, i.e. woken up
+void CountIdleWakes(Thread* pclThread_)
+{
+    if (0 == pclThread_->GetCurPriority()) {
+        u32IdleWakes++;
+    }
+    if (nullptr != pfOldCallout) {
+        pfOldCallout(pclThread_);
+    }
+}
+
+//---------------------------------------------------------------------------
+void StartCounting()
+{
+    u32IdleWakes = 0;
+    pfOldCallout = Kernel::GetThreadContextSwitchCallout();
+    Kernel::SetThreadContextSwitchCallout(CountIdleWakes);
+}
+
+//---------------------------------------------------------------------------
+void StopCounting()
+{
+    Kernel::SetThreadContextSwitchCallout(pfOldCallout);
+}
+
+//---------------------------------------------------------------------------
+void OnTimer(Thread* /*owner*/, void* /*data*/)
+{
+    u32Expired++;
+}
+} // anonymous namespace
+#endif // #if KERNEL_TICKLESS && KERNEL_CONTEXT_SWITCH_CALLOUT
+
+namespace Mark3
+{
+//===========================================================================
+// Define Test Cases Here
+//===========================================================================
+#if KERNEL_TICKLESS && KERNEL_CONTEXT_SWITCH_CALLOUT
+TEST(ut_tickless_sleep)
+{
+    // A sleep is slept through with the tick suppressed, waking the idle
+    // thread only around the timeout - and the ticks slept through are still
+    // counted.
+    StartCounting();
+    auto u32Start = Kernel::GetTicks();
+    Thread::Sleep(50);
+    auto u32Elapsed = Kernel::GetTicks() - u32Start;
+    StopCounting();
+
+    EXPECT_GTE(u32Elapsed, 50);
+    EXPECT_LTE(u32Elapsed, 52);
+    EXPECT_LTE(u32IdleWakes, 5);
+}
+
+//===========================================================================
+TEST(ut_tickless_timer)
+{
+    // Timers expire on the same ticks as they would with the tick running,
+    // with the idle thread woken for each expiry instead of each tick.
+    u32Expired = 0;
+    StartCounting();
+    clTimer.Init();
+    clTimer.Start(true, 7, OnTimer, nullptr);
+    auto u32Start = Kernel::GetTicks();
+    Thread::Sleep(70);
+    auto u32Elapsed = Kernel::GetTicks() - u32Start;
+    clTimer.Stop();
+    StopCounting();
+
+    EXPECT_GTE(u32Elapsed, 70);
+    EXPECT_LTE(u32Elapsed, 72);
+    EXPECT_GTE(u32Expired, 9);
+    EXPECT_LTE(u32Expired, 11);
+    EXPECT_LTE(u32IdleWakes, 25);
+}
+
+//===========================================================================
+TEST(ut_tickless_busy)
+{
+    // The tick keeps running while a thread is busy, so time spent
+    // busy-waiting is counted tick by tick.
+    StartCounting();
+    auto u32Start = Kernel::GetTicks();
+    auto u32Last  = u32Start;
+    auto u32Steps = uint32_t { 0 };
+    while ((u32Last - u32Start) < 20) {
+        auto u32Now = Kernel::GetTicks();
+        if (u32Now != u32Last) {
+            u32Steps++;
+            u32Last = u32Now;
+        }
+    }
+    StopCounting();
+
+    EXPECT_GTE(u32Steps, 18);
+    EXPECT_EQUALS(u32IdleWakes, 0);
+}
+#endif // #if KERNEL_TICKLESS && KERNEL_CONTEXT_SWITCH_CALLOUT
+
+//===========================================================================
+// Test Whitelist Goes Here
+//===========================================================================
+TEST_CASE_START
+#if KERNEL_TICKLESS && KERNEL_CONTEXT_SWITCH_CALLOUT
+TEST_CASE(ut_tickless_sleep), TEST_CASE(ut_tickless_timer), TEST_CASE(ut_tickless_busy),
+#endif // #if KERNEL_TICKLESS && KERNEL_CONTEXT_SWITCH_CALLOUT
+    TEST_CASE_END
+} // namespace Mark3
@@ -29,13 +29,13 @@ namespace
 using namespace Mark3;
 //---------------------------------------------------------------------------
 // Global objects
-ProfileTimer clProfiler100m; //!< Profiling timer
-ProfileTimer clProfiler10m;  //!< Profiling timer
-ProfileTimer clProfiler1m;   //!< Profiling timer
-ProfileTimer clProfiler1;
-ProfileTimer clProfiler2;
-ProfileTimer clProfiler3;
-MessageQueue clMsgQ; //!< Message Queue for timers
+TickStopwatch clProfiler100m; //!< Profiling timer
+TickStopwatch clProfiler10m;  //!< Profiling timer
+TickStopwatch clProfiler1m;   //!< Profiling timer
+TickStopwatch clProfiler1;
+TickStopwatch clProfiler2;
+TickStopwatch clProfiler3;
+MessageQueue  clMsgQ; //!< Message Queue for timers
 
 #define MESSAGE_POOL_SIZE (3)
 MessagePool s_clMessagePool;
@@ -247,9 +247,41 @@ TEST(ut_timer_sanity_precision)
     EXPECT_TRUE(bPass);
 }
 
+//---------------------------------------------------------------------------
+TEST(ut_timer_sanity_clock)
+{
+    // The high-resolution clock must never run backwards, and must stay
+    // within the tick it was read in, over a run of ticks.
+    auto bPass    = true;
+    auto u64Last  = Kernel::GetClock();
+    auto u32Start = Kernel::GetTicks();
+    while ((Kernel::GetTicks() - u32Start) < 100) {
+        auto u64Before = Kernel::GetTicks64();
+        auto u64Clock  = Kernel::GetClock();
+        auto u64After  = Kernel::GetTicks64();
+        if ((u64Clock < u64Last) || ((u64Clock / PORT_TIMER_FREQ) < u64Before)
+            || ((u64Clock / PORT_TIMER_FREQ) > (u64After + 1))) {
+            bPass = false;
+            break;
+        }
+        u64Last = u64Clock;
+    }
+    EXPECT_TRUE(bPass);
+
+    // The 32-bit tick count is the low half of the 64-bit one
+    auto u64Ticks = uint64_t {};
+    auto u32Ticks = uint32_t {};
+    {
+        const auto cs = CriticalGuard {};
+        u64Ticks      = Kernel::GetTicks64();
+        u32Ticks      = Kernel::GetTicks();
+    }
+    EXPECT_EQUALS(static_cast<uint32_t>(u64Ticks), u32Ticks);
+}
+
 //===========================================================================
 // Test Whitelist Goes Here
 //===========================================================================
 TEST_CASE_START
-TEST_CASE(ut_timer_sanity_precision), TEST_CASE(ut_timer_sanity_multi), TEST_CASE_END
+TEST_CASE(ut_timer_sanity_precision), TEST_CASE(ut_timer_sanity_multi), TEST_CASE(ut_timer_sanity_clock), TEST_CASE_END
 } // namespace Mark3
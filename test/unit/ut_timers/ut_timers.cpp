@@ -36,9 +36,9 @@ Timer             clTimer1;
 Timer             clTimer2;
 Timer             clTimer3;
 Semaphore         clTimerSem;
-ProfileTimer      clProfileTimer;
-ProfileTimer      clProfileTimer2;
-ProfileTimer      clProfileTimer3;
+TickStopwatch     clStopwatch;
+TickStopwatch     clStopwatch2;
+TickStopwatch     clStopwatch3;
 uint32_t          u32TimeVal;
 uint32_t          u32TempTime;
 volatile uint32_t u32CallbackCount = 0;
@@ -48,6 +48,19 @@ void TimerExpired(Thread* pclOwner_, void* pvVal_)
     clTimerSem.Post();
     u32CallbackCount++;
 }
+
+// Intervals spanning several levels of the timer wheel, in start order
+constexpr uint32_t au32OrderIntervals[] = { 1100, 3, 260, 40, 17, 300, 70, 5 };
+constexpr auto     uOrderTimers         = sizeof(au32OrderIntervals) / sizeof(au32OrderIntervals[0]);
+Timer              aclOrderTimers[uOrderTimers];
+uint32_t           au32Expired[uOrderTimers];
+volatile uint8_t   u8ExpiredCount;
+
+void OrderTimerExpired(Thread* pclOwner_, void* pvVal_)
+{
+    au32Expired[u8ExpiredCount++] = au32OrderIntervals[reinterpret_cast<K_ADDR>(pvVal_)];
+    clTimerSem.Post();
+}
 } // anonymous namespace
 
 namespace Mark3
@@ -61,13 +74,13 @@ TEST(ut_timer_tolerance)
     clTimer1.Init();
 
     // Test point - 1ms timer should take at least 1ms
-    clProfileTimer.Init();
-    clProfileTimer.Start();
+    clStopwatch.Init();
+    clStopwatch.Start();
     clTimer1.Start(false, 1 + 1, TimerExpired, 0);
     clTimerSem.Pend();
-    clProfileTimer.Stop();
+    clStopwatch.Stop();
 
-    u32TimeVal  = clProfileTimer.GetCurrent();
+    u32TimeVal  = clStopwatch.GetCurrent();
     u32TempTime = 1;
     EXPECT_GTE(u32TimeVal, u32TempTime - 1);
 
@@ -76,13 +89,13 @@ TEST(ut_timer_tolerance)
     EXPECT_LTE(u32TimeVal, u32TempTime);
 
     // Test point - 10ms timer should take at least 10ms
-    clProfileTimer.Init();
-    clProfileTimer.Start();
+    clStopwatch.Init();
+    clStopwatch.Start();
     clTimer1.Start(false, 10 + 1, TimerExpired, 0);
     clTimerSem.Pend();
-    clProfileTimer.Stop();
+    clStopwatch.Stop();
 
-    u32TimeVal  = clProfileTimer.GetCurrent();
+    u32TimeVal  = clStopwatch.GetCurrent();
     u32TempTime = 10;
 
     EXPECT_GTE(u32TimeVal, u32TempTime - 1);
@@ -92,13 +105,13 @@ TEST(ut_timer_tolerance)
     EXPECT_LTE(u32TimeVal, u32TempTime);
 
     // Test point - 100ms timer should take at least 100ms
-    clProfileTimer.Init();
-    clProfileTimer.Start();
+    clStopwatch.Init();
+    clStopwatch.Start();
     clTimer1.Start(false, 100 + 1, TimerExpired, 0);
     clTimerSem.Pend();
-    clProfileTimer.Stop();
+    clStopwatch.Stop();
 
-    u32TimeVal  = clProfileTimer.GetCurrent();
+    u32TimeVal  = clStopwatch.GetCurrent();
     u32TempTime = 100;
 
     EXPECT_GTE(u32TimeVal, u32TempTime - 1);
@@ -108,13 +121,13 @@ TEST(ut_timer_tolerance)
     EXPECT_LTE(u32TimeVal, u32TempTime);
 
     // Test point - 500ms timer should take at least 500ms
-    clProfileTimer.Init();
-    clProfileTimer.Start();
+    clStopwatch.Init();
+    clStopwatch.Start();
     clTimer1.Start(false, 1000 + 1, TimerExpired, 0);
     clTimerSem.Pend();
-    clProfileTimer.Stop();
+    clStopwatch.Stop();
 
-    u32TimeVal  = clProfileTimer.GetCurrent();
+    u32TimeVal  = clStopwatch.GetCurrent();
     u32TempTime = 1000;
 
     EXPECT_GTE(u32TimeVal, u32TempTime - 1);
@@ -137,20 +150,20 @@ TEST(ut_timer_longrun)
 
     // Test point - long running timer accuracy; 10-second timer
     // expires after 10 seconds.
-    clProfileTimer.Init();
+    clStopwatch.Init();
     clTimer1.Start(false, 10000 + 1, TimerExpired, 0);
     u32CallbackCount = 0;
 
     while (!u32CallbackCount) {
-        clProfileTimer.Start();
+        clStopwatch.Start();
         Thread::Sleep(100);
-        clProfileTimer.Stop();
+        clStopwatch.Stop();
         u32SleepCount++;
     }
 
-    clProfileTimer.Stop();
+    clStopwatch.Stop();
 
-    u32TimeVal  = clProfileTimer.GetAverage() * u32SleepCount;
+    u32TimeVal  = clStopwatch.GetAverage() * u32SleepCount;
     u32TempTime = 10000;
 
     EXPECT_GTE(u32TimeVal, u32TempTime - 1);
@@ -172,17 +185,17 @@ TEST(ut_timer_repeat)
     // accuracy.  Average iteration must be > 10ms
     u32CallbackCount = 0;
 
-    clProfileTimer.Init();
-    clProfileTimer.Start();
+    clStopwatch.Init();
+    clStopwatch.Start();
 
     clTimer1.Start(true, 10, TimerExpired, 0);
 
     while (u32CallbackCount < 100) { clTimerSem.Pend(); }
 
-    clProfileTimer.Stop();
+    clStopwatch.Stop();
     clTimer1.Stop();
 
-    u32TimeVal  = clProfileTimer.GetCurrent();
+    u32TimeVal  = clStopwatch.GetCurrent();
     u32TempTime = 1000;
 
     EXPECT_GTE(u32TimeVal, u32TempTime - 1);
@@ -200,33 +213,33 @@ TEST(ut_timer_multi)
     // each of them expire at the expected times within a specific
     // tolerance
 
-    clProfileTimer.Init();
-    clProfileTimer2.Init();
-    clProfileTimer3.Init();
+    clStopwatch.Init();
+    clStopwatch2.Init();
+    clStopwatch3.Init();
 
     clTimer1.Init();
     clTimer2.Init();
     clTimer3.Init();
 
-    clProfileTimer.Start();
+    clStopwatch.Start();
     clTimer1.Start(false, 100, TimerExpired, 0);
-    clProfileTimer2.Start();
+    clStopwatch2.Start();
     clTimer2.Start(false, 200, TimerExpired, 0);
-    clProfileTimer3.Start();
+    clStopwatch3.Start();
     clTimer3.Start(false, 50, TimerExpired, 0);
 
     // Each timer expiry will post the semaphore.
     clTimerSem.Pend();
-    clProfileTimer3.Stop();
+    clStopwatch3.Stop();
 
     clTimerSem.Pend();
-    clProfileTimer.Stop();
+    clStopwatch.Stop();
 
     clTimerSem.Pend();
-    clProfileTimer2.Stop();
+    clStopwatch2.Stop();
 
     // Test Point - Timer 1 expired @ 100ms, with a 1 ms tolerance
-    u32TimeVal  = clProfileTimer.GetCurrent();
+    u32TimeVal  = clStopwatch.GetCurrent();
     u32TempTime = 100;
     EXPECT_GTE(u32TimeVal, u32TempTime - 1);
 
@@ -234,7 +247,7 @@ TEST(ut_timer_multi)
     EXPECT_LTE(u32TimeVal, u32TempTime);
 
     // Test Point - Timer 2 expired @ 200ms, with a 1 ms tolerance
-    u32TimeVal  = clProfileTimer2.GetCurrent();
+    u32TimeVal  = clStopwatch2.GetCurrent();
     u32TempTime = 200;
     EXPECT_GTE(u32TimeVal, u32TempTime - 1);
 
@@ -242,7 +255,7 @@ TEST(ut_timer_multi)
     EXPECT_LTE(u32TimeVal, u32TempTime);
 
     // Test Point - Timer 3 expired @ 50ms, with a 1 ms tolerance
-    u32TimeVal  = clProfileTimer3.GetCurrent();
+    u32TimeVal  = clStopwatch3.GetCurrent();
     u32TempTime = 50;
     EXPECT_GTE(u32TimeVal, u32TempTime - 1);
 
@@ -250,10 +263,29 @@ TEST(ut_timer_multi)
     EXPECT_LTE(u32TimeVal, u32TempTime);
 }
 
+TEST(ut_timer_order)
+{
+    // Start a set of one-shot timers with a mix of short and long intervals,
+    // and verify that they expire in order of their intervals.
+    clTimerSem.Init(0, uOrderTimers);
+    u8ExpiredCount = 0;
+
+    for (auto i = K_ADDR { 0 }; i < uOrderTimers; i++) {
+        aclOrderTimers[i].Init();
+        aclOrderTimers[i].Start(false, au32OrderIntervals[i], OrderTimerExpired, reinterpret_cast<void*>(i));
+    }
+
+    for (auto i = K_ADDR { 0 }; i < uOrderTimers; i++) { clTimerSem.Pend(); }
+
+    EXPECT_EQUALS(u8ExpiredCount, uOrderTimers);
+    for (auto i = K_ADDR { 1 }; i < uOrderTimers; i++) { EXPECT_LT(au32Expired[i - 1], au32Expired[i]); }
+}
+
 //===========================================================================
 // Test Whitelist Goes Here
 //===========================================================================
 TEST_CASE_START
 TEST_CASE(ut_timer_tolerance)
-, TEST_CASE(ut_timer_longrun), TEST_CASE(ut_timer_repeat), TEST_CASE(ut_timer_multi), TEST_CASE_END
+, TEST_CASE(ut_timer_longrun), TEST_CASE(ut_timer_repeat), TEST_CASE(ut_timer_multi),
+    TEST_CASE(ut_timer_order), TEST_CASE_END
 } // namespace Mark3
@@ -0,0 +1,387 @@
+/*===========================================================================
+     _____        _____        _____        _____
+ ___|    _|__  __|_    |__  __|__   |__  __| __  |__  ______
+|    \  /  | ||    \      ||     |     ||  |/ /     ||___   |
+|     \/   | ||     \     ||     \     ||     \     ||___   |
+|__/\__/|__|_||__|\__\  __||__|\__\  __||__|\__\  __||______|
+    |_____|      |_____|      |_____|      |_____|
+
+--[Mark3 Realtime Platform]--------------------------------------------------
+
+Copyright (c) 2012 - 2019 m0slevin, all rights reserved.
+See license.txt for more information
+=========================================================================== */
+/**
+
+    @file   trace2json.cpp
+
+    @brief  Convert a KernelTrace dump to Chrome trace-event JSON
+
+    Usage: trace2json <dump.bin> [<out.json>] [--freq <Hz>]
+
+    The output can be opened in Perfetto (ui.perfetto.dev) or chrome://tracing.
+    Each core is shown as a process, with a track per thread showing when it
+    was running, and instant events for everything else that happened to it.
+    Interrupts are shown on a separate "interrupts" track per core.
+
+    Dumps from targets of either byte order are accepted.  --freq overrides
+    the timestamp frequency recorded in the dump (e.g. for the host port,
+    whose cycle counter doesn't run at PORT_SYSTEM_FREQ).
+
+    This is a host tool, built separately from the kernel:
+
+    cmake -S tools/trace2json -B build/trace2json && cmake --build build/trace2json
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+//---------------------------------------------------------------------------
+// Dump format - must match kerneltrace.h
+struct TraceRecord {
+    uint32_t u32Timestamp;
+    uint32_t u32Thread;
+    uint32_t u32Object;
+    uint8_t  u8Event;
+    uint8_t  u8Core;
+    uint16_t u16Arg;
+};
+
+struct TraceHeader {
+    uint32_t u32Magic;
+    uint16_t u16Version;
+    uint16_t u16RecordSize;
+    uint32_t u32CyclesPerSecond;
+    uint32_t u32Records;
+    uint32_t u32Lost;
+};
+
+constexpr auto uMagic           = uint32_t { 0x5254334D };
+constexpr auto uVersion         = uint16_t { 1 };
+constexpr auto uTraceVectorTick = uint16_t { 0xFFFF };
+
+enum TraceEvent : uint8_t {
+    ContextSwitch = 0,
+    ThreadStart,
+    ThreadExit,
+    ThreadReady,
+    ThreadBlock,
+    ThreadUnblock,
+    TimerExpiry,
+    SemaphorePost,
+    SemaphorePend,
+    MutexClaim,
+    MutexRelease,
+    MailboxSend,
+    MailboxReceive,
+    IsrEnter,
+    IsrExit,
+    //---
+    Count
+};
+
+const char* const aszEventNames[] = {
+    "context_switch", "thread_start", "thread_exit",  "ready",     "block",    "unblock",       "timer_expiry", "sem_post",
+    "sem_pend",       "mutex_claim",  "mutex_release", "mailbox_send", "mailbox_recv", "isr_enter", "isr_exit",
+};
+
+//---------------------------------------------------------------------------
+uint16_t Swap16(uint16_t u16Val_)
+{
+    return static_cast<uint16_t>((u16Val_ >> 8) | (u16Val_ << 8));
+}
+
+//---------------------------------------------------------------------------
+uint32_t Swap32(uint32_t u32Val_)
+{
+    return ((u32Val_ >> 24) & 0x000000FF) | ((u32Val_ >> 8) & 0x0000FF00) | ((u32Val_ << 8) & 0x00FF0000)
+           | ((u32Val_ << 24) & 0xFF000000);
+}
+
+//---------------------------------------------------------------------------
+/**
+ * Chrome trace-event JSON writer
+ */
+class TraceWriter
+{
+public:
+    TraceWriter(FILE* pstFile_, uint32_t u32Freq_) : m_pstFile(pstFile_), m_u32Freq(u32Freq_), m_bFirst(true)
+    {
+        fprintf(m_pstFile, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    }
+
+    void Finish(uint32_t u32Lost_)
+    {
+        fprintf(m_pstFile, "\n], \"otherData\": {\"lost_records\": %u, \"cycles_per_second\": %u}}\n", u32Lost_, m_u32Freq);
+    }
+
+    // Duration begin/end ("B"/"E") event
+    void Duration(char cPhase_, const char* szName_, uint8_t u8Core_, uint32_t u32Tid_, uint64_t u64Cycles_)
+    {
+        Begin();
+        fprintf(m_pstFile,
+                "{\"name\": \"%s\", \"ph\": \"%c\", \"pid\": %u, \"tid\": %u, \"ts\": %.3f}",
+                szName_,
+                cPhase_,
+                u8Core_,
+                u32Tid_,
+                Micros(u64Cycles_));
+    }
+
+    // Thread-scoped instant event, with the object address and argument
+    void Instant(const char* szName_, uint8_t u8Core_, uint32_t u32Tid_, uint64_t u64Cycles_, uint32_t u32Object_, uint16_t u16Arg_)
+    {
+        Begin();
+        fprintf(m_pstFile,
+                "{\"name\": \"%s\", \"ph\": \"i\", \"s\": \"t\", \"pid\": %u, \"tid\": %u, \"ts\": %.3f, "
+                "\"args\": {\"object\": \"0x%08x\", \"arg\": %u}}",
+                szName_,
+                u8Core_,
+                u32Tid_,
+                Micros(u64Cycles_),
+                u32Object_,
+                u16Arg_);
+    }
+
+    // Process/thread naming metadata
+    void Name(const char* szKind_, uint8_t u8Core_, uint32_t u32Tid_, const std::string& strName_)
+    {
+        Begin();
+        fprintf(m_pstFile,
+                "{\"name\": \"%s\", \"ph\": \"M\", \"pid\": %u, \"tid\": %u, \"args\": {\"name\": \"%s\"}}",
+                szKind_,
+                u8Core_,
+                u32Tid_,
+                strName_.c_str());
+    }
+
+private:
+    void Begin()
+    {
+        if (!m_bFirst) {
+            fprintf(m_pstFile, ",\n");
+        }
+        m_bFirst = false;
+    }
+
+    double Micros(uint64_t u64Cycles_) { return (static_cast<double>(u64Cycles_) * 1000000.0) / m_u32Freq; }
+
+    FILE*    m_pstFile;
+    uint32_t m_u32Freq;
+    bool     m_bFirst;
+};
+
+//---------------------------------------------------------------------------
+// Per-core decoder state
+struct CoreState {
+    uint32_t u32Running;  //!< Thread currently shown as running
+    bool     bRunning;    //!< Whether a "running" slice is open
+    uint32_t u32IsrDepth; //!< Number of open interrupt slices
+};
+
+using ThreadKey = std::pair<uint8_t, uint32_t>; //!< Core and thread address
+
+//---------------------------------------------------------------------------
+void DefaultName(std::map<ThreadKey, std::string>& mapNames_, uint8_t u8Core_, uint32_t u32Tid_)
+{
+    if ((0 != u32Tid_) && (0 == mapNames_.count({ u8Core_, u32Tid_ }))) {
+        char szName[24];
+        snprintf(szName, sizeof(szName), "thread 0x%08x", u32Tid_);
+        mapNames_[{ u8Core_, u32Tid_ }] = szName;
+    }
+}
+
+//---------------------------------------------------------------------------
+std::string IsrName(uint16_t u16Vector_)
+{
+    if (uTraceVectorTick == u16Vector_) {
+        return "tick";
+    }
+    return "irq " + std::to_string(u16Vector_);
+}
+
+//---------------------------------------------------------------------------
+void Usage()
+{
+    fprintf(stderr, "usage: trace2json <dump.bin> [<out.json>] [--freq <Hz>]\n");
+}
+} // anonymous namespace
+
+//---------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    const char* szIn    = nullptr;
+    const char* szOut   = nullptr;
+    auto        u32Freq = uint32_t { 0 };
+
+    for (int i = 1; i < argc; i++) {
+        if ((0 == strcmp(argv[i], "--freq")) && ((i + 1) < argc)) {
+            u32Freq = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        } else if (nullptr == szIn) {
+            szIn = argv[i];
+        } else if (nullptr == szOut) {
+            szOut = argv[i];
+        } else {
+            Usage();
+            return 1;
+        }
+    }
+    if (nullptr == szIn) {
+        Usage();
+        return 1;
+    }
+
+    auto* pstIn = fopen(szIn, "rb");
+    if (nullptr == pstIn) {
+        fprintf(stderr, "trace2json: can't open %s\n", szIn);
+        return 1;
+    }
+
+    auto stHeader = TraceHeader {};
+    if (1 != fread(&stHeader, sizeof(stHeader), 1, pstIn)) {
+        fprintf(stderr, "trace2json: %s is too short\n", szIn);
+        return 1;
+    }
+    auto bSwap = (Swap32(uMagic) == stHeader.u32Magic);
+    if (bSwap) {
+        stHeader.u16Version         = Swap16(stHeader.u16Version);
+        stHeader.u16RecordSize      = Swap16(stHeader.u16RecordSize);
+        stHeader.u32CyclesPerSecond = Swap32(stHeader.u32CyclesPerSecond);
+        stHeader.u32Records         = Swap32(stHeader.u32Records);
+        stHeader.u32Lost            = Swap32(stHeader.u32Lost);
+    } else if (uMagic != stHeader.u32Magic) {
+        fprintf(stderr, "trace2json: %s is not a kernel trace dump\n", szIn);
+        return 1;
+    }
+    if ((uVersion != stHeader.u16Version) || (sizeof(TraceRecord) != stHeader.u16RecordSize)) {
+        fprintf(stderr,
+                "trace2json: unsupported dump version %u (record size %u)\n",
+                stHeader.u16Version,
+                stHeader.u16RecordSize);
+        return 1;
+    }
+    if (0 == u32Freq) {
+        u32Freq = stHeader.u32CyclesPerSecond;
+    }
+
+    auto vRecords = std::vector<TraceRecord>(stHeader.u32Records);
+    if (vRecords.size() != fread(vRecords.data(), sizeof(TraceRecord), vRecords.size(), pstIn)) {
+        fprintf(stderr, "trace2json: %s is truncated\n", szIn);
+        return 1;
+    }
+    fclose(pstIn);
+
+    auto* pstOut = (nullptr != szOut) ? fopen(szOut, "w") : stdout;
+    if (nullptr == pstOut) {
+        fprintf(stderr, "trace2json: can't create %s\n", szOut);
+        return 1;
+    }
+
+    auto clWriter = TraceWriter { pstOut, u32Freq };
+    auto mapNames = std::map<ThreadKey, std::string> {};
+    auto mapCores = std::map<uint8_t, CoreState> {};
+    auto u64Now   = uint64_t { 0 };
+    auto u32Last  = uint32_t { 0 };
+
+    for (size_t i = 0; i < vRecords.size(); i++) {
+        auto& stRecord = vRecords[i];
+        if (bSwap) {
+            stRecord.u32Timestamp = Swap32(stRecord.u32Timestamp);
+            stRecord.u32Thread    = Swap32(stRecord.u32Thread);
+            stRecord.u32Object    = Swap32(stRecord.u32Object);
+            stRecord.u16Arg       = Swap16(stRecord.u16Arg);
+        }
+
+        // Timestamps are 32-bit and wrap - extend them by accumulating deltas
+        if (0 != i) {
+            u64Now += static_cast<uint32_t>(stRecord.u32Timestamp - u32Last);
+        }
+        u32Last = stRecord.u32Timestamp;
+
+        auto  u8Core = stRecord.u8Core;
+        auto& stCore = mapCores[u8Core];
+        auto  u32Tid = stRecord.u32Thread;
+
+        // Threads without a start record are named after their address
+        DefaultName(mapNames, u8Core, u32Tid);
+
+        switch (stRecord.u8Event) {
+            case ContextSwitch: {
+                if (stCore.bRunning) {
+                    clWriter.Duration('E', "running", u8Core, stCore.u32Running, u64Now);
+                } else if (0 != u32Tid) {
+                    // The outgoing thread has been running since the start of the trace
+                    clWriter.Duration('B', "running", u8Core, u32Tid, 0);
+                    clWriter.Duration('E', "running", u8Core, u32Tid, u64Now);
+                }
+                stCore.u32Running = stRecord.u32Object;
+                stCore.bRunning   = true;
+                clWriter.Duration('B', "running", u8Core, stCore.u32Running, u64Now);
+                DefaultName(mapNames, u8Core, stCore.u32Running);
+            } break;
+            case ThreadStart: {
+                char szName[40];
+                snprintf(szName,
+                         sizeof(szName),
+                         "thread %u (prio %u) 0x%08x",
+                         stRecord.u16Arg >> 8,
+                         stRecord.u16Arg & 0xFF,
+                         u32Tid);
+                mapNames[{ u8Core, u32Tid }] = szName;
+                clWriter.Instant(aszEventNames[stRecord.u8Event], u8Core, u32Tid, u64Now, stRecord.u32Object, stRecord.u16Arg);
+            } break;
+            case IsrEnter: {
+                clWriter.Duration('B', IsrName(stRecord.u16Arg).c_str(), u8Core, 0, u64Now);
+                stCore.u32IsrDepth++;
+            } break;
+            case IsrExit: {
+                // Ignore exits from interrupts entered before the trace started
+                if (0 != stCore.u32IsrDepth) {
+                    stCore.u32IsrDepth--;
+                    clWriter.Duration('E', IsrName(stRecord.u16Arg).c_str(), u8Core, 0, u64Now);
+                }
+            } break;
+            default: {
+                if (stRecord.u8Event < Count) {
+                    clWriter.Instant(aszEventNames[stRecord.u8Event], u8Core, u32Tid, u64Now, stRecord.u32Object, stRecord.u16Arg);
+                } else {
+                    fprintf(stderr, "trace2json: skipping unknown event %u\n", stRecord.u8Event);
+                }
+            } break;
+        }
+    }
+
+    // Close any slices still open at the end of the trace
+    for (auto& clCore : mapCores) {
+        if (clCore.second.bRunning) {
+            clWriter.Duration('E', "running", clCore.first, clCore.second.u32Running, u64Now);
+        }
+        for (; 0 != clCore.second.u32IsrDepth; clCore.second.u32IsrDepth--) {
+            clWriter.Duration('E', "interrupt", clCore.first, 0, u64Now);
+        }
+        clWriter.Name("process_name", clCore.first, 0, "core " + std::to_string(clCore.first));
+        clWriter.Name("thread_name", clCore.first, 0, "interrupts");
+    }
+    for (auto& clName : mapNames) {
+        clWriter.Name("thread_name", clName.first.first, clName.first.second, clName.second);
+    }
+    clWriter.Finish(stHeader.u32Lost);
+
+    if (stdout != pstOut) {
+        fclose(pstOut);
+    }
+    fprintf(stderr,
+            "trace2json: %u records, %u lost, %.3f ms\n",
+            stHeader.u32Records,
+            stHeader.u32Lost,
+            (static_cast<double>(u64Now) * 1000.0) / u32Freq);
+    return 0;
+}